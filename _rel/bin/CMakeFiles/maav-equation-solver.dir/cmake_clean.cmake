@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/maav-equation-solver.dir/maav-equation-solver.cpp.o"
+  "CMakeFiles/maav-equation-solver.dir/maav-equation-solver.cpp.o.d"
+  "maav-equation-solver"
+  "maav-equation-solver.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/maav-equation-solver.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
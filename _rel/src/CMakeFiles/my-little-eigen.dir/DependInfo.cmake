@@ -0,0 +1,37 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/Array2D.cpp" "src/CMakeFiles/my-little-eigen.dir/Array2D.cpp.o" "gcc" "src/CMakeFiles/my-little-eigen.dir/Array2D.cpp.o.d"
+  "/root/repo/src/Backend.cpp" "src/CMakeFiles/my-little-eigen.dir/Backend.cpp.o" "gcc" "src/CMakeFiles/my-little-eigen.dir/Backend.cpp.o.d"
+  "/root/repo/src/BandMatrix.cpp" "src/CMakeFiles/my-little-eigen.dir/BandMatrix.cpp.o" "gcc" "src/CMakeFiles/my-little-eigen.dir/BandMatrix.cpp.o.d"
+  "/root/repo/src/Decompositions.cpp" "src/CMakeFiles/my-little-eigen.dir/Decompositions.cpp.o" "gcc" "src/CMakeFiles/my-little-eigen.dir/Decompositions.cpp.o.d"
+  "/root/repo/src/Filtering.cpp" "src/CMakeFiles/my-little-eigen.dir/Filtering.cpp.o" "gcc" "src/CMakeFiles/my-little-eigen.dir/Filtering.cpp.o.d"
+  "/root/repo/src/Kernels.cpp" "src/CMakeFiles/my-little-eigen.dir/Kernels.cpp.o" "gcc" "src/CMakeFiles/my-little-eigen.dir/Kernels.cpp.o.d"
+  "/root/repo/src/KernelsAvx2.cpp" "src/CMakeFiles/my-little-eigen.dir/KernelsAvx2.cpp.o" "gcc" "src/CMakeFiles/my-little-eigen.dir/KernelsAvx2.cpp.o.d"
+  "/root/repo/src/KernelsAvx512.cpp" "src/CMakeFiles/my-little-eigen.dir/KernelsAvx512.cpp.o" "gcc" "src/CMakeFiles/my-little-eigen.dir/KernelsAvx512.cpp.o.d"
+  "/root/repo/src/KernelsSse2.cpp" "src/CMakeFiles/my-little-eigen.dir/KernelsSse2.cpp.o" "gcc" "src/CMakeFiles/my-little-eigen.dir/KernelsSse2.cpp.o.d"
+  "/root/repo/src/Matrix.cpp" "src/CMakeFiles/my-little-eigen.dir/Matrix.cpp.o" "gcc" "src/CMakeFiles/my-little-eigen.dir/Matrix.cpp.o.d"
+  "/root/repo/src/MatrixFunctions.cpp" "src/CMakeFiles/my-little-eigen.dir/MatrixFunctions.cpp.o" "gcc" "src/CMakeFiles/my-little-eigen.dir/MatrixFunctions.cpp.o.d"
+  "/root/repo/src/PackedMatrix.cpp" "src/CMakeFiles/my-little-eigen.dir/PackedMatrix.cpp.o" "gcc" "src/CMakeFiles/my-little-eigen.dir/PackedMatrix.cpp.o.d"
+  "/root/repo/src/Parallel.cpp" "src/CMakeFiles/my-little-eigen.dir/Parallel.cpp.o" "gcc" "src/CMakeFiles/my-little-eigen.dir/Parallel.cpp.o.d"
+  "/root/repo/src/QR.cpp" "src/CMakeFiles/my-little-eigen.dir/QR.cpp.o" "gcc" "src/CMakeFiles/my-little-eigen.dir/QR.cpp.o.d"
+  "/root/repo/src/Reductions.cpp" "src/CMakeFiles/my-little-eigen.dir/Reductions.cpp.o" "gcc" "src/CMakeFiles/my-little-eigen.dir/Reductions.cpp.o.d"
+  "/root/repo/src/SharedMemory.cpp" "src/CMakeFiles/my-little-eigen.dir/SharedMemory.cpp.o" "gcc" "src/CMakeFiles/my-little-eigen.dir/SharedMemory.cpp.o.d"
+  "/root/repo/src/Symmetric.cpp" "src/CMakeFiles/my-little-eigen.dir/Symmetric.cpp.o" "gcc" "src/CMakeFiles/my-little-eigen.dir/Symmetric.cpp.o.d"
+  "/root/repo/src/Updates.cpp" "src/CMakeFiles/my-little-eigen.dir/Updates.cpp.o" "gcc" "src/CMakeFiles/my-little-eigen.dir/Updates.cpp.o.d"
+  "/root/repo/src/Vector.cpp" "src/CMakeFiles/my-little-eigen.dir/Vector.cpp.o" "gcc" "src/CMakeFiles/my-little-eigen.dir/Vector.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
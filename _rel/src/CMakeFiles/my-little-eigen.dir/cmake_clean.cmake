@@ -0,0 +1,47 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/my-little-eigen.dir/Array2D.cpp.o"
+  "CMakeFiles/my-little-eigen.dir/Array2D.cpp.o.d"
+  "CMakeFiles/my-little-eigen.dir/Backend.cpp.o"
+  "CMakeFiles/my-little-eigen.dir/Backend.cpp.o.d"
+  "CMakeFiles/my-little-eigen.dir/BandMatrix.cpp.o"
+  "CMakeFiles/my-little-eigen.dir/BandMatrix.cpp.o.d"
+  "CMakeFiles/my-little-eigen.dir/Decompositions.cpp.o"
+  "CMakeFiles/my-little-eigen.dir/Decompositions.cpp.o.d"
+  "CMakeFiles/my-little-eigen.dir/Filtering.cpp.o"
+  "CMakeFiles/my-little-eigen.dir/Filtering.cpp.o.d"
+  "CMakeFiles/my-little-eigen.dir/Kernels.cpp.o"
+  "CMakeFiles/my-little-eigen.dir/Kernels.cpp.o.d"
+  "CMakeFiles/my-little-eigen.dir/KernelsAvx2.cpp.o"
+  "CMakeFiles/my-little-eigen.dir/KernelsAvx2.cpp.o.d"
+  "CMakeFiles/my-little-eigen.dir/KernelsAvx512.cpp.o"
+  "CMakeFiles/my-little-eigen.dir/KernelsAvx512.cpp.o.d"
+  "CMakeFiles/my-little-eigen.dir/KernelsSse2.cpp.o"
+  "CMakeFiles/my-little-eigen.dir/KernelsSse2.cpp.o.d"
+  "CMakeFiles/my-little-eigen.dir/Matrix.cpp.o"
+  "CMakeFiles/my-little-eigen.dir/Matrix.cpp.o.d"
+  "CMakeFiles/my-little-eigen.dir/MatrixFunctions.cpp.o"
+  "CMakeFiles/my-little-eigen.dir/MatrixFunctions.cpp.o.d"
+  "CMakeFiles/my-little-eigen.dir/PackedMatrix.cpp.o"
+  "CMakeFiles/my-little-eigen.dir/PackedMatrix.cpp.o.d"
+  "CMakeFiles/my-little-eigen.dir/Parallel.cpp.o"
+  "CMakeFiles/my-little-eigen.dir/Parallel.cpp.o.d"
+  "CMakeFiles/my-little-eigen.dir/QR.cpp.o"
+  "CMakeFiles/my-little-eigen.dir/QR.cpp.o.d"
+  "CMakeFiles/my-little-eigen.dir/Reductions.cpp.o"
+  "CMakeFiles/my-little-eigen.dir/Reductions.cpp.o.d"
+  "CMakeFiles/my-little-eigen.dir/SharedMemory.cpp.o"
+  "CMakeFiles/my-little-eigen.dir/SharedMemory.cpp.o.d"
+  "CMakeFiles/my-little-eigen.dir/Symmetric.cpp.o"
+  "CMakeFiles/my-little-eigen.dir/Symmetric.cpp.o.d"
+  "CMakeFiles/my-little-eigen.dir/Updates.cpp.o"
+  "CMakeFiles/my-little-eigen.dir/Updates.cpp.o.d"
+  "CMakeFiles/my-little-eigen.dir/Vector.cpp.o"
+  "CMakeFiles/my-little-eigen.dir/Vector.cpp.o.d"
+  "libmy-little-eigen.pdb"
+  "libmy-little-eigen.so"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/my-little-eigen.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
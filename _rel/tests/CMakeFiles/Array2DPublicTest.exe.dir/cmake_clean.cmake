@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "Array2DPublicTest.exe"
+  "Array2DPublicTest.exe.pdb"
+  "CMakeFiles/Array2DPublicTest.exe.dir/Array2DPublicTest.cpp.o"
+  "CMakeFiles/Array2DPublicTest.exe.dir/Array2DPublicTest.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/Array2DPublicTest.exe.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "BackendPublicTest.exe"
+  "BackendPublicTest.exe.pdb"
+  "CMakeFiles/BackendPublicTest.exe.dir/BackendPublicTest.cpp.o"
+  "CMakeFiles/BackendPublicTest.exe.dir/BackendPublicTest.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/BackendPublicTest.exe.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "BandMatrixPublicTest.exe"
+  "BandMatrixPublicTest.exe.pdb"
+  "CMakeFiles/BandMatrixPublicTest.exe.dir/BandMatrixPublicTest.cpp.o"
+  "CMakeFiles/BandMatrixPublicTest.exe.dir/BandMatrixPublicTest.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/BandMatrixPublicTest.exe.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
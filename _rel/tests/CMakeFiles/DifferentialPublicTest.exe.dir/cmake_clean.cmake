@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/DifferentialPublicTest.exe.dir/DifferentialPublicTest.cpp.o"
+  "CMakeFiles/DifferentialPublicTest.exe.dir/DifferentialPublicTest.cpp.o.d"
+  "DifferentialPublicTest.exe"
+  "DifferentialPublicTest.exe.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/DifferentialPublicTest.exe.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/FilteringPublicTest.exe.dir/FilteringPublicTest.cpp.o"
+  "CMakeFiles/FilteringPublicTest.exe.dir/FilteringPublicTest.cpp.o.d"
+  "FilteringPublicTest.exe"
+  "FilteringPublicTest.exe.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/FilteringPublicTest.exe.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
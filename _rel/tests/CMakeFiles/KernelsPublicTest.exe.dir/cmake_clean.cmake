@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/KernelsPublicTest.exe.dir/KernelsPublicTest.cpp.o"
+  "CMakeFiles/KernelsPublicTest.exe.dir/KernelsPublicTest.cpp.o.d"
+  "KernelsPublicTest.exe"
+  "KernelsPublicTest.exe.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/KernelsPublicTest.exe.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/MatrixFunctionsPublicTest.exe.dir/MatrixFunctionsPublicTest.cpp.o"
+  "CMakeFiles/MatrixFunctionsPublicTest.exe.dir/MatrixFunctionsPublicTest.cpp.o.d"
+  "MatrixFunctionsPublicTest.exe"
+  "MatrixFunctionsPublicTest.exe.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/MatrixFunctionsPublicTest.exe.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
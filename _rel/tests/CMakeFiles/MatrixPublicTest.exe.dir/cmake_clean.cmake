@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/MatrixPublicTest.exe.dir/MatrixPublicTest.cpp.o"
+  "CMakeFiles/MatrixPublicTest.exe.dir/MatrixPublicTest.cpp.o.d"
+  "MatrixPublicTest.exe"
+  "MatrixPublicTest.exe.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/MatrixPublicTest.exe.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/PackedMatrixPublicTest.exe.dir/PackedMatrixPublicTest.cpp.o"
+  "CMakeFiles/PackedMatrixPublicTest.exe.dir/PackedMatrixPublicTest.cpp.o.d"
+  "PackedMatrixPublicTest.exe"
+  "PackedMatrixPublicTest.exe.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/PackedMatrixPublicTest.exe.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
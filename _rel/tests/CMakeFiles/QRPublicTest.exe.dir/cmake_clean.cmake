@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/QRPublicTest.exe.dir/QRPublicTest.cpp.o"
+  "CMakeFiles/QRPublicTest.exe.dir/QRPublicTest.cpp.o.d"
+  "QRPublicTest.exe"
+  "QRPublicTest.exe.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/QRPublicTest.exe.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
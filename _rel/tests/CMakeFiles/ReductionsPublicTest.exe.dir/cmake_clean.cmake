@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/ReductionsPublicTest.exe.dir/ReductionsPublicTest.cpp.o"
+  "CMakeFiles/ReductionsPublicTest.exe.dir/ReductionsPublicTest.cpp.o.d"
+  "ReductionsPublicTest.exe"
+  "ReductionsPublicTest.exe.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/ReductionsPublicTest.exe.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
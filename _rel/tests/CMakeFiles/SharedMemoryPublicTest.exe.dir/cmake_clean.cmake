@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/SharedMemoryPublicTest.exe.dir/SharedMemoryPublicTest.cpp.o"
+  "CMakeFiles/SharedMemoryPublicTest.exe.dir/SharedMemoryPublicTest.cpp.o.d"
+  "SharedMemoryPublicTest.exe"
+  "SharedMemoryPublicTest.exe.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/SharedMemoryPublicTest.exe.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
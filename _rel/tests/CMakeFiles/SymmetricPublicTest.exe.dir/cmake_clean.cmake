@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/SymmetricPublicTest.exe.dir/SymmetricPublicTest.cpp.o"
+  "CMakeFiles/SymmetricPublicTest.exe.dir/SymmetricPublicTest.cpp.o.d"
+  "SymmetricPublicTest.exe"
+  "SymmetricPublicTest.exe.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/SymmetricPublicTest.exe.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/UpdatesPublicTest.exe.dir/UpdatesPublicTest.cpp.o"
+  "CMakeFiles/UpdatesPublicTest.exe.dir/UpdatesPublicTest.cpp.o.d"
+  "UpdatesPublicTest.exe"
+  "UpdatesPublicTest.exe.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/UpdatesPublicTest.exe.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/VectorPublicTest.exe.dir/VectorPublicTest.cpp.o"
+  "CMakeFiles/VectorPublicTest.exe.dir/VectorPublicTest.cpp.o.d"
+  "VectorPublicTest.exe"
+  "VectorPublicTest.exe.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/VectorPublicTest.exe.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,36 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/tests
+# Build directory: /root/repo/_rel/tests
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(Array2DPublicTest "/root/repo/_rel/tests/Array2DPublicTest.exe")
+set_tests_properties(Array2DPublicTest PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;63;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BackendPublicTest "/root/repo/_rel/tests/BackendPublicTest.exe")
+set_tests_properties(BackendPublicTest PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;63;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BandMatrixPublicTest "/root/repo/_rel/tests/BandMatrixPublicTest.exe")
+set_tests_properties(BandMatrixPublicTest PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;63;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(DifferentialPublicTest "/root/repo/_rel/tests/DifferentialPublicTest.exe")
+set_tests_properties(DifferentialPublicTest PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;63;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(FilteringPublicTest "/root/repo/_rel/tests/FilteringPublicTest.exe")
+set_tests_properties(FilteringPublicTest PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;63;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(KernelsPublicTest "/root/repo/_rel/tests/KernelsPublicTest.exe")
+set_tests_properties(KernelsPublicTest PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;63;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(MatrixFunctionsPublicTest "/root/repo/_rel/tests/MatrixFunctionsPublicTest.exe")
+set_tests_properties(MatrixFunctionsPublicTest PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;63;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(MatrixPublicTest "/root/repo/_rel/tests/MatrixPublicTest.exe")
+set_tests_properties(MatrixPublicTest PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;63;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(PackedMatrixPublicTest "/root/repo/_rel/tests/PackedMatrixPublicTest.exe")
+set_tests_properties(PackedMatrixPublicTest PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;63;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(QRPublicTest "/root/repo/_rel/tests/QRPublicTest.exe")
+set_tests_properties(QRPublicTest PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;63;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(ReductionsPublicTest "/root/repo/_rel/tests/ReductionsPublicTest.exe")
+set_tests_properties(ReductionsPublicTest PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;63;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(SharedMemoryPublicTest "/root/repo/_rel/tests/SharedMemoryPublicTest.exe")
+set_tests_properties(SharedMemoryPublicTest PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;63;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(SymmetricPublicTest "/root/repo/_rel/tests/SymmetricPublicTest.exe")
+set_tests_properties(SymmetricPublicTest PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;63;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(UpdatesPublicTest "/root/repo/_rel/tests/UpdatesPublicTest.exe")
+set_tests_properties(UpdatesPublicTest PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;63;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(VectorPublicTest "/root/repo/_rel/tests/VectorPublicTest.exe")
+set_tests_properties(VectorPublicTest PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;63;add_test;/root/repo/tests/CMakeLists.txt;0;")
@@ -0,0 +1,379 @@
+#ifndef MAAV_PROJECT_3_SYSTEM_IO_HPP
+#define MAAV_PROJECT_3_SYSTEM_IO_HPP
+
+#include "src/Matrix.hpp"
+
+#include <cstdint>		// uint64_t
+#include <cstdio>		// std::snprintf
+#include <cstdlib>		// std::strtod, size_t
+#include <cstring>		// std::memmove
+#include <istream>		// std::istream
+#include <stdexcept>	// std::runtime_error
+#include <string>		// std::string, std::to_string
+#include <vector>		// std::vector
+
+/**
+ * @addtogroup SYSTEM_IO Linear System I/O
+ * @brief Reading and writing streams of `A * x = B` systems.
+ * @detail Both formats are a sequence of records, one per system.
+ *
+ * 		**Text.** Numbers are separated by any whitespace, and `#` starts a
+ * 		comment that runs to the end of the line. An input record is
+ * 				n m
+ * 				<n x n elements of A, row by row>
+ * 				<n x m elements of B, row by row>
+ *
+ * 		...and an output record is `n m` followed by the `n x m` solution,
+ * 		one row per line. A system that couldn't be solved is written as a
+ * 		single line, `! <index> <reason>`, where `index` counts from zero.
+ *
+ * 		**Binary.** Native-endian `uint64_t`s and `double`s. An input record
+ * 		is `n`, `m`, `A`, then `B`. An output record is `status`, `n`, `m`,
+ * 		then the solution; `status` is zero on success, and a failed system
+ * 		has a nonzero status and no elements.
+ * @{
+ */
+
+enum class Format
+{
+	Text,
+	Binary
+};
+
+/**
+ * @brief One system `A * x = B`. `B` may have any number of columns.
+ */
+struct LinearSystem
+{
+	Matrix a;
+	Matrix b;
+};
+
+/**
+ * @brief Reads systems from a stream, one at a time.
+ * @detail The input is read in large chunks, so this works just as well on
+ * 		pipes as on files. Throws an `std::runtime_error` on malformed input.
+ */
+class SystemReader
+{
+public:
+
+	SystemReader(std::istream& input, Format format)
+		: in(input), format{format}, buffer(buffer_size + 1)
+	{}
+
+	/**
+	 * @brief Read the next system into `out`.
+	 * @detail If `out` already holds row-major matrices of the right sizes
+	 * 		(say, from the previous call), their storage is reused.
+	 * @return False once the input is used up.
+	 */
+	bool next(LinearSystem& out)
+	{
+		const bool more = format == Format::Text ? nextText(out)
+												 : nextBinary(out);
+		if (more) ++count;
+		return more;
+	}
+
+	/**
+	 * @brief Return the number of systems read so far.
+	 */
+	size_t numRead() const { return count; }
+
+private:
+
+	static constexpr size_t buffer_size = 1 << 16;
+
+	/**
+	 * @brief Largest accepted number of elements in `A` and `B` together
+	 * 		(2 GiB of doubles), to catch garbage headers before they turn
+	 * 		into enormous allocations.
+	 */
+	static constexpr uint64_t max_elements = uint64_t{1} << 28;
+
+	void fail(const std::string& what) const
+	{
+		throw std::runtime_error{"Input system " + std::to_string(count)
+								 + ": " + what};
+	}
+
+	void checkDims(uint64_t n, uint64_t m) const
+	{
+		// Bounding each dimension first keeps the product from overflowing.
+		if (n == 0 or m == 0 or n > max_elements or m > max_elements
+			or n * (n + m) > max_elements)
+		{
+			fail("invalid dimensions " + std::to_string(n) + " x "
+				 + std::to_string(m));
+		}
+	}
+
+	bool nextBinary(LinearSystem& out)
+	{
+		uint64_t dims[2];
+		in.read(reinterpret_cast<char*>(dims), sizeof(dims));
+		if (in.gcount() == 0) return false;
+		if (in.gcount() != sizeof(dims)) fail("truncated header");
+		checkDims(dims[0], dims[1]);
+
+		const size_t n = dims[0];
+		const size_t m = dims[1];
+		reshape(out.a, n, n);
+		reshape(out.b, n, m);
+		readDoubles(out.a.data(), n * n);
+		readDoubles(out.b.data(), n * m);
+		return true;
+	}
+
+	/**
+	 * @brief Make `mat` a `rows x cols` row-major Matrix that nothing else
+	 * 		shares, keeping its storage if it already is one.
+	 * @detail The elements are left as they were; the caller overwrites all
+	 * 		of them.
+	 */
+	static void reshape(Matrix& mat, size_t rows, size_t cols)
+	{
+		mat.resize(rows, cols);
+		if (mat.isShared() or mat.layout() != Layout::RowMajor)
+		{
+			mat = Matrix{rows, cols};
+		}
+	}
+
+	void readDoubles(double* dest, size_t num)
+	{
+		const std::streamsize bytes = num * sizeof(double);
+		in.read(reinterpret_cast<char*>(dest), bytes);
+		if (in.gcount() != bytes) fail("truncated elements");
+	}
+
+	bool nextText(LinearSystem& out)
+	{
+		double header[2];
+		if (not nextNumber(header[0])) return false;
+		if (not nextNumber(header[1])) fail("truncated header");
+		for (double dim : header)
+		{
+			// Written so that NaNs fail, too.
+			if (not (dim >= 0 and dim <= max_elements)
+				or dim != static_cast<uint64_t>(dim))
+			{
+				fail("dimensions must be whole numbers");
+			}
+		}
+		const size_t n = header[0];
+		const size_t m = header[1];
+		checkDims(n, m);
+		reshape(out.a, n, n);
+		reshape(out.b, n, m);
+		readNumbers(out.a.data(), n * n);
+		readNumbers(out.b.data(), n * m);
+		return true;
+	}
+
+	void readNumbers(double* dest, size_t num)
+	{
+		for (size_t i = 0; i != num; ++i)
+		{
+			if (not nextNumber(dest[i])) fail("truncated elements");
+		}
+	}
+
+	/**
+	 * @brief Move the unread part of the buffer to the front and top it up.
+	 */
+	void refill()
+	{
+		std::memmove(buffer.data(), buffer.data() + pos, end - pos);
+		end -= pos;
+		pos = 0;
+		if (at_eof) return;
+
+		in.read(buffer.data() + end, buffer_size - end);
+		end += in.gcount();
+		at_eof = in.gcount() == 0 or in.eof();
+	}
+
+	/**
+	 * @brief Parse the next number, skipping whitespace and comments.
+	 * @return False at the end of the input.
+	 */
+	bool nextNumber(double& value)
+	{
+		// Skip to the start of the next token.
+		for (;;)
+		{
+			if (pos == end)
+			{
+				refill();
+				if (pos == end) return false;
+			}
+			const char c = buffer[pos];
+			if (c == '#')
+			{
+				while (pos != end or not at_eof)
+				{
+					if (pos == end)
+					{
+						refill();
+						continue;
+					}
+					if (buffer[pos++] == '\n') break;
+				}
+			}
+			else if (c == ' ' or c == '\n' or c == '\t' or c == '\r')
+			{
+				++pos;
+			}
+			else
+			{
+				break;
+			}
+		}
+
+		// Make sure the whole token is in the buffer.
+		size_t token_end = pos;
+		for (;;)
+		{
+			while (token_end != end and not isDelimiter(buffer[token_end]))
+			{
+				++token_end;
+			}
+			if (token_end != end or at_eof) break;
+			if (pos == 0 and end == buffer_size) fail("token too long");
+			token_end -= pos;
+			refill();
+		}
+
+		// `buffer` has one spare byte past `buffer_size` for this.
+		const char saved = buffer[token_end];
+		buffer[token_end] = '\0';
+		char* parsed_end = nullptr;
+		value = std::strtod(buffer.data() + pos, &parsed_end);
+		buffer[token_end] = saved;
+		if (parsed_end != buffer.data() + token_end)
+		{
+			fail("invalid number '"
+				 + std::string{buffer.data() + pos, token_end - pos} + "'");
+		}
+
+		pos = token_end;
+		return true;
+	}
+
+	static bool isDelimiter(char c)
+	{
+		return c == ' ' or c == '\n' or c == '\t' or c == '\r' or c == '#';
+	}
+
+	std::istream& in;
+	Format format;
+	std::vector<char> buffer;
+	size_t pos{0};
+	size_t end{0};
+	bool at_eof{false};
+	size_t count{0};
+};
+
+/**
+ * @brief Append a solution (or a failure, if `x` is null) to `out`.
+ * @param index The position of the system in the input, for error records.
+ */
+inline void appendSolution(std::string& out, Format format, size_t index,
+						   const Matrix* solution, const std::string& error)
+{
+	// Both formats write the elements row by row.
+	const Matrix row_major = solution ? solution->toLayout(Layout::RowMajor)
+									  : Matrix{};
+	const Matrix* x = solution ? &row_major : nullptr;
+
+	if (format == Format::Binary)
+	{
+		uint64_t header[3] = {x ? 0u : 1u, 0, 0};
+		if (x)
+		{
+			header[1] = x->size().first;
+			header[2] = x->size().second;
+		}
+		out.append(reinterpret_cast<const char*>(header), sizeof(header));
+		if (x)
+		{
+			out.append(reinterpret_cast<const char*>(x->data()),
+					   header[1] * header[2] * sizeof(double));
+		}
+		return;
+	}
+
+	if (not x)
+	{
+		out += "! " + std::to_string(index) + " " + error + "\n";
+		return;
+	}
+
+	const size_t rows = x->size().first;
+	const size_t cols = x->size().second;
+	out += std::to_string(rows) + " " + std::to_string(cols) + "\n";
+
+	const double* vals = x->data();
+	char number[32];
+	for (size_t row = 0; row != rows; ++row)
+	{
+		for (size_t col = 0; col != cols; ++col)
+		{
+			const int len = std::snprintf(number, sizeof(number), "%.17g",
+										  vals[row * cols + col]);
+			if (col != 0) out += ' ';
+			out.append(number, len);
+		}
+		out += '\n';
+	}
+}
+
+/**
+ * @brief Append a system, in input format, to `out`.
+ */
+inline void appendSystem(std::string& out, Format format,
+						 const LinearSystem& system)
+{
+	const size_t n = system.a.size().first;
+	const size_t m = system.b.size().second;
+	const Matrix a = system.a.toLayout(Layout::RowMajor);
+	const Matrix b = system.b.toLayout(Layout::RowMajor);
+
+	if (format == Format::Binary)
+	{
+		const uint64_t header[2] = {n, m};
+		out.append(reinterpret_cast<const char*>(header), sizeof(header));
+		out.append(reinterpret_cast<const char*>(a.data()),
+				   n * n * sizeof(double));
+		out.append(reinterpret_cast<const char*>(b.data()),
+				   n * m * sizeof(double));
+		return;
+	}
+
+	out += std::to_string(n) + " " + std::to_string(m) + "\n";
+	char number[32];
+	for (const Matrix* mat : {&a, &b})
+	{
+		const size_t cols = mat->size().second;
+		const double* vals = mat->data();
+		for (size_t row = 0; row != n; ++row)
+		{
+			for (size_t col = 0; col != cols; ++col)
+			{
+				const int len = std::snprintf(number, sizeof(number), "%.17g",
+											  vals[row * cols + col]);
+				if (col != 0) out += ' ';
+				out.append(number, len);
+			}
+			out += '\n';
+		}
+	}
+}
+
+/**
+ * @}
+ */
+
+#endif
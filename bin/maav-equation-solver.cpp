@@ -1,25 +1,729 @@
+/**
+ * @brief Solve a stream of linear systems `A * x = B` in parallel.
+ * @detail Systems are read from a file (or standard input) in the text or
+ * 		binary format described in `SystemIo.hpp`, solved with
+ * 		`Matrix::solve()` on a pool of worker threads, and written back out
+ * 		in the order they were read. A summary of the throughput and of the
+ * 		per-system solve latency goes to standard error.
+ *
+ * 		Systems are handed to the workers in batches, each sized to hold
+ * 		roughly the same amount of work, so that tiny systems don't spend
+ * 		most of their time in the queue and huge ones still spread across
+ * 		every worker. Only a bounded number of batches is in flight at once,
+ * 		so memory use doesn't depend on the length of the input.
+ *
+ * 		Once a batch is written out, it goes back to the reader, which reads
+ * 		the next systems straight into its matrices. For small systems,
+ * 		allocating (and, on another thread, freeing) fresh ones for each
+ * 		system would cost more than solving it.
+ *
+ * 		The worked examples that this program used to run are still
+ * 		available with `--self-test`.
+ */
 #include "Helpers.hpp"
+#include "SystemIo.hpp"
+#include "src/Backend.hpp"
 #include "src/Matrix.hpp"
+#include "src/Parallel.hpp"
 
-#include <functional>
-#include <iostream>
+#include <algorithm>			// std::max, std::min
+#include <chrono>				// std::chrono
+#include <cmath>				// std::ceil, std::log, std::pow
+#include <condition_variable>	// std::condition_variable
+#include <cstdlib>				// std::strtoul
+#include <deque>				// std::deque
+#include <exception>			// std::exception, std::exception_ptr
+#include <fstream>				// std::ifstream, std::ofstream
+#include <functional>			// std::function
+#include <iomanip>				// std::setprecision
+#include <iostream>				// std::cerr, std::cin, std::cout
+#include <map>					// std::map
+#include <mutex>				// std::mutex, std::unique_lock
+#include <random>				// std::mt19937_64
+#include <stdexcept>			// std::runtime_error
+#include <string>				// std::string
+#include <thread>				// std::thread
+#include <utility>				// std::move
+#include <vector>				// std::vector
 
+using std::cerr;
 using std::cout;
 using std::endl;
 using std::function;
+using std::runtime_error;
+using std::string;
+
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+
+const char* const usage =
+	"Usage: maav-equation-solver [options] [input]\n"
+	"Solve every system A * x = B in `input` (default: standard input).\n"
+	"\n"
+	"  -f, --format text|binary         input format (default: text)\n"
+	"      --output-format text|binary  output format (default: the input's)\n"
+	"  -o, --output FILE                write solutions to FILE\n"
+	"                                   (default: standard output)\n"
+	"  -n, --no-output                  solve, but don't write solutions\n"
+	"  -j, --threads N                  number of worker threads\n"
+	"                                   (default: MLE_NUM_THREADS, or one\n"
+	"                                   per core); with more than one, the\n"
+	"                                   BLAS backend is limited to one\n"
+	"                                   thread per solve\n"
+	"  -q, --quiet                      don't print the summary\n"
+	"      --generate COUNT SIZE        write COUNT random, well-conditioned\n"
+	"                                   SIZE x SIZE systems, instead of\n"
+	"                                   solving anything\n"
+	"      --self-test                  run the built-in worked examples\n"
+	"  -h, --help                       print this message\n";
+
+struct Options
+{
+	Format input_format{Format::Text};
+	Format output_format{Format::Text};
+	bool output_format_given{false};
+	string input_path{"-"};
+	string output_path{"-"};
+	bool write_output{true};
+	size_t num_threads{0};
+	bool quiet{false};
+	size_t generate_count{0};
+	size_t generate_size{0};
+	bool self_test{false};
+	bool help{false};
+};
+
+Format parseFormat(const string& name)
+{
+	if (name == "text") return Format::Text;
+	if (name == "binary") return Format::Binary;
+	throw runtime_error{"Unknown format '" + name + "'!"};
+}
 
-void runTest(function<bool(void)> test_function);
+size_t parseCount(const string& text)
+{
+	char* end = nullptr;
+	const unsigned long value = std::strtoul(text.c_str(), &end, 10);
+	if (text.empty() or *end != '\0' or value == 0)
+	{
+		throw runtime_error{"Expected a positive number, not '" + text + "'!"};
+	}
+	return value;
+}
+
+Options parseOptions(int argc, char** argv)
+{
+	Options options;
+	bool have_input = false;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const string arg{argv[i]};
+		auto value = [&]() -> string {
+			if (i + 1 == argc)
+			{
+				throw runtime_error{"Option " + arg + " needs a value!"};
+			}
+			return argv[++i];
+		};
+
+		if (arg == "-f" or arg == "--format")
+		{
+			options.input_format = parseFormat(value());
+		}
+		else if (arg == "--output-format")
+		{
+			options.output_format = parseFormat(value());
+			options.output_format_given = true;
+		}
+		else if (arg == "-o" or arg == "--output") options.output_path = value();
+		else if (arg == "-n" or arg == "--no-output") options.write_output = false;
+		else if (arg == "-j" or arg == "--threads")
+		{
+			options.num_threads = parseCount(value());
+		}
+		else if (arg == "-q" or arg == "--quiet") options.quiet = true;
+		else if (arg == "--generate")
+		{
+			options.generate_count = parseCount(value());
+			options.generate_size = parseCount(value());
+		}
+		else if (arg == "--self-test") options.self_test = true;
+		else if (arg == "-h" or arg == "--help") options.help = true;
+		else if (arg.size() > 1 and arg[0] == '-')
+		{
+			throw runtime_error{"Unknown option " + arg + "!"};
+		}
+		else if (have_input)
+		{
+			throw runtime_error{"Only one input file may be given!"};
+		}
+		else
+		{
+			options.input_path = arg;
+			have_input = true;
+		}
+	}
+
+	if (not options.output_format_given)
+	{
+		options.output_format = options.input_format;
+	}
+	if (options.num_threads == 0)
+	{
+		options.num_threads = parallel::numThreads();
+	}
+	return options;
+}
+
+/**
+ * @brief Approximate flop count for solving an `n x n` system with `m`
+ * 		right-hand sides by LU decomposition.
+ */
+double solveFlops(size_t n, size_t m)
+{
+	const double dn = n;
+	return 2.0 / 3.0 * dn * dn * dn + 2.0 * dn * dn * m;
+}
+
+/**
+ * @brief A histogram of durations with logarithmically-spaced buckets.
+ * @detail Each bucket is 5% wider than the last, so percentiles come out
+ * 		within 5% while the memory use stays fixed, however many systems
+ * 		are solved.
+ */
+class LatencyHistogram
+{
+public:
+
+	LatencyHistogram() : counts(num_buckets, 0) {}
+
+	void record(double seconds)
+	{
+		size_t bucket = 0;
+		if (seconds > min_seconds)
+		{
+			bucket = std::log(seconds / min_seconds) / std::log(growth) + 1;
+			bucket = std::min(bucket, num_buckets - 1);
+		}
+		++counts[bucket];
+		++total;
+		max_seconds = std::max(max_seconds, seconds);
+	}
+
+	void merge(const LatencyHistogram& other)
+	{
+		for (size_t i = 0; i != num_buckets; ++i) counts[i] += other.counts[i];
+		total += other.total;
+		max_seconds = std::max(max_seconds, other.max_seconds);
+	}
+
+	/**
+	 * @brief Return (an upper bound on) the `fraction` quantile.
+	 */
+	double percentile(double fraction) const
+	{
+		if (total == 0) return 0.0;
+
+		const size_t rank = std::max<double>(1.0, std::ceil(fraction * total));
+		size_t seen = 0;
+		for (size_t i = 0; i != num_buckets; ++i)
+		{
+			seen += counts[i];
+			if (seen >= rank)
+			{
+				return std::min(max_seconds,
+								min_seconds * std::pow(growth, double(i)));
+			}
+		}
+		return max_seconds;
+	}
+
+	double max() const { return max_seconds; }
+
+private:
+
+	static constexpr double min_seconds = 1e-9;
+	static constexpr double growth = 1.05;
+	static constexpr size_t num_buckets = 640;
+
+	std::vector<size_t> counts;
+	size_t total{0};
+	double max_seconds{0.0};
+};
+
+constexpr double LatencyHistogram::min_seconds;
+constexpr double LatencyHistogram::growth;
+constexpr size_t LatencyHistogram::num_buckets;
+
+/**
+ * @brief Consecutive systems that are solved together by one worker.
+ */
+struct Batch
+{
+	size_t sequence{0};
+	size_t first_index{0};
+
+	/**
+	 * @brief Only the first `num_systems` of these belong to this batch.
+	 * @detail The rest are left over from an earlier use of this batch, and
+	 * 		kept so that the reader can reuse their storage.
+	 */
+	std::vector<LinearSystem> systems;
+	size_t num_systems{0};
+	double flops{0.0};
+
+	/** @brief The formatted solutions, once this batch is solved. */
+	string output;
+};
+
+/**
+ * @brief What one worker did, summed over every batch it solved.
+ */
+struct WorkerStats
+{
+	LatencyHistogram latency;
+	size_t num_solved{0};
+	size_t num_failed{0};
+	double flops{0.0};
+};
+
+/**
+ * @brief Solves batches on a pool of threads and writes them out in order.
+ * @detail The reading thread fills batches from `spareBatch()`, passes them
+ * 		to `submit()`, and calls `finish()` once the input runs out. Workers
+ * 		pull batches off of a queue; a dedicated writer thread waits for the
+ * 		next batch in sequence, writes it, and sets it aside for
+ * 		`spareBatch()`, so output never blocks solving.
+ */
+class Pipeline
+{
+public:
+
+	Pipeline(size_t num_workers, const Options& options, std::ostream* out)
+		: options(options), out{out}, stats(num_workers),
+		  max_in_flight{2 * num_workers + 2}
+	{
+		// Every worker solves its own systems already. A multithreaded
+		// BLAS would otherwise start a full set of threads per worker.
+		if (num_workers > 1) backend::setNumThreads(1);
+
+		for (size_t i = 0; i != num_workers; ++i)
+		{
+			workers.emplace_back([this, i] { work(stats[i]); });
+		}
+		writer = std::thread{[this] { write(); }};
+	}
+
+	/**
+	 * @brief Stop the threads, if `finish()` wasn't called.
+	 * @detail Only reached early if the reading thread threw. A write error
+	 * 		would be dropped here rather than thrown out of a destructor.
+	 */
+	~Pipeline()
+	{
+		if (writer.joinable()) join();
+	}
+
+	/**
+	 * @brief Return an empty batch, reusing one that has been written out
+	 * 		if there is one.
+	 */
+	Batch spareBatch()
+	{
+		std::lock_guard<std::mutex> lock{mutex};
+		if (spare.empty()) return Batch{};
+
+		Batch batch = std::move(spare.back());
+		spare.pop_back();
+		batch.num_systems = 0;
+		batch.flops = 0.0;
+		batch.output.clear();
+		return batch;
+	}
+
+	/**
+	 * @brief Queue a batch, blocking while too many are already in flight.
+	 */
+	void submit(Batch batch)
+	{
+		std::unique_lock<std::mutex> lock{mutex};
+		space_ready.wait(lock, [&] { return in_flight < max_in_flight; });
+		batch.sequence = num_submitted++;
+		++in_flight;
+		pending.push_back(std::move(batch));
+		work_ready.notify_one();
+	}
+
+	/**
+	 * @brief Wait for every queued batch to be solved and written.
+	 * @detail Rethrows the first error that the writer ran into.
+	 */
+	void finish()
+	{
+		join();
+		if (write_error) std::rethrow_exception(write_error);
+	}
+
+	WorkerStats totals() const
+	{
+		WorkerStats sum;
+		for (const WorkerStats& worker : stats)
+		{
+			sum.latency.merge(worker.latency);
+			sum.num_solved += worker.num_solved;
+			sum.num_failed += worker.num_failed;
+			sum.flops += worker.flops;
+		}
+		return sum;
+	}
+
+private:
+
+	/**
+	 * @brief Tell the threads that no more batches are coming, and wait for
+	 * 		them to drain the queue and exit. Never throws.
+	 */
+	void join() noexcept
+	{
+		{
+			std::lock_guard<std::mutex> lock{mutex};
+			input_done = true;
+		}
+		work_ready.notify_all();
+		done_ready.notify_one();
+		for (auto& worker : workers) worker.join();
+		writer.join();
+	}
+
+	void work(WorkerStats& mine)
+	{
+		for (;;)
+		{
+			Batch batch;
+			{
+				std::unique_lock<std::mutex> lock{mutex};
+				work_ready.wait(lock, [&] {
+					return not pending.empty() or input_done;
+				});
+				if (pending.empty()) return;
+				batch = std::move(pending.front());
+				pending.pop_front();
+			}
+
+			solve(batch, mine);
+
+			{
+				std::lock_guard<std::mutex> lock{mutex};
+				const size_t sequence = batch.sequence;
+				solved.emplace(sequence, std::move(batch));
+			}
+			done_ready.notify_one();
+		}
+	}
+
+	void solve(Batch& batch, WorkerStats& mine)
+	{
+		for (size_t i = 0; i != batch.num_systems; ++i)
+		{
+			const LinearSystem& system = batch.systems[i];
+			const size_t index = batch.first_index + i;
+
+			const Clock::time_point start = Clock::now();
+			try
+			{
+				const Matrix x = system.a.solve(system.b);
+				mine.latency.record(
+					std::chrono::duration<double>(Clock::now() - start).count());
+				++mine.num_solved;
+				mine.flops += solveFlops(system.a.size().first,
+										 system.b.size().second);
+				if (out)
+				{
+					appendSolution(batch.output, options.output_format, index,
+								   &x, "");
+				}
+			}
+			catch (const std::exception& error)
+			{
+				++mine.num_failed;
+				if (out)
+				{
+					appendSolution(batch.output, options.output_format, index,
+								   nullptr, error.what());
+				}
+			}
+		}
+	}
+
+	void write()
+	{
+		size_t next = 0;
+		for (;;)
+		{
+			Batch batch;
+			{
+				std::unique_lock<std::mutex> lock{mutex};
+				done_ready.wait(lock, [&] {
+					return solved.count(next) != 0
+						or (input_done and next == num_submitted);
+				});
+				auto found = solved.find(next);
+				if (found == solved.end()) return;
+				batch = std::move(found->second);
+				solved.erase(found);
+			}
+
+			if (out and not write_error)
+			{
+				try
+				{
+					out->write(batch.output.data(), batch.output.size());
+					if (not *out) throw runtime_error{"Failed to write output!"};
+				}
+				catch (...)
+				{
+					write_error = std::current_exception();
+				}
+			}
+			++next;
+
+			{
+				std::lock_guard<std::mutex> lock{mutex};
+				--in_flight;
+				spare.push_back(std::move(batch));
+			}
+			space_ready.notify_one();
+		}
+	}
+
+	const Options& options;
+	std::ostream* out;
+	std::vector<WorkerStats> stats;
+	const size_t max_in_flight;
+
+	std::mutex mutex;
+	std::condition_variable work_ready;
+	std::condition_variable done_ready;
+	std::condition_variable space_ready;
+	std::deque<Batch> pending;
+	std::map<size_t, Batch> solved;
+	std::vector<Batch> spare;
+	size_t num_submitted{0};
+	size_t in_flight{0};
+	bool input_done{false};
+	std::exception_ptr write_error;
+
+	std::vector<std::thread> workers;
+	std::thread writer;
+};
+
+/**
+ * @brief Target amount of work per batch, in flops.
+ * @detail Big enough that queueing costs nothing next to solving, small
+ * 		enough that the batches of a short input still spread across every
+ * 		worker.
+ */
+constexpr double batch_flops = 2e6;
+
+/**
+ * @brief Cap on systems per batch, whatever their size.
+ */
+constexpr size_t batch_systems = 4096;
+
+void printSummary(const WorkerStats& totals, double seconds)
+{
+	const double us = 1e6;
+	cerr << std::setprecision(4)
+		 << "systems:     " << totals.num_solved + totals.num_failed
+		 << " (" << totals.num_failed << " failed)\n"
+		 << "wall time:   " << seconds << " s\n"
+		 << "throughput:  " << (totals.num_solved + totals.num_failed) / seconds
+		 << " systems/s, " << totals.flops / seconds / 1e9 << " GFLOP/s\n"
+		 << "latency:     p50 " << totals.latency.percentile(0.50) * us
+		 << " us, p90 " << totals.latency.percentile(0.90) * us
+		 << " us, p99 " << totals.latency.percentile(0.99) * us
+		 << " us, max " << totals.latency.max() * us << " us\n";
+}
+
+int runBatch(const Options& options)
+{
+	std::ifstream input_file;
+	std::istream* input = &std::cin;
+	if (options.input_path != "-")
+	{
+		input_file.open(options.input_path, std::ios::binary);
+		if (not input_file)
+		{
+			cerr << "Cannot open " << options.input_path << "\n";
+			return 1;
+		}
+		input = &input_file;
+	}
+
+	std::ofstream output_file;
+	std::ostream* output = nullptr;
+	if (options.write_output)
+	{
+		output = &cout;
+		if (options.output_path != "-")
+		{
+			output_file.open(options.output_path, std::ios::binary);
+			if (not output_file)
+			{
+				cerr << "Cannot open " << options.output_path << "\n";
+				return 1;
+			}
+			output = &output_file;
+		}
+	}
+
+	const Clock::time_point start = Clock::now();
+	Pipeline pipeline{options.num_threads, options, output};
+	SystemReader reader{*input, options.input_format};
+	int status = 0;
+	Batch batch = pipeline.spareBatch();
+
+	try
+	{
+		for (;;)
+		{
+			if (batch.num_systems == batch.systems.size())
+			{
+				batch.systems.emplace_back();
+			}
+			LinearSystem& system = batch.systems[batch.num_systems];
+			if (not reader.next(system)) break;
+
+			++batch.num_systems;
+			batch.flops += solveFlops(system.a.size().first,
+									  system.b.size().second);
+			if (batch.flops >= batch_flops
+				or batch.num_systems == batch_systems)
+			{
+				pipeline.submit(std::move(batch));
+				batch = pipeline.spareBatch();
+				batch.first_index = reader.numRead();
+			}
+		}
+	}
+	catch (const std::exception& error)
+	{
+		// Still solve and write out everything before the bad system.
+		cerr << error.what() << "\n";
+		status = 1;
+	}
+	if (batch.num_systems != 0) pipeline.submit(std::move(batch));
+
+	try
+	{
+		pipeline.finish();
+		if (output) output->flush();
+	}
+	catch (const std::exception& error)
+	{
+		cerr << error.what() << "\n";
+		status = 1;
+	}
+
+	if (not options.quiet)
+	{
+		const double seconds =
+			std::chrono::duration<double>(Clock::now() - start).count();
+		printSummary(pipeline.totals(), seconds);
+	}
+	return status;
+}
+
+int runGenerate(const Options& options)
+{
+	std::ofstream output_file;
+	std::ostream* output = &cout;
+	if (options.output_path != "-")
+	{
+		output_file.open(options.output_path, std::ios::binary);
+		output = &output_file;
+	}
+
+	// Diagonally dominant, so every system is comfortably solvable.
+	const size_t n = options.generate_size;
+	std::mt19937_64 engine{20180911};
+	std::uniform_real_distribution<double> uniform{-1.0, 1.0};
+	LinearSystem system{Matrix{n, n}, Matrix{n, 1}};
+	string buffer;
+
+	for (size_t count = 0; count != options.generate_count; ++count)
+	{
+		double* a = system.a.data();
+		double* b = system.b.data();
+		for (size_t i = 0; i != n * n; ++i) a[i] = uniform(engine);
+		for (size_t i = 0; i != n; ++i)
+		{
+			a[i * n + i] += n;
+			b[i] = uniform(engine);
+		}
+
+		appendSystem(buffer, options.output_format, system);
+		if (buffer.size() > (1 << 20))
+		{
+			output->write(buffer.data(), buffer.size());
+			buffer.clear();
+		}
+	}
+	output->write(buffer.data(), buffer.size());
+	output->flush();
+	return *output ? 0 : 1;
+}
+
+} // anonymous namespace
+
+bool runTest(function<bool(void)> test_function);
+bool runSelfTest();
 bool solveEquationOne();
 bool solveEquationTwo();
 bool solveEquationThree();
 bool solveEquationFour();
 
-int main()
+int main(int argc, char** argv)
+{
+	std::ios::sync_with_stdio(false);
+
+	Options options;
+	try
+	{
+		options = parseOptions(argc, argv);
+	}
+	catch (const std::exception& error)
+	{
+		cerr << error.what() << "\n\n" << usage;
+		return 1;
+	}
+
+	if (options.help)
+	{
+		cout << usage;
+		return 0;
+	}
+	if (options.self_test) return runSelfTest() ? 0 : 1;
+	if (options.generate_count != 0) return runGenerate(options);
+	return runBatch(options);
+}
+
+/**
+ * @brief Run every worked example.
+ * @return True if they all passed.
+ */
+bool runSelfTest()
 {
-	runTest(solveEquationOne);
-	runTest(solveEquationTwo);
-	runTest(solveEquationThree);
-	runTest(solveEquationFour);
+	bool all_passed = true;
+	for (auto test : {solveEquationOne, solveEquationTwo,
+					  solveEquationThree, solveEquationFour})
+	{
+		all_passed = runTest(test) and all_passed;
+	}
+	return all_passed;
 }
 
 /**
@@ -27,8 +731,9 @@ int main()
  * @detail Call a given function and print to stdout whether or not it was
  * 		successful.
  * @param test_function	The function to be called.
+ * @return True if the test passed.
  */
-void runTest(function<bool(void)> test_function)
+bool runTest(function<bool(void)> test_function)
 {
 	cout << "========================================\n";
 	bool test_passed = test_function();	// call test function and store output
@@ -43,6 +748,7 @@ void runTest(function<bool(void)> test_function)
 		cout << "!!! Test was not successful! !!!\n";
 	}
 	cout << "========================================" << endl;
+	return test_passed;
 }
 
 /**
@@ -180,7 +886,7 @@ bool solveEquationThree()
 	cout << "\t\tAnswer:\n" << x_ans << "\n";
 
 	// Attempt to solve the equation.
-	return isApproxEqual(b * a.inverse(), x_ans);
+	return isApproxEqual(a.inverse() * b, x_ans);
 }
 
 /**
@@ -241,9 +947,9 @@ bool solveEquationFour()
 	// If the copy-constructor did what it was supposed to, this shouldn't
 	// affect `a` in any way.
 	const auto& val_size = a_vals.size();
-	for (size_t row = 0; row != val_size.first; ++row)
+	for (size_t row = 1; row <= val_size.first; ++row)
 	{
-		for (size_t col = 0; col != val_size.second; ++col)
+		for (size_t col = 1; col <= val_size.second; ++col)
 		{
 			a_vals(row, col) = 9001;
 		}
@@ -264,5 +970,5 @@ bool solveEquationFour()
 	cout << "\t\tAnswer:\n" << x_ans << "\n";
 
 	// Attempt to solve the equation.
-	return isApproxEqual(b * a.inverse(), x_ans);
+	return isApproxEqual(a.inverse() * b, x_ans);
 }
@@ -1,53 +1,310 @@
 #include "Array2D.hpp"
+#include "Kernels.hpp"
+#include "Parallel.hpp"
 
-Array2D::Array2D(size_t num_rows, size_t num_cols)
+#include <algorithm>	// std::copy, std::fill, std::max
+#include <cstdint>		// std::uintptr_t
+#include <cstdlib>		// posix_memalign, std::free
+#include <new>			// std::bad_alloc
+#include <stdexcept>	// std::runtime_error
+#include <utility>		// std::move, std::swap
+
+#include <sys/mman.h>	// madvise, mmap, munmap
+
+using std::runtime_error;
+
+using SizePair = std::pair<size_t, size_t>;
+
+namespace
+{
+
+/**
+ * @brief The size of a transparent huge page on x86-64 and most ARM64
+ * 		kernels.
+ */
+constexpr size_t huge_page_bytes = size_t{1} << 21;
+
+/**
+ * @brief The smallest page size that the first touch has to reach.
+ */
+constexpr size_t page_elements = 4096 / sizeof(double);
+
+/**
+ * @brief Allocate uninitialized, `Array2D::alignment`-aligned storage for
+ * 		`num_elements` doubles.
+ * @detail `new double[]` only guarantees 16-byte alignment, which would
+ * 		make every AVX load of a row's first element a potential split load.
+ */
+double* allocate(size_t num_elements)
+{
+	void* memory = nullptr;
+	if (posix_memalign(&memory, Array2D::alignment,
+					   num_elements * sizeof(double)) != 0)
+	{
+		throw std::bad_alloc{};
+	}
+	return static_cast<double*>(memory);
+}
+
+/**
+ * @brief Map storage for `num_elements` doubles from the operating system,
+ * 		on a huge page boundary, and set `owner` to unmap it.
+ * @detail The mapping reads as zeroes, but no page exists until something
+ * 		touches it.
+ */
+double* allocateLarge(size_t num_elements, std::shared_ptr<void>& owner)
+{
+	const size_t bytes = num_elements * sizeof(double);
+	const size_t length = (bytes + huge_page_bytes - 1)
+		/ huge_page_bytes * huge_page_bytes;
+
+	// Map one huge page extra, then trim both ends so that what's left
+	// starts on a huge page boundary.
+	void* mapped = mmap(nullptr, length + huge_page_bytes,
+						PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+						-1, 0);
+	if (mapped == MAP_FAILED) throw std::bad_alloc{};
+
+	char* address = static_cast<char*>(mapped);
+	const size_t head = (huge_page_bytes
+		- reinterpret_cast<std::uintptr_t>(address) % huge_page_bytes)
+		% huge_page_bytes;
+	if (head != 0) munmap(address, head);
+	munmap(address + head + length, huge_page_bytes - head);
+	address += head;
+
+#ifdef MADV_HUGEPAGE
+	// Only a hint: without transparent huge pages, this fails harmlessly.
+	madvise(address, length, MADV_HUGEPAGE);
+#endif
+
+	owner = std::shared_ptr<void>{address, [length](void* storage) {
+		munmap(storage, length);
+	}};
+	return reinterpret_cast<double*>(address);
+}
+
+/**
+ * @brief Call `body(first, last)` on slices of the `num_lines` rows (for
+ * 		row-major storage) or columns (for column-major storage) of
+ * 		`line_length` elements each, split the way `parallel::forRange()`
+ * 		splits kernels over them.
+ * @detail Each slice is at least one huge page, so that threads don't
+ * 		fight over who touches a page first.
+ */
+void forLines(size_t num_lines, size_t line_length,
+			  parallel::FunctionRef<void(size_t, size_t)> body)
+{
+	const size_t grain = std::max<size_t>(1,
+		huge_page_bytes / sizeof(double) / std::max<size_t>(1, line_length));
+	parallel::forRange(0, num_lines, grain, [&](size_t first, size_t last) {
+		body(first * line_length, last * line_length);
+	});
+}
+
+} // anonymous namespace
+
+constexpr size_t Array2D::alignment;
+constexpr size_t Array2D::large_allocation;
+
+Array2D::Array2D(size_t num_rows, size_t num_cols, Layout layout)
+	: Array2D{uninitialized(num_rows, num_cols, layout)}
+{
+	const size_t num_elements = num_rows * num_cols;
+	if (not storage_owner)
+	{
+		std::fill(contents, contents + num_elements, 0.0);
+		return;
+	}
+
+	// Mapped storage is already zero, so touching one element per page is
+	// enough to put the page in place.
+	const size_t line_length = leadingDimension();
+	forLines(num_elements / line_length, line_length,
+			 [&](size_t first, size_t last) {
+		for (size_t i = first; i < last; i += page_elements) contents[i] = 0.0;
+	});
+}
+
+Array2D Array2D::uninitialized(size_t num_rows, size_t num_cols,
+							   Layout layout)
 {
-	// ADD IMPLEMENTATION HERE
+	Array2D array;
+	array.array_size = SizePair{num_rows, num_cols};
+	array.storage_layout = layout;
+
+	const size_t num_elements = num_rows * num_cols;
+	if (num_elements == 0) return array;
+
+	array.contents = num_elements * sizeof(double) < large_allocation
+		? allocate(num_elements)
+		: allocateLarge(num_elements, array.storage_owner);
+	return array;
+}
+
+Array2D Array2D::wrap(double* data, size_t num_rows, size_t num_cols,
+					  Layout layout, std::shared_ptr<void> owner)
+{
+	if (not owner)
+	{
+		throw runtime_error{"Wrapped Array2D storage needs an owner!"};
+	}
+	if (reinterpret_cast<std::uintptr_t>(data) % alignment != 0)
+	{
+		throw runtime_error{"Array2D storage must be aligned!"};
+	}
+
+	Array2D wrapped;
+	wrapped.contents = data;
+	wrapped.array_size = SizePair{num_rows, num_cols};
+	wrapped.storage_layout = layout;
+	wrapped.storage_owner = std::move(owner);
+	return wrapped;
 }
 
 Array2D::Array2D(const Array2D& to_copy)
+	: Array2D{uninitialized(to_copy.array_size.first, to_copy.array_size.second,
+							to_copy.storage_layout)}
+{
+	const size_t num_elements = array_size.first * array_size.second;
+	if (not storage_owner)
+	{
+		std::copy(to_copy.contents, to_copy.contents + num_elements, contents);
+		return;
+	}
+
+	const size_t line_length = leadingDimension();
+	forLines(num_elements / line_length, line_length,
+			 [&](size_t first, size_t last) {
+		std::copy(to_copy.contents + first, to_copy.contents + last,
+				  contents + first);
+	});
+}
+
+Array2D::Array2D(Array2D&& to_move) noexcept
+	: contents{to_move.contents}, array_size{to_move.array_size},
+	  storage_layout{to_move.storage_layout},
+	  storage_owner{std::move(to_move.storage_owner)}
 {
-	// ADD IMPLEMENTATION HERE
+	to_move.contents = nullptr;
+	to_move.array_size = SizePair{0, 0};
 }
 
 
 Array2D& Array2D::operator=(const Array2D& assign_from)
 {
-	// ADD IMPLEMENTATION HERE
+	if (this == &assign_from) return *this;
+
+	// Copy first, then swap, so that a failed allocation leaves us untouched.
+	Array2D copy{assign_from};
+	std::swap(contents, copy.contents);
+	std::swap(array_size, copy.array_size);
+	std::swap(storage_layout, copy.storage_layout);
+	std::swap(storage_owner, copy.storage_owner);
+
+	return *this;
 }
 
-Array2D::~Array2D()
+Array2D& Array2D::operator=(Array2D&& assign_from) noexcept
 {
-	// ADD IMPLEMENTATION HERE
+	std::swap(contents, assign_from.contents);
+	std::swap(array_size, assign_from.array_size);
+	std::swap(storage_layout, assign_from.storage_layout);
+	std::swap(storage_owner, assign_from.storage_owner);
+	return *this;
+}
 
-	// HINT:	Remember, use `delete[]` to delete arrays!
-	// 			`delete` only deletes the first object the pointer points to!
+Array2D::~Array2D()
+{
+	if (not storage_owner) std::free(contents);
 }
 
 const SizePair& Array2D::size() const
 {
-	// ADD IMPLEMENTATION HERE
+	return array_size;
 }
 
 
 double& Array2D::operator()(size_t row, size_t col)
 {
-	// ADD IMPLEMENTATION HERE
+	if (row >= array_size.first or col >= array_size.second)
+	{
+		throw runtime_error{"Array2D index out of range!"};
+	}
+	return storage_layout == Layout::RowMajor
+		? contents[row * array_size.second + col]
+		: contents[col * array_size.first + row];
 }
 
 
 double Array2D::operator()(size_t row, size_t col) const
 {
-	// ADD IMPLEMENTATION HERE
+	if (row >= array_size.first or col >= array_size.second)
+	{
+		throw runtime_error{"Array2D index out of range!"};
+	}
+	return storage_layout == Layout::RowMajor
+		? contents[row * array_size.second + col]
+		: contents[col * array_size.first + row];
 }
 
 
 double& Array2D::operator[](size_t index)
 {
-	// ADD IMPLEMENTATION HERE
+	return contents[index];
 }
 
 double Array2D::operator[](size_t index) const
 {
-	// ADD IMPLEMENTATION HERE
+	return contents[index];
+}
+
+Layout Array2D::layout() const
+{
+	return storage_layout;
+}
+
+size_t Array2D::leadingDimension() const
+{
+	return storage_layout == Layout::RowMajor ? array_size.second
+											  : array_size.first;
+}
+
+Array2D Array2D::toLayout(Layout layout) const
+{
+	if (layout == storage_layout) return *this;
+
+	// Viewed as a row-major array, the storage is `outer x inner`, and the
+	// converted storage is its transpose.
+	const size_t outer = storage_layout == Layout::RowMajor ? array_size.first
+															: array_size.second;
+	const size_t inner = leadingDimension();
+
+	Array2D converted = uninitialized(array_size.first, array_size.second,
+									  layout);
+	if (outer * inner != 0)
+	{
+		kernels::active().transpose(outer, inner, contents, inner,
+									converted.contents, outer);
+	}
+	return converted;
+}
+
+void Array2D::reshape(size_t num_rows, size_t num_cols)
+{
+	if (num_rows * num_cols != array_size.first * array_size.second)
+	{
+		throw runtime_error{"Cannot reshape Array2D to a different size!"};
+	}
+	array_size = SizePair{num_rows, num_cols};
+}
+
+double* Array2D::data()
+{
+	return contents;
+}
+
+const double* Array2D::data() const
+{
+	return contents;
 }
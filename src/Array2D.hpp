@@ -2,8 +2,23 @@
 #define MAAV_PROJECT_3_ARRAY_2D_HPP
 
 #include <cstdlib>	// size_t
+#include <memory>	// std::shared_ptr
 #include <utility> 	// std::pair
 
+/**
+ * @brief The order in which a two-dimensional array's elements are stored.
+ * @detail In a `RowMajor` array, each row is contiguous; in a
+ * 		`ColumnMajor` array, each column is. Algorithms that walk down
+ * 		columns (column pivoting, Householder QR, `A' * x`) run faster on
+ * 		column-major storage, and it's what Fortran libraries (BLAS, LAPACK)
+ * 		and Eigen use by default.
+ */
+enum class Layout
+{
+	RowMajor,
+	ColumnMajor
+};
+
 /**
  * @brief Represents a two-dimensional array.
  * @author Your Name (youruniqname)
@@ -58,10 +73,55 @@ public:
 
 	Array2D() = default;
 
+	/**
+	 * @brief The alignment, in bytes, of every Array2D's storage.
+	 * @detail One cache line, which is also the width of the widest SIMD
+	 * 		registers that the kernels use. Rows after the first are only
+	 * 		aligned if the row length happens to be a multiple of it.
+	 */
+	static constexpr size_t alignment = 64;
+
+	/**
+	 * @brief The size, in bytes, from which storage is mapped straight from
+	 * 		the operating system instead of coming from the heap.
+	 * @detail Large storage is aligned to 2 MiB and marked for transparent
+	 * 		huge pages, which cuts TLB misses when walking it. Its pages are
+	 * 		first touched in parallel, with the same static split as
+	 * 		`parallel::forRange()`, so each one ends up on the memory node
+	 * 		of the thread that later works on it.
+	 */
+	static constexpr size_t large_allocation = size_t{1} << 25;
+
 	/**
 	 * @brief Create a zero-initialized Array2D with the given size.
+	 * @detail The layout is fixed for the lifetime of the Array2D (though
+	 * 		assigning another Array2D to it takes on that one's layout).
+	 */
+	Array2D(size_t num_rows, size_t num_cols,
+			Layout layout = Layout::RowMajor);
+
+	/**
+	 * @brief Create an Array2D whose elements are left uninitialized, for
+	 * 		callers that are about to overwrite all of them anyway.
+	 * @detail Skips the pass that zeroes the storage. Past
+	 * 		`large_allocation`, it also skips touching the pages, so they're
+	 * 		placed by whichever threads first write to them.
+	 */
+	static Array2D uninitialized(size_t num_rows, size_t num_cols,
+								 Layout layout = Layout::RowMajor);
+
+	/**
+	 * @brief Create an Array2D over storage that it doesn't own, such as a
+	 * 		region of shared memory.
+	 * @detail `data` must stay valid for as long as `owner` is alive. The
+	 * 		Array2D holds on to `owner` (and hands it over when moved) instead
+	 * 		of freeing `data`. Copies of it get storage of their own, as usual.
+	 *
+	 * 		Throws an `std::runtime_error` if `owner` is null, or if `data`
+	 * 		isn't aligned to `alignment` bytes.
 	 */
-	Array2D(size_t num_rows, size_t num_cols);
+	static Array2D wrap(double* data, size_t num_rows, size_t num_cols,
+						Layout layout, std::shared_ptr<void> owner);
 
 	/**
 	 * @addtogroup BIG_THREE The Big Three
@@ -155,6 +215,17 @@ public:
 	 * @}
 	 */
 
+	/**
+	 * @brief Take over the storage of `to_move`, leaving it empty.
+	 */
+	Array2D(Array2D&& to_move) noexcept;
+
+	/**
+	 * @brief Swap storage with `assign_from`, which is left valid but with
+	 * 		unspecified contents.
+	 */
+	Array2D& operator=(Array2D&& assign_from) noexcept;
+
 	/**
 	 * @brief Return the size of this Array as a `(num_rows, num_columns)` pair.
 	 */
@@ -190,6 +261,48 @@ public:
 	 */
 	double operator[](size_t index) const;
 
+	/**
+	 * @brief Return the order in which this Array2D's elements are stored.
+	 */
+	Layout layout() const;
+
+	/**
+	 * @brief Return the distance, in elements, between the starts of two
+	 * 		consecutive rows (for row-major storage) or columns (for
+	 * 		column-major storage).
+	 */
+	size_t leadingDimension() const;
+
+	/**
+	 * @brief Return a copy of this Array2D stored in the given layout.
+	 * @detail Changing the layout is a transpose of the underlying array, so
+	 * 		it's done in cache-sized tiles. If `layout` is already this
+	 * 		Array2D's layout, this is a plain copy.
+	 */
+	Array2D toLayout(Layout layout) const;
+
+	/**
+	 * @brief Change the shape of this Array2D without moving its elements.
+	 * @detail Element `i` of the underlying array stays element `i`. Throws
+	 * 		an `std::runtime_error` if the number of elements would change.
+	 */
+	void reshape(size_t num_rows, size_t num_cols);
+
+	/**
+	 * @brief Return a pointer to the first element of the underlying array.
+	 * @detail In a row-major Array2D, element `(row, col)` lives at
+	 * 		`data()[row * size().second + col]`; in a column-major one, it
+	 * 		lives at `data()[col * size().first + row]`. The pointer is
+	 * 		aligned to `alignment` bytes. Returns `nullptr` for an empty
+	 * 		Array2D.
+	 */
+	double* data();
+
+	/**
+	 * @brief Return a read-only pointer to the underlying array.
+	 */
+	const double* data() const;
+
 private:
 
 	/**
@@ -216,6 +329,18 @@ private:
 	/**
 	 * @}
 	 */
+
+	/**
+	 * @brief The order in which `contents` is stored.
+	 */
+	Layout storage_layout{Layout::RowMajor};
+
+	/**
+	 * @brief Whatever keeps `contents` alive, if it isn't heap storage: the
+	 * 		mapping of a large allocation, or an owner given to `wrap()`.
+	 * 		Null otherwise.
+	 */
+	std::shared_ptr<void> storage_owner;
 };
 
 #endif
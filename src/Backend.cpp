@@ -0,0 +1,269 @@
+#include "Backend.hpp"
+
+#include <algorithm>	// std::copy, std::fill, std::max, std::min
+#include <atomic>		// std::atomic
+#include <climits>		// INT_MAX
+#include <stdexcept>	// std::runtime_error
+#include <vector>		// std::vector
+
+#if defined(MLE_BACKEND_EIGEN)
+#include <Eigen/Dense>
+#endif
+
+#ifndef MLE_DISPATCH_THRESHOLD
+#define MLE_DISPATCH_THRESHOLD 64
+#endif
+
+using std::runtime_error;
+
+#if defined(MLE_BACKEND_BLAS)
+// Fortran BLAS/LAPACK entry points. We declare them ourselves rather than
+// depending on cblas.h/lapacke.h, which not every distribution ships.
+extern "C"
+{
+	void dgemm_(const char* transa, const char* transb,
+				const int* m, const int* n, const int* k,
+				const double* alpha, const double* a, const int* lda,
+				const double* b, const int* ldb,
+				const double* beta, double* c, const int* ldc);
+
+	void dgetrf_(const int* m, const int* n, double* a, const int* lda,
+				 int* ipiv, int* info);
+
+	void dgetri_(const int* n, double* a, const int* lda, const int* ipiv,
+				 double* work, const int* lwork, int* info);
+
+	void dgesv_(const int* n, const int* nrhs, double* a, const int* lda,
+				int* ipiv, double* b, const int* ldb, int* info);
+
+	// Thread controls of the BLAS implementations that have them. They're
+	// weak, so they're null unless the linked library provides them.
+	void openblas_set_num_threads(int num_threads) __attribute__((weak));
+	void mkl_set_num_threads(int num_threads) __attribute__((weak));
+}
+#endif
+
+namespace
+{
+
+std::atomic<size_t> threshold{MLE_DISPATCH_THRESHOLD};
+
+#if defined(MLE_BACKEND_EIGEN)
+using RowMajorMatrixXd =
+	Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+using ConstMap = Eigen::Map<const RowMajorMatrixXd>;
+using MutableMap = Eigen::Map<RowMajorMatrixXd>;
+
+ConstMap mapOf(const Array2D& array)
+{
+	return ConstMap{array.data(), static_cast<Eigen::Index>(array.size().first),
+		static_cast<Eigen::Index>(array.size().second)};
+}
+
+MutableMap mapOf(Array2D& array)
+{
+	return MutableMap{array.data(), static_cast<Eigen::Index>(array.size().first),
+		static_cast<Eigen::Index>(array.size().second)};
+}
+
+Eigen::PartialPivLU<RowMajorMatrixXd> factor(const Array2D& a)
+{
+	Eigen::PartialPivLU<RowMajorMatrixXd> lu{mapOf(a)};
+	if ((lu.matrixLU().diagonal().array() == 0.0).any())
+	{
+		throw runtime_error{"Matrix is singular!"};
+	}
+	return lu;
+}
+#endif
+
+#if defined(MLE_BACKEND_BLAS)
+/**
+ * @brief Convert a dimension to the `int` that Fortran BLAS/LAPACK take.
+ * @detail Throws rather than silently truncating sizes past `INT_MAX`.
+ */
+int toInt(size_t value)
+{
+	if (value > static_cast<size_t>(INT_MAX))
+	{
+		throw runtime_error{"Matrix is too large for the BLAS backend!"};
+	}
+	return static_cast<int>(value);
+}
+
+/**
+ * @brief Copy a row-major array into a column-major buffer.
+ */
+std::vector<double> toColumnMajor(const Array2D& array)
+{
+	const size_t rows = array.size().first;
+	const size_t cols = array.size().second;
+	std::vector<double> out(rows * cols);
+	for (size_t row = 0; row != rows; ++row)
+	{
+		for (size_t col = 0; col != cols; ++col)
+		{
+			out[col * rows + row] = array[row * cols + col];
+		}
+	}
+	return out;
+}
+#endif
+
+} // anonymous namespace
+
+namespace backend
+{
+
+const char* name()
+{
+#if defined(MLE_BACKEND_BLAS)
+	return "blas";
+#elif defined(MLE_BACKEND_EIGEN)
+	return "eigen";
+#else
+	return "none";
+#endif
+}
+
+bool available()
+{
+#if defined(MLE_BACKEND_BLAS) || defined(MLE_BACKEND_EIGEN)
+	return true;
+#else
+	return false;
+#endif
+}
+
+size_t dispatchThreshold()
+{
+	return threshold.load(std::memory_order_relaxed);
+}
+
+void setDispatchThreshold(size_t new_threshold)
+{
+	threshold.store(new_threshold, std::memory_order_relaxed);
+}
+
+bool setNumThreads(size_t num_threads)
+{
+	const int clamped = static_cast<int>(
+		std::max<size_t>(1, std::min<size_t>(num_threads, INT_MAX)));
+#if defined(MLE_BACKEND_BLAS)
+	if (openblas_set_num_threads)
+	{
+		openblas_set_num_threads(clamped);
+		return true;
+	}
+	if (mkl_set_num_threads)
+	{
+		mkl_set_num_threads(clamped);
+		return true;
+	}
+	return false;
+#elif defined(MLE_BACKEND_EIGEN)
+	Eigen::setNbThreads(clamped);
+	return true;
+#else
+	(void)clamped;
+	return false;
+#endif
+}
+
+bool shouldDispatch(size_t largest_dim)
+{
+	return available() and largest_dim >= dispatchThreshold();
+}
+
+void multiply(const Array2D& lhs, const Array2D& rhs, Array2D& out)
+{
+#if defined(MLE_BACKEND_BLAS)
+	// A row-major array is its own transpose when read as column-major, so
+	// we compute `out' = rhs' * lhs'` to get a row-major `out`.
+	const int m = toInt(lhs.size().first);
+	const int k = toInt(lhs.size().second);
+	const int n = toInt(rhs.size().second);
+	const double alpha = 1.0;
+	const double beta = 0.0;
+	if (m == 0 or n == 0) return;
+	if (k == 0)
+	{
+		// An empty sum; don't leave it to the BLAS to get right.
+		std::fill(out.data(), out.data() + static_cast<size_t>(m) * n, 0.0);
+		return;
+	}
+
+	// The reference BLAS checks LDA >= max(1, K), and its XERBLA stops the
+	// whole process on a violation.
+	const int lda = std::max(1, k);
+	dgemm_("N", "N", &n, &m, &k, &alpha, rhs.data(), &n, lhs.data(), &lda,
+		   &beta, out.data(), &n);
+#elif defined(MLE_BACKEND_EIGEN)
+	mapOf(out).noalias() = mapOf(lhs) * mapOf(rhs);
+#else
+	(void) lhs; (void) rhs; (void) out;
+	throw runtime_error{"No external backend was compiled in!"};
+#endif
+}
+
+void inverse(const Array2D& a, Array2D& out)
+{
+#if defined(MLE_BACKEND_BLAS)
+	// inv(A') == inv(A)', so we can invert the row-major array in place
+	// without transposing it first.
+	out = a;
+	const int n = toInt(a.size().first);
+	if (n == 0) return;
+	std::vector<int> pivots(n);
+	int info = 0;
+	dgetrf_(&n, &n, out.data(), &n, pivots.data(), &info);
+	if (info != 0) throw runtime_error{"Matrix is singular!"};
+
+	int lwork = -1;
+	double work_query = 0.0;
+	dgetri_(&n, out.data(), &n, pivots.data(), &work_query, &lwork, &info);
+	lwork = static_cast<int>(work_query);
+	std::vector<double> work(lwork > 0 ? lwork : 1);
+	dgetri_(&n, out.data(), &n, pivots.data(), work.data(), &lwork, &info);
+	if (info != 0) throw runtime_error{"Matrix is singular!"};
+#elif defined(MLE_BACKEND_EIGEN)
+	mapOf(out) = factor(a).inverse();
+#else
+	(void) a; (void) out;
+	throw runtime_error{"No external backend was compiled in!"};
+#endif
+}
+
+void solve(const Array2D& a, const Array2D& b, Array2D& out)
+{
+#if defined(MLE_BACKEND_BLAS)
+	const int n = toInt(a.size().first);
+	const int nrhs = toInt(b.size().second);
+	if (n == 0 or nrhs == 0) return;
+
+	std::vector<double> lu = toColumnMajor(a);
+	std::vector<double> x = toColumnMajor(b);
+	std::vector<int> pivots(n);
+	int info = 0;
+	dgesv_(&n, &nrhs, lu.data(), &n, pivots.data(), x.data(), &n, &info);
+	if (info != 0) throw runtime_error{"Matrix is singular!"};
+
+	// Each dimension fits in an `int`, but their product might not.
+	const size_t rows = a.size().first;
+	const size_t cols = b.size().second;
+	for (size_t row = 0; row != rows; ++row)
+	{
+		for (size_t col = 0; col != cols; ++col)
+		{
+			out[row * cols + col] = x[col * rows + row];
+		}
+	}
+#elif defined(MLE_BACKEND_EIGEN)
+	mapOf(out).noalias() = factor(a).solve(mapOf(b));
+#else
+	(void) a; (void) b; (void) out;
+	throw runtime_error{"No external backend was compiled in!"};
+#endif
+}
+
+} // namespace backend
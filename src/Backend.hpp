@@ -0,0 +1,88 @@
+#ifndef MAAV_PROJECT_3_BACKEND_HPP
+#define MAAV_PROJECT_3_BACKEND_HPP
+
+#include "Array2D.hpp"
+
+#include <cstdlib>	// size_t
+
+/**
+ * @brief Optional routing of large operations to an external linear algebra
+ * 		library.
+ * @detail The library is configured with the `USE_EXTERNAL_BACKEND` CMake
+ * 		option. When it's ON, CMake looks for a system BLAS/LAPACK first and
+ * 		falls back to Eigen; the one it finds is compiled in here.
+ *
+ * 		Small operands stay on the library's own kernels, since the call
+ * 		overhead of a tuned library outweighs its benefits for, say, a 2x2
+ * 		inverse. Only operations whose largest dimension is at least
+ * 		`dispatchThreshold()` are routed to the backend.
+ *
+ * 		All arrays are zero-indexed, and their storage is treated as
+ * 		row-major regardless of `Array2D::layout()` (see `Decompositions.hpp`).
+ */
+namespace backend
+{
+
+/**
+ * @brief Return the name of the compiled-in backend: "blas", "eigen", or
+ * 		"none".
+ */
+const char* name();
+
+/**
+ * @brief Return true if a backend was compiled in.
+ */
+bool available();
+
+/**
+ * @brief Return the smallest dimension that gets routed to the backend.
+ * @detail Defaults to the `BACKEND_DISPATCH_THRESHOLD` CMake cache variable.
+ */
+size_t dispatchThreshold();
+
+/**
+ * @brief Change the dispatch threshold at runtime.
+ * @detail Mostly useful for tests and benchmarks. Setting this to zero
+ * 		routes every operation to the backend.
+ */
+void setDispatchThreshold(size_t threshold);
+
+/**
+ * @brief Limit the backend to `num_threads` threads of its own, if it's
+ * 		multithreaded.
+ * @detail Callers that already run one operation per core, such as a pool
+ * 		of workers that each solve their own system, should set this to one
+ * 		so that each operation doesn't also spread across every core. The
+ * 		setting is process-wide, and zero counts as one.
+ * @return False if the backend has no thread control that's known here
+ * 		(e.g. reference BLAS, which is single-threaded anyway).
+ */
+bool setNumThreads(size_t num_threads);
+
+/**
+ * @brief Return true if an operation whose largest dimension is
+ * 		`largest_dim` should be routed to the backend.
+ */
+bool shouldDispatch(size_t largest_dim);
+
+/**
+ * @brief Store the matrix product `lhs * rhs` in `out`.
+ * @detail `out` must already have the right size.
+ */
+void multiply(const Array2D& lhs, const Array2D& rhs, Array2D& out);
+
+/**
+ * @brief Store the inverse of the square array `a` in `out`.
+ * @detail Throws an `std::runtime_error` if `a` is singular.
+ */
+void inverse(const Array2D& a, Array2D& out);
+
+/**
+ * @brief Store the solution `x` of `a * x = b` in `out`.
+ * @detail Throws an `std::runtime_error` if `a` is singular.
+ */
+void solve(const Array2D& a, const Array2D& b, Array2D& out);
+
+} // namespace backend
+
+#endif
@@ -0,0 +1,420 @@
+#include "BandMatrix.hpp"
+#include "Kernels.hpp"
+#include "Parallel.hpp"
+
+#include <algorithm>	// std::max, std::min
+#include <cmath>		// std::abs
+#include <stdexcept>	// std::runtime_error
+#include <utility>		// std::swap
+#include <vector>		// std::vector
+
+using std::runtime_error;
+
+namespace
+{
+
+/**
+ * @brief The minimum number of rows of a product per thread.
+ */
+constexpr size_t row_grain = 256;
+
+/**
+ * @brief The minimum number of right-hand sides (or systems) per thread.
+ */
+constexpr size_t column_grain = 32;
+
+void checkRhs(const Matrix& rhs, size_t n)
+{
+	if (n == 0)
+	{
+		throw runtime_error{"Operation invoked on a blank Matrix!"};
+	}
+	if (rhs.size().first != n)
+	{
+		throw runtime_error{"Matrix dimensions are invalid for multiplication!"};
+	}
+}
+
+/**
+ * @brief Run the Thomas algorithm on `cols` systems side by side.
+ * @detail The coefficients of row `i` of system `s` are at
+ * 		`i * coeff_ld + s * coeff_step` in `a`, `b`, and `c`; a `coeff_step`
+ * 		of zero shares one system among all of the right-hand sides. `x`
+ * 		holds the right-hand sides on entry and the solutions on return.
+ * 		`scratch` must hold `n * cols` elements.
+ */
+void thomas(size_t n, size_t cols, const double* a, const double* b,
+			const double* c, size_t coeff_ld, size_t coeff_step,
+			double* x, size_t ld_x, double* scratch)
+{
+	bool singular = false;
+
+	for (size_t s = 0; s != cols; ++s)
+	{
+		const double pivot = b[s * coeff_step];
+		singular = singular or pivot == 0.0;
+		scratch[s] = c[s * coeff_step] / pivot;
+		x[s] /= pivot;
+	}
+
+	for (size_t i = 1; i < n; ++i)
+	{
+		const double* a_i = a + i * coeff_ld;
+		const double* b_i = b + i * coeff_ld;
+		const double* c_i = c + i * coeff_ld;
+		const double* prev_scratch = scratch + (i - 1) * cols;
+		double* curr_scratch = scratch + i * cols;
+		const double* prev_x = x + (i - 1) * ld_x;
+		double* curr_x = x + i * ld_x;
+
+		for (size_t s = 0; s != cols; ++s)
+		{
+			const double lower = a_i[s * coeff_step];
+			const double pivot = b_i[s * coeff_step] - lower * prev_scratch[s];
+			singular = singular or pivot == 0.0;
+			curr_scratch[s] = c_i[s * coeff_step] / pivot;
+			curr_x[s] = (curr_x[s] - lower * prev_x[s]) / pivot;
+		}
+	}
+
+	if (singular)
+	{
+		throw runtime_error{"Tridiagonal system has a zero pivot!"};
+	}
+
+	for (size_t i = n - 1; i-- > 0;)
+	{
+		const double* curr_scratch = scratch + i * cols;
+		const double* next_x = x + (i + 1) * ld_x;
+		double* curr_x = x + i * ld_x;
+		for (size_t s = 0; s != cols; ++s)
+		{
+			curr_x[s] -= curr_scratch[s] * next_x[s];
+		}
+	}
+}
+
+} // anonymous namespace
+
+//---------------------------------------------------------------------
+// BandMatrix
+//---------------------------------------------------------------------
+
+BandMatrix::BandMatrix(size_t n, size_t lower, size_t upper)
+	: band{n, lower + upper + 1}, matrix_size{n, n},
+	  lower{lower}, upper{upper}
+{
+}
+
+BandMatrix BandMatrix::fromDense(const Matrix& dense, double tolerance)
+{
+	const size_t n = dense.size().first;
+	if (n != dense.size().second)
+	{
+		throw runtime_error{"Cannot store a non-square matrix as a band!"};
+	}
+
+	const Matrix row_major = dense.toLayout(Layout::RowMajor);
+	const double* vals = row_major.data();
+	size_t lower = 0;
+	size_t upper = 0;
+	for (size_t row = 0; row != n; ++row)
+	{
+		for (size_t col = 0; col != n; ++col)
+		{
+			if (not (std::abs(vals[row * n + col]) > tolerance)) continue;
+			if (row > col) lower = std::max(lower, row - col);
+			else upper = std::max(upper, col - row);
+		}
+	}
+
+	BandMatrix result{n, lower, upper};
+	for (size_t row = 0; row != n; ++row)
+	{
+		const size_t first = row > lower ? row - lower : 0;
+		const size_t last = std::min(n, row + upper + 1);
+		for (size_t col = first; col != last; ++col)
+		{
+			result.band(row, col + lower - row) = vals[row * n + col];
+		}
+	}
+	return result;
+}
+
+Matrix BandMatrix::toDense() const
+{
+	const size_t n = matrix_size.first;
+	Matrix dense{n, n};
+
+	double* vals = dense.data();
+	for (size_t row = 0; row != n; ++row)
+	{
+		const size_t first = row > lower ? row - lower : 0;
+		const size_t last = std::min(n, row + upper + 1);
+		for (size_t col = first; col != last; ++col)
+		{
+			vals[row * n + col] = band(row, col + lower - row);
+		}
+	}
+	return dense;
+}
+
+const BandMatrix::SizePair& BandMatrix::size() const
+{
+	return matrix_size;
+}
+
+size_t BandMatrix::lowerBandwidth() const
+{
+	return lower;
+}
+
+size_t BandMatrix::upperBandwidth() const
+{
+	return upper;
+}
+
+bool BandMatrix::inBand(size_t row, size_t col) const
+{
+	return row <= col + lower and col <= row + upper;
+}
+
+double& BandMatrix::operator()(size_t row, size_t col)
+{
+	if (row == 0 or col == 0)
+	{
+		throw runtime_error{"Matrix indices start from one!"};
+	}
+	if (row > matrix_size.first or col > matrix_size.second)
+	{
+		throw runtime_error{"Matrix index out of range!"};
+	}
+	if (not inBand(row, col))
+	{
+		throw runtime_error{"Cannot modify an element outside of the band!"};
+	}
+	return band(row - 1, col + lower - row);
+}
+
+double BandMatrix::operator()(size_t row, size_t col) const
+{
+	if (row == 0 or col == 0)
+	{
+		throw runtime_error{"Matrix indices start from one!"};
+	}
+	if (row > matrix_size.first or col > matrix_size.second)
+	{
+		throw runtime_error{"Matrix index out of range!"};
+	}
+	if (not inBand(row, col)) return 0.0;
+	return band(row - 1, col + lower - row);
+}
+
+Matrix BandMatrix::operator*(const Matrix& rhs) const
+{
+	const size_t n = matrix_size.first;
+	checkRhs(rhs, n);
+
+	const size_t p = rhs.size().second;
+	Matrix result{n, p};
+	const Matrix row_major = rhs.toLayout(Layout::RowMajor);
+	const double* x = row_major.data();
+	double* y = result.data();
+	const double* coeffs = band.data();
+	const size_t width = lower + upper + 1;
+	const kernels::KernelTable& kernel = kernels::active();
+
+	parallel::forRange(0, n, row_grain, [&](size_t first, size_t last) {
+		for (size_t row = first; row != last; ++row)
+		{
+			const size_t col_first = row > lower ? row - lower : 0;
+			const size_t col_last = std::min(n, row + upper + 1);
+			const double* row_coeffs = coeffs + row * width
+									 + (col_first + lower - row);
+
+			if (p == 1)
+			{
+				// A band row and the slice of `x` it meets are both
+				// contiguous.
+				y[row] = kernel.dot(col_last - col_first, row_coeffs,
+									x + col_first);
+				continue;
+			}
+
+			double* y_row = y + row * p;
+			for (size_t col = col_first; col != col_last; ++col)
+			{
+				const double coeff = row_coeffs[col - col_first];
+				const double* x_row = x + col * p;
+				for (size_t k = 0; k != p; ++k) y_row[k] += coeff * x_row[k];
+			}
+		}
+	});
+
+	return result;
+}
+
+Matrix BandMatrix::solve(const Matrix& rhs) const
+{
+	const size_t n = matrix_size.first;
+	if (n == 0)
+	{
+		throw runtime_error{"Operation invoked on a blank Matrix!"};
+	}
+	if (rhs.size().first != n)
+	{
+		throw runtime_error{"Right-hand side has the wrong number of rows!"};
+	}
+
+	// Row swaps bring in rows that reach up to `lower` columns further
+	// right, so `U` needs room for `lower + upper` superdiagonals.
+	const size_t fill = lower + upper;
+	const size_t width = lower + fill + 1;
+	Array2D lu{n, width};
+	for (size_t row = 0; row != n; ++row)
+	{
+		for (size_t offset = 0; offset != lower + upper + 1; ++offset)
+		{
+			lu(row, offset) = band(row, offset);
+		}
+	}
+	auto at = [&](size_t row, size_t col) -> double& {
+		return lu[row * width + (col + lower - row)];
+	};
+
+	std::vector<size_t> pivots(n);
+	for (size_t k = 0; k != n; ++k)
+	{
+		const size_t last_row = std::min(n - 1, k + lower);
+		const size_t last_col = std::min(n - 1, k + fill);
+
+		size_t pivot_row = k;
+		double pivot_mag = std::abs(at(k, k));
+		for (size_t row = k + 1; row <= last_row; ++row)
+		{
+			const double mag = std::abs(at(row, k));
+			if (mag > pivot_mag)
+			{
+				pivot_mag = mag;
+				pivot_row = row;
+			}
+		}
+		pivots[k] = pivot_row;
+		if (pivot_mag == 0.0)
+		{
+			throw runtime_error{"Matrix is singular!"};
+		}
+
+		if (pivot_row != k)
+		{
+			for (size_t col = k; col <= last_col; ++col)
+			{
+				std::swap(at(k, col), at(pivot_row, col));
+			}
+		}
+
+		const double inv_pivot = 1.0 / at(k, k);
+		for (size_t row = k + 1; row <= last_row; ++row)
+		{
+			const double multiplier = at(row, k) * inv_pivot;
+			at(row, k) = multiplier;
+			for (size_t col = k + 1; col <= last_col; ++col)
+			{
+				at(row, col) -= multiplier * at(k, col);
+			}
+		}
+	}
+
+	const size_t p = rhs.size().second;
+	Matrix result = rhs.toLayout(Layout::RowMajor);
+	double* x = result.data();
+
+	// Forward substitution, applying each row swap just before the column
+	// of `L` that it belongs to.
+	for (size_t k = 0; k != n; ++k)
+	{
+		double* x_k = x + k * p;
+		if (pivots[k] != k)
+		{
+			double* x_pivot = x + pivots[k] * p;
+			for (size_t col = 0; col != p; ++col) std::swap(x_k[col], x_pivot[col]);
+		}
+		const size_t last_row = std::min(n - 1, k + lower);
+		for (size_t row = k + 1; row <= last_row; ++row)
+		{
+			const double l = at(row, k);
+			double* x_row = x + row * p;
+			for (size_t col = 0; col != p; ++col) x_row[col] -= l * x_k[col];
+		}
+	}
+
+	// Back substitution with the widened `U`.
+	for (size_t row = n; row-- > 0;)
+	{
+		double* x_row = x + row * p;
+		const size_t last_col = std::min(n - 1, row + fill);
+		for (size_t k = row + 1; k <= last_col; ++k)
+		{
+			const double u = at(row, k);
+			const double* x_k = x + k * p;
+			for (size_t col = 0; col != p; ++col) x_row[col] -= u * x_k[col];
+		}
+		const double inv_diag = 1.0 / at(row, row);
+		for (size_t col = 0; col != p; ++col) x_row[col] *= inv_diag;
+	}
+
+	return result;
+}
+
+//---------------------------------------------------------------------
+// tridiagonal
+//---------------------------------------------------------------------
+
+namespace tridiagonal
+{
+
+Matrix solve(const std::vector<double>& lower, const std::vector<double>& diag,
+			 const std::vector<double>& upper, const Matrix& rhs)
+{
+	const size_t n = diag.size();
+	if (lower.size() != n or upper.size() != n)
+	{
+		throw runtime_error{"Tridiagonal coefficients have different lengths!"};
+	}
+	checkRhs(rhs, n);
+
+	const size_t p = rhs.size().second;
+	Matrix result = rhs.toLayout(Layout::RowMajor);
+	double* x = result.data();
+
+	parallel::forRange(0, p, column_grain, [&](size_t first, size_t last) {
+		std::vector<double> scratch(n * (last - first));
+		thomas(n, last - first, lower.data(), diag.data(), upper.data(), 1, 0,
+			   x + first, p, scratch.data());
+	});
+
+	return result;
+}
+
+void solveBatch(const Array2D& lower, const Array2D& diag,
+				const Array2D& upper, Array2D& rhs)
+{
+	const size_t n = diag.size().first;
+	const size_t count = diag.size().second;
+	if (lower.size() != diag.size() or upper.size() != diag.size()
+		or rhs.size() != diag.size())
+	{
+		throw runtime_error{"Tridiagonal batch arrays have different sizes!"};
+	}
+	if (n == 0 or count == 0) return;
+
+	double* x = rhs.data();
+	parallel::forRange(0, count, column_grain, [&](size_t first, size_t last) {
+		std::vector<double> scratch(n * (last - first));
+		thomas(n, last - first, lower.data() + first, diag.data() + first,
+			   upper.data() + first, count, 1, x + first, count,
+			   scratch.data());
+	});
+}
+
+} // namespace tridiagonal
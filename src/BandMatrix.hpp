@@ -0,0 +1,147 @@
+#ifndef MAAV_PROJECT_3_BAND_MATRIX_HPP
+#define MAAV_PROJECT_3_BAND_MATRIX_HPP
+
+#include "Array2D.hpp"
+#include "Matrix.hpp"
+
+#include <cstdlib>	// size_t
+#include <utility>	// std::pair
+#include <vector>	// std::vector
+
+/**
+ * @brief A square matrix whose nonzeros all lie within a band around the
+ * 		diagonal.
+ * @detail `lower` is the number of nonzero diagonals below the main diagonal
+ * 		and `upper` the number above it, so a tridiagonal matrix has
+ * 		`lower == upper == 1`. Only the band is stored: row `i` keeps its
+ * 		`lower + upper + 1` band elements next to each other, which takes
+ * 		O(n) memory instead of O(n^2).
+ *
+ * 		`operator()` indexes from one. Reading outside of the band returns
+ * 		zero; trying to modify an element outside of it throws an
+ * 		`std::runtime_error`.
+ *
+ * 		Dense arguments may have either layout; dense results are
+ * 		row-major.
+ */
+class BandMatrix
+{
+	using SizePair = std::pair<size_t, size_t>;
+
+public:
+
+	BandMatrix() = default;
+
+	/**
+	 * @brief Create a zero-initialized `n x n` band matrix.
+	 */
+	BandMatrix(size_t n, size_t lower, size_t upper);
+
+	/**
+	 * @brief Copy a dense, square Matrix into band storage.
+	 * @detail The bandwidths are the smallest ones that hold every element
+	 * 		whose magnitude is greater than `tolerance`; everything outside
+	 * 		of them is dropped. Throws an `std::runtime_error` if `dense`
+	 * 		isn't square.
+	 */
+	static BandMatrix fromDense(const Matrix& dense, double tolerance = 0.0);
+
+	/**
+	 * @brief Return a dense copy of this matrix, zeroes included.
+	 */
+	Matrix toDense() const;
+
+	/**
+	 * @brief Return this matrix's size as an `(n, n)` pair.
+	 */
+	const SizePair& size() const;
+
+	/**
+	 * @brief Return the number of diagonals stored below the main diagonal.
+	 */
+	size_t lowerBandwidth() const;
+
+	/**
+	 * @brief Return the number of diagonals stored above the main diagonal.
+	 */
+	size_t upperBandwidth() const;
+
+	double& operator()(size_t row, size_t col);
+	double operator()(size_t row, size_t col) const;
+
+	/**
+	 * @brief Return the product of this matrix with a dense Matrix.
+	 * @detail Takes O(n * (lower + upper) * rhs columns) time. Throws an
+	 * 		`std::runtime_error` if the sizes don't match.
+	 */
+	Matrix operator*(const Matrix& rhs) const;
+
+	/**
+	 * @brief Solve `(*this) * x = rhs` for `x` and return it.
+	 * @detail Uses LU decomposition with partial pivoting, restricted to the
+	 * 		band. Row swaps can widen the upper band of `U` to
+	 * 		`lower + upper`, so this takes O(n * lower * (lower + upper))
+	 * 		time and O(n * (2 * lower + upper)) extra memory. Each column of
+	 * 		`rhs` is a separate right-hand side.
+	 *
+	 * 		Throws an `std::runtime_error` if the sizes don't match or if this
+	 * 		matrix is singular.
+	 */
+	Matrix solve(const Matrix& rhs) const;
+
+private:
+
+	/**
+	 * @brief True if `(row, col)` (zero-indexed) is inside the band.
+	 */
+	bool inBand(size_t row, size_t col) const;
+
+	/**
+	 * @brief `(row, col)` is at `band(row, col - row + lower)`.
+	 */
+	Array2D band;
+	SizePair matrix_size{0, 0};
+	size_t lower{0};
+	size_t upper{0};
+};
+
+/**
+ * @brief Solvers for tridiagonal systems, using the Thomas algorithm.
+ * @detail Row `i` of a tridiagonal system reads
+ * 				lower[i] * x[i - 1] + diag[i] * x[i] + upper[i] * x[i + 1]
+ *
+ * 		...so `lower[0]` and `upper[n - 1]` are never used. Every coefficient
+ * 		array has all `n` entries anyway, which keeps the batched layout
+ * 		rectangular.
+ *
+ * 		The Thomas algorithm is Gaussian elimination without pivoting, so it
+ * 		is only guaranteed to be stable when the system is diagonally
+ * 		dominant (or symmetric positive-definite), as discretized ODEs and
+ * 		splines usually are. Use `BandMatrix::solve()` otherwise. Both
+ * 		functions throw an `std::runtime_error` if a pivot is exactly zero.
+ */
+namespace tridiagonal
+{
+
+/**
+ * @brief Solve one tridiagonal system for every column of `rhs`, and return
+ * 		the solutions.
+ */
+Matrix solve(const std::vector<double>& lower, const std::vector<double>& diag,
+			 const std::vector<double>& upper, const Matrix& rhs);
+
+/**
+ * @brief Solve many independent tridiagonal systems of the same size, in
+ * 		place.
+ * @detail Every argument is `n x count`, and column `s` of each one belongs
+ * 		to system `s`. Storing the systems side by side means each step of
+ * 		the elimination is a contiguous (and vectorizable) sweep across all
+ * 		of them. On return, `rhs` holds the solutions. Systems are split
+ * 		among threads by column.
+ */
+void solveBatch(const Array2D& lower, const Array2D& diag,
+				const Array2D& upper, Array2D& rhs);
+
+} // namespace tridiagonal
+
+#endif
@@ -0,0 +1,155 @@
+#include "Decompositions.hpp"
+
+#include <cmath>		// std::abs, std::sqrt
+#include <stdexcept>	// std::runtime_error
+#include <utility>		// std::swap
+
+using std::runtime_error;
+using std::vector;
+
+bool luFactor(Array2D& a, vector<size_t>& pivots)
+{
+	const size_t n = a.size().first;
+	if (n != a.size().second)
+	{
+		throw runtime_error{"Cannot LU-factor a non-square array!"};
+	}
+
+	double* lu = a.data();
+	pivots.assign(n, 0);
+
+	for (size_t k = 0; k != n; ++k)
+	{
+		// Pick the largest remaining entry in this column as the pivot.
+		size_t pivot_row = k;
+		double pivot_mag = std::abs(lu[k * n + k]);
+		for (size_t row = k + 1; row != n; ++row)
+		{
+			const double mag = std::abs(lu[row * n + k]);
+			if (mag > pivot_mag)
+			{
+				pivot_mag = mag;
+				pivot_row = row;
+			}
+		}
+		pivots[k] = pivot_row;
+		if (pivot_mag == 0.0) return false;
+
+		if (pivot_row != k)
+		{
+			for (size_t col = 0; col != n; ++col)
+			{
+				std::swap(lu[k * n + col], lu[pivot_row * n + col]);
+			}
+		}
+
+		const double inv_pivot = 1.0 / lu[k * n + k];
+		const double* pivot_vals = lu + k * n;
+		for (size_t row = k + 1; row != n; ++row)
+		{
+			double* row_vals = lu + row * n;
+			const double multiplier = row_vals[k] * inv_pivot;
+			row_vals[k] = multiplier;
+			for (size_t col = k + 1; col != n; ++col)
+			{
+				row_vals[col] -= multiplier * pivot_vals[col];
+			}
+		}
+	}
+
+	return true;
+}
+
+void luSolve(const Array2D& lu, const vector<size_t>& pivots, Array2D& b)
+{
+	const size_t n = lu.size().first;
+	const size_t num_rhs = b.size().second;
+	if (b.size().first != n)
+	{
+		throw runtime_error{"Right-hand side has the wrong number of rows!"};
+	}
+
+	const double* factors = lu.data();
+	double* x = b.data();
+
+	// Apply the row permutation, in the same order the factorization did.
+	for (size_t k = 0; k != n; ++k)
+	{
+		if (pivots[k] == k) continue;
+		for (size_t col = 0; col != num_rhs; ++col)
+		{
+			std::swap(x[k * num_rhs + col], x[pivots[k] * num_rhs + col]);
+		}
+	}
+
+	// Forward substitution with the unit-diagonal L.
+	for (size_t row = 1; row < n; ++row)
+	{
+		double* x_row = x + row * num_rhs;
+		for (size_t k = 0; k != row; ++k)
+		{
+			const double l = factors[row * n + k];
+			const double* x_k = x + k * num_rhs;
+			for (size_t col = 0; col != num_rhs; ++col)
+			{
+				x_row[col] -= l * x_k[col];
+			}
+		}
+	}
+
+	// Back substitution with U.
+	for (size_t row = n; row-- > 0;)
+	{
+		double* x_row = x + row * num_rhs;
+		for (size_t k = row + 1; k < n; ++k)
+		{
+			const double u = factors[row * n + k];
+			const double* x_k = x + k * num_rhs;
+			for (size_t col = 0; col != num_rhs; ++col)
+			{
+				x_row[col] -= u * x_k[col];
+			}
+		}
+		const double inv_diag = 1.0 / factors[row * n + row];
+		for (size_t col = 0; col != num_rhs; ++col)
+		{
+			x_row[col] *= inv_diag;
+		}
+	}
+}
+
+bool choleskyFactor(Array2D& a)
+{
+	const size_t n = a.size().first;
+	if (n != a.size().second)
+	{
+		throw runtime_error{"Cannot Cholesky-factor a non-square array!"};
+	}
+
+	double* l = a.data();
+	for (size_t row = 0; row != n; ++row)
+	{
+		double* l_row = l + row * n;
+		for (size_t col = 0; col <= row; ++col)
+		{
+			// Both rows are contiguous, so this is a dot product of the
+			// parts of them that have already been computed.
+			const double* l_col_row = l + col * n;
+			double value = l_row[col];
+			for (size_t k = 0; k != col; ++k) value -= l_row[k] * l_col_row[k];
+
+			if (col == row)
+			{
+				if (not (value > 0.0)) return false;
+				l_row[col] = std::sqrt(value);
+			}
+			else
+			{
+				l_row[col] = value / l_col_row[col];
+			}
+		}
+		for (size_t col = row + 1; col != n; ++col) l_row[col] = 0.0;
+	}
+
+	return true;
+}
@@ -0,0 +1,57 @@
+#ifndef MAAV_PROJECT_3_DECOMPOSITIONS_HPP
+#define MAAV_PROJECT_3_DECOMPOSITIONS_HPP
+
+#include "Array2D.hpp"
+
+#include <cstdlib>	// size_t
+#include <vector>	// std::vector
+
+/**
+ * @addtogroup DECOMPOSITIONS Matrix Decompositions
+ * @brief Factorizations shared by `Matrix::inverse()`, `Matrix::solve()`,
+ * 		and the rest of the library.
+ * @detail These work on square Array2D's and index from zero, since they
+ * 		sit underneath the one-indexed Matrix interface.
+ *
+ * 		They treat storage as row-major regardless of `layout()`, so given
+ * 		the column-major storage of `A`, they factor `A'` instead. Convert
+ * 		with `Array2D::toLayout()` first unless that's what you want.
+ * @{
+ */
+
+/**
+ * @brief Factor the square array `a` in place into `P * a = L * U`.
+ * @detail Uses Doolittle elimination with partial pivoting. Afterwards, the
+ * 		strictly-lower triangle of `a` holds `L` (whose diagonal is all ones
+ * 		and isn't stored) and the upper triangle holds `U`.
+ *
+ * 		`pivots[k]` is the row that was swapped with row `k` during the
+ * 		`k`th elimination step.
+ * @return False if `a` is singular, in which case `a` is left partially
+ * 		factored. True otherwise.
+ */
+bool luFactor(Array2D& a, std::vector<size_t>& pivots);
+
+/**
+ * @brief Overwrite `b` with the solution `x` of `A * x = b`.
+ * @param lu 		The output of a successful `luFactor` call on `A`.
+ * @param pivots 	The pivots produced by that same call.
+ * @param b 		The right-hand side(s), one per column.
+ */
+void luSolve(const Array2D& lu, const std::vector<size_t>& pivots, Array2D& b);
+
+/**
+ * @brief Factor the symmetric, positive-definite array `a` in place into
+ * 		`L * L'`.
+ * @detail Only the lower triangle of `a` is read. Afterwards, it holds `L`;
+ * 		the strictly-upper triangle is set to zero.
+ * @return False if `a` isn't positive-definite, in which case `a` is left
+ * 		partially factored. True otherwise.
+ */
+bool choleskyFactor(Array2D& a);
+
+/**
+ * @}
+ */
+
+#endif
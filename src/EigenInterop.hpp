@@ -0,0 +1,177 @@
+#ifndef MAAV_PROJECT_3_EIGEN_INTEROP_HPP
+#define MAAV_PROJECT_3_EIGEN_INTEROP_HPP
+
+#include "Array2D.hpp"
+#include "Matrix.hpp"
+
+#include <Eigen/Dense>
+
+#include <stdexcept>	// std::runtime_error
+
+/**
+ * @addtogroup EIGEN_INTEROP Eigen Interoperability
+ * @brief Zero-copy views of Array2D and Matrix storage as `Eigen::Map`s.
+ * @detail The maps alias the original storage: writing through a mutable
+ * 		map modifies the Array2D/Matrix, and no elements are copied in either
+ * 		direction. A map is invalidated by anything that reallocates its
+ * 		source (e.g. `Matrix::resize()` or assignment).
+ *
+ * 		Note that Eigen indexes from zero, even when viewing a Matrix.
+ *
+ * 		A map's storage order is part of its type, so `asEigen()` only
+ * 		accepts row-major storage and `asEigenColumnMajor()` only accepts
+ * 		column-major storage; both throw an `std::runtime_error` otherwise.
+ * 		Convert with `toLayout()` first if needed.
+ *
+ * 		Only available when CMake found Eigen3.
+ * @{
+ */
+
+/**
+ * @brief Eigen's name for a dynamically-sized, row-major matrix of doubles,
+ * 		which is the default memory layout of Array2D.
+ */
+using RowMajorMatrixXd =
+	Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+using EigenMap = Eigen::Map<RowMajorMatrixXd>;
+using ConstEigenMap = Eigen::Map<const RowMajorMatrixXd>;
+
+/**
+ * @brief Maps of column-major storage, which is Eigen's own default.
+ */
+using ColumnMajorEigenMap = Eigen::Map<Eigen::MatrixXd>;
+using ConstColumnMajorEigenMap = Eigen::Map<const Eigen::MatrixXd>;
+
+namespace eigen_interop_detail
+{
+
+inline void checkLayout(Layout actual, Layout expected)
+{
+	if (actual != expected)
+	{
+		throw std::runtime_error{expected == Layout::RowMajor
+			? "asEigen() needs row-major storage!"
+			: "asEigenColumnMajor() needs column-major storage!"};
+	}
+}
+
+} // namespace eigen_interop_detail
+
+/**
+ * @brief View the given Array2D as a mutable Eigen matrix.
+ */
+inline EigenMap asEigen(Array2D& array)
+{
+	eigen_interop_detail::checkLayout(array.layout(), Layout::RowMajor);
+	return EigenMap{array.data(),
+		static_cast<Eigen::Index>(array.size().first),
+		static_cast<Eigen::Index>(array.size().second)};
+}
+
+/**
+ * @brief View the given Array2D as a read-only Eigen matrix.
+ */
+inline ConstEigenMap asEigen(const Array2D& array)
+{
+	eigen_interop_detail::checkLayout(array.layout(), Layout::RowMajor);
+	return ConstEigenMap{array.data(),
+		static_cast<Eigen::Index>(array.size().first),
+		static_cast<Eigen::Index>(array.size().second)};
+}
+
+/**
+ * @brief View the given Matrix as a mutable Eigen matrix.
+ */
+inline EigenMap asEigen(Matrix& mat)
+{
+	eigen_interop_detail::checkLayout(mat.layout(), Layout::RowMajor);
+	return EigenMap{mat.data(),
+		static_cast<Eigen::Index>(mat.size().first),
+		static_cast<Eigen::Index>(mat.size().second)};
+}
+
+/**
+ * @brief View the given Matrix as a read-only Eigen matrix.
+ */
+inline ConstEigenMap asEigen(const Matrix& mat)
+{
+	eigen_interop_detail::checkLayout(mat.layout(), Layout::RowMajor);
+	return ConstEigenMap{mat.data(),
+		static_cast<Eigen::Index>(mat.size().first),
+		static_cast<Eigen::Index>(mat.size().second)};
+}
+
+/**
+ * @brief View the given column-major Array2D as a mutable Eigen matrix.
+ */
+inline ColumnMajorEigenMap asEigenColumnMajor(Array2D& array)
+{
+	eigen_interop_detail::checkLayout(array.layout(), Layout::ColumnMajor);
+	return ColumnMajorEigenMap{array.data(),
+		static_cast<Eigen::Index>(array.size().first),
+		static_cast<Eigen::Index>(array.size().second)};
+}
+
+/**
+ * @brief View the given column-major Array2D as a read-only Eigen matrix.
+ */
+inline ConstColumnMajorEigenMap asEigenColumnMajor(const Array2D& array)
+{
+	eigen_interop_detail::checkLayout(array.layout(), Layout::ColumnMajor);
+	return ConstColumnMajorEigenMap{array.data(),
+		static_cast<Eigen::Index>(array.size().first),
+		static_cast<Eigen::Index>(array.size().second)};
+}
+
+/**
+ * @brief View the given column-major Matrix as a mutable Eigen matrix.
+ */
+inline ColumnMajorEigenMap asEigenColumnMajor(Matrix& mat)
+{
+	eigen_interop_detail::checkLayout(mat.layout(), Layout::ColumnMajor);
+	return ColumnMajorEigenMap{mat.data(),
+		static_cast<Eigen::Index>(mat.size().first),
+		static_cast<Eigen::Index>(mat.size().second)};
+}
+
+/**
+ * @brief View the given column-major Matrix as a read-only Eigen matrix.
+ */
+inline ConstColumnMajorEigenMap asEigenColumnMajor(const Matrix& mat)
+{
+	eigen_interop_detail::checkLayout(mat.layout(), Layout::ColumnMajor);
+	return ConstColumnMajorEigenMap{mat.data(),
+		static_cast<Eigen::Index>(mat.size().first),
+		static_cast<Eigen::Index>(mat.size().second)};
+}
+
+/**
+ * @brief Copy the result of an Eigen expression into a new Matrix.
+ * @detail The expression is evaluated directly into the Matrix's storage,
+ * 		so no Eigen-owned temporary is created for plain expressions.
+ */
+template <typename Derived>
+Matrix toMatrix(const Eigen::MatrixBase<Derived>& expr,
+				Layout layout = Layout::RowMajor)
+{
+	Matrix out{static_cast<size_t>(expr.rows()),
+		static_cast<size_t>(expr.cols()), layout};
+	if (expr.size() == 0) return out;
+
+	if (layout == Layout::RowMajor)
+	{
+		asEigen(out) = expr;
+	}
+	else
+	{
+		asEigenColumnMajor(out) = expr;
+	}
+	return out;
+}
+
+/**
+ * @}
+ */
+
+#endif
@@ -0,0 +1,618 @@
+#include "Filtering.hpp"
+#include "Kernels.hpp"
+#include "Parallel.hpp"
+
+#include <algorithm>	// std::copy, std::fill, std::max, std::min,
+						// std::reverse_copy
+#include <cmath>		// std::ceil, std::exp, std::floor, std::sqrt
+#include <cstddef>		// ptrdiff_t
+#include <stdexcept>	// std::runtime_error
+#include <utility>		// std::make_pair, std::pair
+
+using filtering::Boundary;
+using filtering::Method;
+using std::runtime_error;
+using std::vector;
+
+namespace
+{
+
+/**
+ * @brief Each thread gets rows worth at least this many output pixels.
+ */
+constexpr size_t parallel_grain_pixels = 1 << 14;
+
+/**
+ * @brief Output rows are computed this many at a time, from a buffer of
+ * 		padded (or, for separable filters, half-filtered) input rows that's
+ * 		small enough to stay in cache.
+ */
+constexpr size_t block_rows = 32;
+
+/**
+ * @brief With `Method::Automatic`, banks of at least `im2col_min_kernels`
+ * 		kernels with at least `im2col_min_taps` taps each go through im2col.
+ * @detail The GEMM computes four kernels at a time, so fewer than that
+ * 		leaves it no faster than row AXPYs; and for small kernels, the work
+ * 		it saves is less than what it takes to drop the pixels between rows.
+ */
+constexpr size_t im2col_min_kernels = 4;
+constexpr size_t im2col_min_taps = 49;
+
+/**
+ * @brief Return the shape of `array`'s storage, viewed as a row-major array.
+ * @detail The storage of a column-major image is the row-major storage of
+ * 		its transpose, so everything below works on storage rows and swaps
+ * 		(or transposes) the kernels instead.
+ */
+std::pair<size_t, size_t> storageShape(const Array2D& array)
+{
+	const std::pair<size_t, size_t> size = array.size();
+	return array.layout() == Layout::RowMajor
+		? size
+		: std::make_pair(size.second, size.first);
+}
+
+/**
+ * @brief Return the number of rows to hand each thread, for rows of `cols`
+ * 		pixels.
+ */
+size_t rowGrain(size_t cols)
+{
+	return std::max<size_t>(1, parallel_grain_pixels / std::max<size_t>(1, cols));
+}
+
+void checkOdd(size_t length)
+{
+	if (length % 2 == 0)
+	{
+		throw runtime_error{"Filter kernels must have odd dimensions!"};
+	}
+}
+
+/**
+ * @brief Make `out` the same size and layout as `image`, reallocating it
+ * 		only if it isn't already. The contents are unspecified afterwards.
+ */
+void prepareOutput(const Array2D& image, Array2D& out)
+{
+	if (&out == &image)
+	{
+		throw runtime_error{"Filters can't write over their own input!"};
+	}
+	if (out.size() != image.size() or out.layout() != image.layout())
+	{
+		out = Array2D{image.size().first, image.size().second, image.layout()};
+	}
+}
+
+/**
+ * @brief Return the index of the pixel that stands in for index `i` (which
+ * 		may be out of bounds) along an axis of length `n`, or -1 if it's
+ * 		zero.
+ */
+ptrdiff_t sourceIndex(ptrdiff_t i, size_t length, Boundary boundary)
+{
+	const ptrdiff_t n = static_cast<ptrdiff_t>(length);
+	if (i >= 0 and i < n) return i;
+
+	switch (boundary)
+	{
+	case Boundary::Zero:
+		return -1;
+	case Boundary::Replicate:
+		return i < 0 ? 0 : n - 1;
+	case Boundary::Reflect:
+	{
+		if (n == 1) return 0;
+		const ptrdiff_t period = 2 * (n - 1);
+		i %= period;
+		if (i < 0) i += period;
+		return i < n ? i : period - i;
+	}
+	case Boundary::Wrap:
+		i %= n;
+		return i < 0 ? i + n : i;
+	}
+	return -1;
+}
+
+/**
+ * @brief Copy the `n` pixels of `row` into `out`, with `pad` pixels on
+ * 		either side of them filled in according to `boundary`.
+ */
+void padRow(const double* row, size_t n, size_t pad, Boundary boundary,
+			double* out)
+{
+	std::copy(row, row + n, out + pad);
+	for (size_t i = 0; i != 2 * pad; ++i)
+	{
+		const size_t col = i < pad ? i : n + i;
+		const ptrdiff_t source = sourceIndex(
+			static_cast<ptrdiff_t>(col) - static_cast<ptrdiff_t>(pad), n,
+			boundary);
+		out[col] = source < 0 ? 0.0 : row[source];
+	}
+}
+
+/**
+ * @brief Fill `out` with `count` padded rows of the `rows x cols` `image`,
+ * 		starting from row `first` (which may be out of bounds). Each padded
+ * 		row has `pad` extra pixels on either side.
+ */
+void padRows(const double* image, size_t rows, size_t cols, ptrdiff_t first,
+			 size_t count, size_t pad, Boundary boundary, double* out)
+{
+	const size_t padded_cols = cols + 2 * pad;
+	for (size_t i = 0; i != count; ++i)
+	{
+		double* out_row = out + i * padded_cols;
+		const ptrdiff_t source = sourceIndex(first + static_cast<ptrdiff_t>(i),
+											 rows, boundary);
+		if (source < 0)
+		{
+			std::fill(out_row, out_row + padded_cols, 0.0);
+		}
+		else
+		{
+			padRow(image + source * cols, cols, pad, boundary, out_row);
+		}
+	}
+}
+
+/**
+ * @brief A bank of kernels, laid out the way the image is stored and
+ * 		flipped, ready to be slid over the image.
+ */
+struct Taps
+{
+	Taps(const vector<Array2D>& kernels, Layout layout)
+	{
+		const std::pair<size_t, size_t> shape = storageShape(
+			kernels.front().toLayout(layout));
+		rows = shape.first;
+		cols = shape.second;
+
+		// Flipping both axes of row-major storage just reverses it.
+		const size_t num_taps = rows * cols;
+		weights = Array2D{kernels.size(), num_taps};
+		for (size_t f = 0; f != kernels.size(); ++f)
+		{
+			const Array2D same_layout = kernels[f].toLayout(layout);
+			std::reverse_copy(same_layout.data(),
+							  same_layout.data() + num_taps,
+							  weights.data() + f * num_taps);
+		}
+	}
+
+	/** @brief `num_kernels x (rows * cols)`, one kernel per row. */
+	Array2D weights;
+	size_t rows;
+	size_t cols;
+};
+
+/**
+ * @brief Convolve the `rows x cols` `image` with each kernel in `taps`,
+ * 		one output row at a time, writing into `out`.
+ * @detail Each output pixel is stored once, however many taps there are;
+ * 		see `KernelTable::correlateRows`.
+ */
+void convolveDirect(const double* image, size_t rows, size_t cols,
+					const Taps& taps, Boundary boundary,
+					const vector<double*>& out)
+{
+	const kernels::KernelTable& kernel = kernels::active();
+	const size_t pad = taps.cols / 2;
+	const size_t padded_cols = cols + 2 * pad;
+	const size_t num_taps = taps.rows * taps.cols;
+
+	parallel::forRange(0, rows, rowGrain(cols * out.size()),
+		[&](size_t first, size_t last) {
+			vector<double> padded((block_rows + taps.rows - 1) * padded_cols);
+			for (size_t block = first; block < last; block += block_rows)
+			{
+				const size_t block_end = std::min(last, block + block_rows);
+				padRows(image, rows, cols,
+						static_cast<ptrdiff_t>(block)
+							- static_cast<ptrdiff_t>(taps.rows / 2),
+						block_end - block + taps.rows - 1, pad, boundary,
+						padded.data());
+
+				for (size_t f = 0; f != out.size(); ++f)
+				{
+					kernel.correlateRows(block_end - block, cols, taps.rows,
+						taps.cols, taps.weights.data() + f * num_taps,
+						padded.data(), padded_cols, out[f] + block * cols, cols);
+				}
+			}
+		});
+}
+
+/**
+ * @brief The same as `convolveDirect()`, as a GEMM per kernel row.
+ * @detail Take a block of padded input rows as one long row of pixels, `p`.
+ * 		The im2col matrix for row `i` of the kernels has `p` shifted left by
+ * 		`j` pixels as its row `j`, so it's just `p` itself with a leading
+ * 		dimension of one, and nothing has to be copied into it. Multiplying
+ * 		it by row `i` of every kernel, and summing over `i`, filters every
+ * 		pixel of the block by every kernel at once. (The pixels that straddle
+ * 		two rows are computed too, and then dropped.)
+ *
+ * 		Every pixel the GEMM loads feeds a multiply-add for several kernels,
+ * 		where `convolveDirect()` loads it once per kernel.
+ */
+void convolveIm2col(const double* image, size_t rows, size_t cols,
+					const Taps& taps, Boundary boundary,
+					const vector<double*>& out)
+{
+	const kernels::KernelTable& kernel = kernels::active();
+	const size_t pad = taps.cols / 2;
+	const size_t padded_cols = cols + 2 * pad;
+	const size_t num_kernels = out.size();
+	const size_t num_taps = taps.rows * taps.cols;
+
+	parallel::forRange(0, rows, rowGrain(cols * num_kernels),
+		[&](size_t first, size_t last) {
+			vector<double> padded((block_rows + taps.rows - 1) * padded_cols);
+			vector<double> product(num_kernels * block_rows * padded_cols);
+
+			for (size_t block = first; block < last; block += block_rows)
+			{
+				const size_t block_end = std::min(last, block + block_rows);
+				padRows(image, rows, cols,
+						static_cast<ptrdiff_t>(block)
+							- static_cast<ptrdiff_t>(taps.rows / 2),
+						block_end - block + taps.rows - 1, pad, boundary,
+						padded.data());
+
+				// Stop short of the padding after the last row, so that the
+				// rightmost tap doesn't read past the end of `padded`.
+				const size_t pixels = (block_end - block) * padded_cols - 2 * pad;
+				std::fill(product.begin(), product.begin() + num_kernels * pixels,
+						  0.0);
+				for (size_t i = 0; i != taps.rows; ++i)
+				{
+					kernel.gemm(num_kernels, pixels, taps.cols, 1.0,
+								taps.weights.data() + i * taps.cols, num_taps,
+								padded.data() + i * padded_cols, 1,
+								product.data(), pixels);
+				}
+
+				for (size_t f = 0; f != num_kernels; ++f)
+				{
+					for (size_t row = block; row != block_end; ++row)
+					{
+						const double* src = product.data() + f * pixels
+							+ (row - block) * padded_cols;
+						std::copy(src, src + cols, out[f] + row * cols);
+					}
+				}
+			}
+		});
+}
+
+/**
+ * @brief Filter `image` with a box of `2 * radius + 1` pixels plus, just
+ * 		outside it on each side, one pixel weighted by `edge_weight`, in
+ * 		both directions. The weights are normalized to sum to one.
+ * @detail An edge weight of zero is a plain box filter. Anything between
+ * 		zero and one gives a variance between those of two plain boxes,
+ * 		which is what lets `gaussianBlur()` hit any sigma exactly.
+ *
+ * 		The sums over each box are kept as running sums, first down the
+ * 		columns (a row AXPY for each row entering or leaving the box) and
+ * 		then along the rows.
+ */
+void extendedBoxFilter(const Array2D& image, size_t radius, double edge_weight,
+					   Array2D& out, Boundary boundary)
+{
+	prepareOutput(image, out);
+
+	const std::pair<size_t, size_t> shape = storageShape(image);
+	const size_t rows = shape.first;
+	const size_t cols = shape.second;
+	if (rows == 0 or cols == 0) return;
+
+	const kernels::KernelTable& kernel = kernels::active();
+	const double* in = image.data();
+	double* result = out.data();
+	const ptrdiff_t signed_radius = static_cast<ptrdiff_t>(radius);
+	const size_t width = 2 * radius + 1;
+	const double total_weight = width + 2.0 * edge_weight;
+	const double scale = 1.0 / (total_weight * total_weight);
+
+	const auto inputRow = [&](ptrdiff_t row) -> const double* {
+		const ptrdiff_t source = sourceIndex(row, rows, boundary);
+		return source < 0 ? nullptr : in + source * cols;
+	};
+
+	parallel::forRange(0, rows, rowGrain(cols), [&](size_t first, size_t last) {
+		// The sum of each column over the box's rows. Each thread adds up its
+		// first box from scratch, and slides it down from there by adding
+		// the row that enters it and subtracting the row that leaves it.
+		vector<double> box_sums(cols, 0.0);
+		vector<double> column_sums(cols);
+		const ptrdiff_t top = static_cast<ptrdiff_t>(first);
+		for (ptrdiff_t i = top - signed_radius; i <= top + signed_radius; ++i)
+		{
+			const double* row = inputRow(i);
+			if (row) kernel.add(cols, box_sums.data(), row, box_sums.data());
+		}
+
+		// The edges of the box are `radius + 1` pixels from its center.
+		vector<double> padded(cols + 2 * radius + 2);
+		for (size_t row = first; row != last; ++row)
+		{
+			const ptrdiff_t center = static_cast<ptrdiff_t>(row);
+			if (row != first)
+			{
+				const double* entering = inputRow(center + signed_radius);
+				const double* leaving = inputRow(center - signed_radius - 1);
+				if (entering)
+				{
+					kernel.add(cols, box_sums.data(), entering, box_sums.data());
+				}
+				if (leaving)
+				{
+					kernel.subtract(cols, box_sums.data(), leaving,
+									box_sums.data());
+				}
+			}
+
+			const double* sums = box_sums.data();
+			if (edge_weight != 0.0)
+			{
+				std::copy(box_sums.begin(), box_sums.end(), column_sums.begin());
+				for (ptrdiff_t edge : {center - signed_radius - 1,
+									   center + signed_radius + 1})
+				{
+					const double* edge_row = inputRow(edge);
+					if (edge_row)
+					{
+						kernel.axpy(cols, edge_weight, edge_row,
+									column_sums.data());
+					}
+				}
+				sums = column_sums.data();
+			}
+
+			// Then slide the box along the column sums.
+			padRow(sums, cols, radius + 1, boundary, padded.data());
+			double* out_row = result + row * cols;
+			double sum = 0.0;
+			for (size_t j = 1; j <= width; ++j) sum += padded[j];
+			for (size_t col = 0; col != cols; ++col)
+			{
+				if (col != 0) sum += padded[col + width] - padded[col];
+				const double edges = padded[col] + padded[col + width + 1];
+				out_row[col] = (sum + edge_weight * edges) * scale;
+			}
+		}
+	});
+}
+
+} // anonymous namespace
+
+namespace filtering
+{
+
+Array2D convolve(const Array2D& image, const Array2D& kernel,
+				 Boundary boundary, Method method)
+{
+	Array2D result;
+	convolve(image, kernel, result, boundary, method);
+	return result;
+}
+
+void convolve(const Array2D& image, const Array2D& kernel, Array2D& out,
+			  Boundary boundary, Method method)
+{
+	checkOdd(kernel.size().first);
+	checkOdd(kernel.size().second);
+	prepareOutput(image, out);
+
+	const std::pair<size_t, size_t> shape = storageShape(image);
+	if (shape.first == 0 or shape.second == 0) return;
+
+	const Taps taps{vector<Array2D>{kernel}, image.layout()};
+	const vector<double*> outputs{out.data()};
+	if (method == Method::Im2col)
+	{
+		convolveIm2col(image.data(), shape.first, shape.second, taps,
+					   boundary, outputs);
+	}
+	else
+	{
+		convolveDirect(image.data(), shape.first, shape.second, taps,
+					   boundary, outputs);
+	}
+}
+
+vector<Array2D> convolve(const Array2D& image, const vector<Array2D>& kernels,
+						 Boundary boundary, Method method)
+{
+	if (kernels.empty()) return {};
+
+	for (const Array2D& kernel : kernels)
+	{
+		if (kernel.size() != kernels.front().size())
+		{
+			throw runtime_error{"Filter kernels must all be the same size!"};
+		}
+	}
+	checkOdd(kernels.front().size().first);
+	checkOdd(kernels.front().size().second);
+
+	vector<Array2D> results(kernels.size());
+	vector<double*> outputs;
+	for (Array2D& result : results)
+	{
+		prepareOutput(image, result);
+		outputs.push_back(result.data());
+	}
+
+	const std::pair<size_t, size_t> shape = storageShape(image);
+	if (shape.first == 0 or shape.second == 0) return results;
+
+	const Taps taps{kernels, image.layout()};
+	if (method == Method::Im2col or (method == Method::Automatic
+		and kernels.size() >= im2col_min_kernels
+		and taps.rows * taps.cols >= im2col_min_taps))
+	{
+		convolveIm2col(image.data(), shape.first, shape.second, taps,
+					   boundary, outputs);
+	}
+	else
+	{
+		convolveDirect(image.data(), shape.first, shape.second, taps,
+					   boundary, outputs);
+	}
+	return results;
+}
+
+Array2D separableConvolve(const Array2D& image,
+						  const vector<double>& row_kernel,
+						  const vector<double>& col_kernel,
+						  Boundary boundary)
+{
+	Array2D result;
+	separableConvolve(image, row_kernel, col_kernel, result, boundary);
+	return result;
+}
+
+void separableConvolve(const Array2D& image, const vector<double>& row_kernel,
+					   const vector<double>& col_kernel, Array2D& out,
+					   Boundary boundary)
+{
+	checkOdd(row_kernel.size());
+	checkOdd(col_kernel.size());
+	prepareOutput(image, out);
+
+	const std::pair<size_t, size_t> shape = storageShape(image);
+	const size_t rows = shape.first;
+	const size_t cols = shape.second;
+	if (rows == 0 or cols == 0) return;
+
+	// Storage rows run down the image's columns if it's column-major.
+	const bool row_major = image.layout() == Layout::RowMajor;
+	const vector<double>& across = row_major ? row_kernel : col_kernel;
+	const vector<double>& down = row_major ? col_kernel : row_kernel;
+	const size_t across_radius = across.size() / 2;
+	const size_t down_radius = down.size() / 2;
+
+	// `correlateRows()` slides the kernels along unflipped.
+	const vector<double> across_taps(across.rbegin(), across.rend());
+	const vector<double> down_taps(down.rbegin(), down.rend());
+
+	const kernels::KernelTable& kernel = kernels::active();
+	const double* in = image.data();
+	double* result = out.data();
+
+	parallel::forRange(0, rows, rowGrain(cols), [&](size_t first, size_t last) {
+		vector<double> padded(cols + 2 * across_radius);
+		vector<double> horizontal((block_rows + down.size() - 1) * cols);
+
+		for (size_t block = first; block < last; block += block_rows)
+		{
+			const size_t block_end = std::min(last, block + block_rows);
+
+			// Filter across every input row that this block of output rows
+			// reads, including any past the top and bottom edges...
+			for (size_t i = 0; i != block_end - block + down.size() - 1; ++i)
+			{
+				double* h_row = horizontal.data() + i * cols;
+				const ptrdiff_t source = sourceIndex(
+					static_cast<ptrdiff_t>(block + i)
+						- static_cast<ptrdiff_t>(down_radius),
+					rows, boundary);
+				if (source < 0)
+				{
+					std::fill(h_row, h_row + cols, 0.0);
+					continue;
+				}
+
+				padRow(in + source * cols, cols, across_radius, boundary,
+					   padded.data());
+				kernel.correlateRows(1, cols, 1, across_taps.size(),
+									 across_taps.data(), padded.data(),
+									 padded.size(), h_row, cols);
+			}
+
+			// ...and then down them.
+			kernel.correlateRows(block_end - block, cols, down_taps.size(), 1,
+								 down_taps.data(), horizontal.data(), cols,
+								 result + block * cols, cols);
+		}
+	});
+}
+
+Array2D boxFilter(const Array2D& image, size_t radius, Boundary boundary)
+{
+	Array2D result;
+	boxFilter(image, radius, result, boundary);
+	return result;
+}
+
+void boxFilter(const Array2D& image, size_t radius, Array2D& out,
+			   Boundary boundary)
+{
+	extendedBoxFilter(image, radius, 0.0, out, boundary);
+}
+
+Array2D gaussianBlur(const Array2D& image, double sigma, Boundary boundary)
+{
+	Array2D result;
+	gaussianBlur(image, sigma, result, boundary);
+	return result;
+}
+
+void gaussianBlur(const Array2D& image, double sigma, Array2D& out,
+				  Boundary boundary)
+{
+	if (not (sigma >= 0.0))
+	{
+		throw runtime_error{"Gaussian sigma must be non-negative!"};
+	}
+
+	// Repeated box filters converge on a Gaussian, and their variances add
+	// up. Three passes of the widest plain box whose variance is at most a
+	// third of `sigma^2`, extended by just enough weight on either side to
+	// make up the rest, give exactly the requested variance; see Gwosdek
+	// et al., "Theoretical Foundations of Gaussian Convolution by Extended
+	// Box Filtering".
+	const double passes = 3.0;
+	const double variance = sigma * sigma / passes;
+	const size_t radius = static_cast<size_t>(
+		std::floor(0.5 * std::sqrt(12.0 * variance + 1.0) - 0.5));
+	const double r = static_cast<double>(radius);
+	const double edge_weight = (2.0 * r + 1.0) * (r * (r + 1.0) - 3.0 * variance)
+		/ (6.0 * (variance - (r + 1.0) * (r + 1.0)));
+
+	Array2D scratch;
+	extendedBoxFilter(image, radius, edge_weight, out, boundary);
+	extendedBoxFilter(out, radius, edge_weight, scratch, boundary);
+	extendedBoxFilter(scratch, radius, edge_weight, out, boundary);
+}
+
+vector<double> gaussianKernel(double sigma)
+{
+	if (not (sigma >= 0.0))
+	{
+		throw runtime_error{"Gaussian sigma must be non-negative!"};
+	}
+	if (sigma == 0.0) return {1.0};
+
+	const size_t radius = static_cast<size_t>(std::ceil(3.0 * sigma));
+	vector<double> weights(2 * radius + 1);
+	double total = 0.0;
+	for (size_t i = 0; i != weights.size(); ++i)
+	{
+		const double x = static_cast<double>(i) - static_cast<double>(radius);
+		weights[i] = std::exp(-x * x / (2.0 * sigma * sigma));
+		total += weights[i];
+	}
+	for (double& weight : weights) weight /= total;
+	return weights;
+}
+
+} // namespace filtering
@@ -0,0 +1,151 @@
+#ifndef MAAV_PROJECT_3_FILTERING_HPP
+#define MAAV_PROJECT_3_FILTERING_HPP
+
+#include "Array2D.hpp"
+
+#include <cstdlib>	// size_t
+#include <vector>	// std::vector
+
+/**
+ * @brief Convolutions and smoothing filters for images and depth maps
+ * 		stored in Array2Ds.
+ * @detail Every filter returns a new Array2D with the same size and layout
+ * 		as its input (a "same" convolution), and reads pixels past the edges
+ * 		of the image according to a `Boundary` mode.
+ *
+ * 		Output rows are computed with the SIMD kernels in `Kernels.hpp`, which
+ * 		apply every tap of a filter in one register-blocked pass, a block of
+ * 		rows at a time from padded copies of the input rows that stay in
+ * 		cache. Blocks
+ * 		are split among threads with `parallel::forRange()`. Column-major
+ * 		images are filtered in their own layout, with the kernel transposed
+ * 		instead.
+ *
+ * 		Each filter also comes in a form that writes into a caller-provided
+ * 		`out`, which is only reallocated if it doesn't already have the
+ * 		input's size and layout. Reusing `out` from frame to frame avoids
+ * 		allocating (and zeroing) a new image every time. `out` mustn't be
+ * 		the same Array2D as `image`.
+ *
+ * 		These are true convolutions, i.e. the kernel is flipped; that only
+ * 		matters for kernels that aren't symmetric. Kernels must have an odd
+ * 		number of rows and columns, so that they have a center pixel, or an
+ * 		`std::runtime_error` is thrown.
+ */
+namespace filtering
+{
+
+/**
+ * @brief How pixels past the edges of an image are filled in.
+ */
+enum class Boundary
+{
+	/** @brief With zeroes: `000|abcd|000` */
+	Zero,
+
+	/** @brief With the nearest edge pixel: `aaa|abcd|ddd` */
+	Replicate,
+
+	/** @brief By mirroring about the edge pixel: `dcb|abcd|cba` */
+	Reflect,
+
+	/** @brief By wrapping around to the other edge: `bcd|abcd|abc` */
+	Wrap
+};
+
+/**
+ * @brief How `convolve()` computes a general 2D convolution.
+ */
+enum class Method
+{
+	/** @brief Pick whichever of the two below should be faster. */
+	Automatic,
+
+	/**
+	 * @brief Apply all of a kernel's taps in one pass over each output row.
+	 * 		Best for a single kernel of any size, and for banks of small
+	 * 		kernels.
+	 */
+	Direct,
+
+	/**
+	 * @brief Multiply the image patches under the kernel ("im2col") by the
+	 * 		kernels with the library GEMM. The patch matrix is a view of the
+	 * 		padded image, so nothing is copied into it. Best for banks of
+	 * 		several large kernels.
+	 */
+	Im2col
+};
+
+/**
+ * @brief Convolve `image` with `kernel`.
+ */
+Array2D convolve(const Array2D& image, const Array2D& kernel,
+				 Boundary boundary = Boundary::Reflect,
+				 Method method = Method::Automatic);
+void convolve(const Array2D& image, const Array2D& kernel, Array2D& out,
+			  Boundary boundary = Boundary::Reflect,
+			  Method method = Method::Automatic);
+
+/**
+ * @brief Convolve `image` with each of `kernels`, which must all be the same
+ * 		size.
+ * @detail Cheaper than convolving with each kernel in turn, since each
+ * 		block of the image is padded only once, and `Method::Im2col` can
+ * 		reuse each pixel it loads for several kernels.
+ */
+std::vector<Array2D> convolve(const Array2D& image,
+							  const std::vector<Array2D>& kernels,
+							  Boundary boundary = Boundary::Reflect,
+							  Method method = Method::Automatic);
+
+/**
+ * @brief Convolve `image` with the separable kernel
+ * 		`K(i, j) = col_kernel[i] * row_kernel[j]`.
+ * @detail `row_kernel` runs along each row, and `col_kernel` down each
+ * 		column. Costs `row_kernel.size() + col_kernel.size()` multiply-adds
+ * 		per pixel, rather than their product.
+ */
+Array2D separableConvolve(const Array2D& image,
+						  const std::vector<double>& row_kernel,
+						  const std::vector<double>& col_kernel,
+						  Boundary boundary = Boundary::Reflect);
+void separableConvolve(const Array2D& image,
+					   const std::vector<double>& row_kernel,
+					   const std::vector<double>& col_kernel, Array2D& out,
+					   Boundary boundary = Boundary::Reflect);
+
+/**
+ * @brief Replace each pixel with the mean of the `(2 * radius + 1)`-pixel
+ * 		square around it.
+ * @detail Uses running sums, so the cost doesn't depend on `radius`. The
+ * 		result matches `convolve()` with a uniform kernel up to rounding.
+ */
+Array2D boxFilter(const Array2D& image, size_t radius,
+				  Boundary boundary = Boundary::Reflect);
+void boxFilter(const Array2D& image, size_t radius, Array2D& out,
+			   Boundary boundary = Boundary::Reflect);
+
+/**
+ * @brief Blur `image` with a Gaussian of standard deviation `sigma` pixels.
+ * @detail Approximates the Gaussian with three box filters in a row, so the
+ * 		cost doesn't depend on `sigma`. The result has exactly the right
+ * 		variance, but the shape is only close to a Gaussian's; for an exact
+ * 		one, pass `gaussianKernel(sigma)` to `separableConvolve()`.
+ *
+ * 		The form that takes `out` still allocates one image-sized temporary.
+ */
+Array2D gaussianBlur(const Array2D& image, double sigma,
+					 Boundary boundary = Boundary::Reflect);
+void gaussianBlur(const Array2D& image, double sigma, Array2D& out,
+				  Boundary boundary = Boundary::Reflect);
+
+/**
+ * @brief Return a normalized, one-dimensional Gaussian kernel with standard
+ * 		deviation `sigma`, truncated at three standard deviations.
+ */
+std::vector<double> gaussianKernel(double sigma);
+
+} // namespace filtering
+
+#endif
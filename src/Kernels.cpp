@@ -0,0 +1,197 @@
+#include "Kernels.hpp"
+
+#include <atomic>		// std::atomic
+#include <cstdlib>		// std::getenv
+#include <cstring>		// std::strcmp
+#include <stdexcept>	// std::runtime_error
+#include <string>		// std::string
+
+using std::runtime_error;
+
+namespace
+{
+
+constexpr int num_isas = 3;
+
+/**
+ * @brief The instruction set chosen with `forceIsa()`, or -1 if none.
+ */
+std::atomic<int> forced_isa{-1};
+
+int indexOf(kernels::Isa isa)
+{
+	return static_cast<int>(isa);
+}
+
+bool cpuSupports(kernels::Isa isa)
+{
+	using kernels::Isa;
+#if defined(__x86_64__) || defined(__i386__)
+	switch (isa)
+	{
+		case Isa::Sse2:
+			return true;
+		case Isa::Avx2:
+			return __builtin_cpu_supports("avx2")
+				and __builtin_cpu_supports("fma");
+		case Isa::Avx512:
+			return __builtin_cpu_supports("avx512f")
+				and __builtin_cpu_supports("avx2")
+				and __builtin_cpu_supports("fma");
+	}
+	return false;
+#else
+	return isa == Isa::Sse2;
+#endif
+}
+
+bool built(kernels::Isa isa)
+{
+	using kernels::Isa;
+	switch (isa)
+	{
+		case Isa::Sse2:
+			return true;
+		case Isa::Avx2:
+#if defined(MLE_HAVE_AVX2_KERNELS)
+			return true;
+#else
+			return false;
+#endif
+		case Isa::Avx512:
+#if defined(MLE_HAVE_AVX512_KERNELS)
+			return true;
+#else
+			return false;
+#endif
+	}
+	return false;
+}
+
+/**
+ * @brief Return every kernel table, indexed by `Isa`.
+ * @detail Variants that weren't built fall back to the baseline kernels;
+ * 		`isSupported()` keeps anyone from selecting them.
+ */
+const kernels::KernelTable* allTables()
+{
+	using namespace kernels;
+	static const KernelTable tables[num_isas] = {
+		sse2::makeTable(),
+#if defined(MLE_HAVE_AVX2_KERNELS)
+		avx2::makeTable(),
+#else
+		sse2::makeTable(),
+#endif
+#if defined(MLE_HAVE_AVX512_KERNELS)
+		avx512::makeTable(),
+#else
+		sse2::makeTable(),
+#endif
+	};
+	return tables;
+}
+
+/**
+ * @brief Parse the `MLE_FORCE_ISA` environment variable.
+ * @return The requested instruction set's index, or -1 if it isn't set.
+ */
+int isaFromEnvironment()
+{
+	const char* requested = std::getenv("MLE_FORCE_ISA");
+	if (requested == nullptr or *requested == '\0') return -1;
+
+	for (int i = 0; i != num_isas; ++i)
+	{
+		const auto isa = static_cast<kernels::Isa>(i);
+		if (std::strcmp(requested, kernels::isaName(isa)) != 0) continue;
+
+		if (not kernels::isSupported(isa))
+		{
+			throw runtime_error{std::string{"MLE_FORCE_ISA="} + requested
+				+ " is not supported on this machine!"};
+		}
+		return i;
+	}
+	throw runtime_error{std::string{"Unknown MLE_FORCE_ISA value: "}
+		+ requested};
+}
+
+/**
+ * @brief Return the instruction set to use when `forceIsa()` isn't active.
+ */
+kernels::Isa automaticIsa()
+{
+	static const kernels::Isa chosen = []{
+		const int from_env = isaFromEnvironment();
+		return from_env >= 0 ? static_cast<kernels::Isa>(from_env)
+			: kernels::bestSupportedIsa();
+	}();
+	return chosen;
+}
+
+} // anonymous namespace
+
+namespace kernels
+{
+
+const KernelTable& active()
+{
+	return allTables()[indexOf(activeIsa())];
+}
+
+const KernelTable& table(Isa isa)
+{
+	if (not isSupported(isa))
+	{
+		throw runtime_error{std::string{"Kernels for "} + isaName(isa)
+			+ " are not supported on this machine!"};
+	}
+	return allTables()[indexOf(isa)];
+}
+
+Isa activeIsa()
+{
+	const int forced = forced_isa.load(std::memory_order_acquire);
+	return forced >= 0 ? static_cast<Isa>(forced) : automaticIsa();
+}
+
+Isa bestSupportedIsa()
+{
+	if (isSupported(Isa::Avx512)) return Isa::Avx512;
+	if (isSupported(Isa::Avx2)) return Isa::Avx2;
+	return Isa::Sse2;
+}
+
+bool isSupported(Isa isa)
+{
+	return built(isa) and cpuSupports(isa);
+}
+
+void forceIsa(Isa isa)
+{
+	if (not isSupported(isa))
+	{
+		throw runtime_error{std::string{"Kernels for "} + isaName(isa)
+			+ " are not supported on this machine!"};
+	}
+	forced_isa.store(indexOf(isa), std::memory_order_release);
+}
+
+void resetIsa()
+{
+	forced_isa.store(-1, std::memory_order_release);
+}
+
+const char* isaName(Isa isa)
+{
+	switch (isa)
+	{
+		case Isa::Sse2:		return "sse2";
+		case Isa::Avx2:		return "avx2";
+		case Isa::Avx512:	return "avx512";
+	}
+	return "unknown";
+}
+
+} // namespace kernels
@@ -0,0 +1,200 @@
+#ifndef MAAV_PROJECT_3_KERNELS_HPP
+#define MAAV_PROJECT_3_KERNELS_HPP
+
+#include <cstdlib>	// size_t
+
+/**
+ * @brief The library's hot loops, built once per instruction set.
+ * @detail We ship one binary to machines with different CPUs, so we can't
+ * 		just compile everything with `-march=native`. Instead, each kernel is
+ * 		compiled several times (see `KernelsImpl.hpp`), once per supported
+ * 		instruction set, and the best variant that the running CPU supports
+ * 		is picked the first time a kernel is used.
+ *
+ * 		The selection can be overridden by setting the `MLE_FORCE_ISA`
+ * 		environment variable to `sse2`, `avx2`, or `avx512` before the first
+ * 		kernel call, or by calling `forceIsa()` at runtime.
+ *
+ * 		All arrays are row-major and indexed from zero. `ld*` arguments are
+ * 		"leading dimensions," i.e. the distance between the starts of two
+ * 		consecutive rows, which lets the kernels work on sub-blocks.
+ */
+namespace kernels
+{
+
+/**
+ * @brief The instruction sets for which kernels are built.
+ * @detail `Sse2` is the x86-64 baseline, and is always supported.
+ */
+enum class Isa
+{
+	Sse2,
+	Avx2,
+	Avx512
+};
+
+/**
+ * @brief One complete set of kernels, all built for the same instruction set.
+ */
+struct KernelTable
+{
+	/** @brief `out[i] = a[i] + b[i]` */
+	void (*add)(size_t n, const double* a, const double* b, double* out);
+
+	/** @brief `out[i] = a[i] - b[i]` */
+	void (*subtract)(size_t n, const double* a, const double* b, double* out);
+
+	/** @brief `out[i] = a[i] * b[i]` */
+	void (*multiply)(size_t n, const double* a, const double* b, double* out);
+
+	/** @brief `out[i] = a[i] / b[i]` */
+	void (*divide)(size_t n, const double* a, const double* b, double* out);
+
+	/** @brief `out[i] = alpha * a[i]` */
+	void (*scale)(size_t n, double alpha, const double* a, double* out);
+
+	/** @brief `y[i] += alpha * x[i]` */
+	void (*axpy)(size_t n, double alpha, const double* x, double* y);
+
+	/**
+	 * @brief `C += alpha * A * B`, where `A` is `m x k` and `B` is `k x n`.
+	 */
+	void (*gemm)(size_t m, size_t n, size_t k, double alpha,
+				 const double* a, size_t lda,
+				 const double* b, size_t ldb,
+				 double* c, size_t ldc);
+
+	/**
+	 * @brief `y += alpha * A * x`, where `A` is `m x n`.
+	 */
+	void (*gemv)(size_t m, size_t n, double alpha,
+				 const double* a, size_t lda,
+				 const double* x, double* y);
+
+	/**
+	 * @brief `y += alpha * A' * x`, where `A` is `m x n` (so `x` has `m`
+	 * 		elements and `y` has `n`).
+	 * @detail Reads `A` row by row, so this costs the same as `gemv()`
+	 * 		rather than a transpose plus a `gemv()`.
+	 */
+	void (*gemvTransposed)(size_t m, size_t n, double alpha,
+						   const double* a, size_t lda,
+						   const double* x, double* y);
+
+	/**
+	 * @brief Write the transpose of the `rows x cols` array `in` into `out`.
+	 */
+	void (*transpose)(size_t rows, size_t cols,
+					  const double* in, size_t ld_in,
+					  double* out, size_t ld_out);
+
+	/**
+	 * @brief A small 2D correlation: for each output row `r` in
+	 * 		`[0, num_out)` and `j` in `[0, n)`,
+	 * 				out[r * ld_out + j] = sum(weights[i * cols + t]
+	 * 										  * in[(r + i) * ld_in + j + t])
+	 *
+	 * 		...over the `rows x cols` taps.
+	 * @detail Every tap is applied in one pass, so each output is stored
+	 * 		once, and two output rows are computed together, so that each
+	 * 		input load feeds both. `in` has `num_out + rows - 1` rows, each
+	 * 		`n + cols - 1` long.
+	 */
+	void (*correlateRows)(size_t num_out, size_t n, size_t rows, size_t cols,
+						  const double* weights,
+						  const double* in, size_t ld_in,
+						  double* out, size_t ld_out);
+
+	/** @brief Return the sum of `a[0..n)`, using compensated summation. */
+	double (*sum)(size_t n, const double* a);
+
+	/** @brief Return the dot product of `a[0..n)` and `b[0..n)`. */
+	double (*dot)(size_t n, const double* a, const double* b);
+
+	/** @brief Return the sum of the absolute values of `a[0..n)`. */
+	double (*sumAbs)(size_t n, const double* a);
+
+	/** @brief `acc[i] += |a[i]|` */
+	void (*addAbs)(size_t n, const double* a, double* acc);
+
+	/**
+	 * @brief Store the smallest and largest of `a[0..n)` in `min` and `max`.
+	 * @detail `n` must be nonzero. If any element is NaN, both are NaN.
+	 */
+	void (*minMax)(size_t n, const double* a, double* min, double* max);
+
+	/**
+	 * @brief Return the index of the first `i` for which
+	 * 		`|a[i] - b[i]| <= max(abs_tol, rel_tol * max(|a[i]|, |b[i]|))`
+	 * 		does *not* hold, or `n` if there is none.
+	 * @detail NaNs never compare equal. Stops at the first register that
+	 * 		contains a mismatch.
+	 */
+	size_t (*firstMismatch)(size_t n, const double* a, const double* b,
+							double abs_tol, double rel_tol);
+};
+
+/**
+ * @brief Return the kernels for the currently selected instruction set.
+ * @detail Selects the best supported instruction set on first use.
+ */
+const KernelTable& active();
+
+/**
+ * @brief Return the kernels built for a specific instruction set.
+ * @detail Throws an `std::runtime_error` if the running CPU doesn't
+ * 		support it, or if this build doesn't include it.
+ */
+const KernelTable& table(Isa isa);
+
+/**
+ * @brief Return the currently selected instruction set.
+ */
+Isa activeIsa();
+
+/**
+ * @brief Return the best instruction set that the running CPU supports.
+ */
+Isa bestSupportedIsa();
+
+/**
+ * @brief Return true if kernels for `isa` were built and the running CPU
+ * 		can execute them.
+ */
+bool isSupported(Isa isa);
+
+/**
+ * @brief Use the kernels for `isa` from now on.
+ * @detail Throws an `std::runtime_error` if `isa` isn't supported. Meant
+ * 		for tests and benchmarks; don't call this while another thread is
+ * 		running kernels.
+ */
+void forceIsa(Isa isa);
+
+/**
+ * @brief Undo `forceIsa()` and go back to the automatically-selected
+ * 		instruction set (or the one named by `MLE_FORCE_ISA`).
+ */
+void resetIsa();
+
+/**
+ * @brief Return the lowercase name of `isa`, e.g. `"avx2"`.
+ */
+const char* isaName(Isa isa);
+
+/**
+ * @addtogroup ISA_VARIANTS Per-Instruction-Set Tables
+ * @brief Defined in `KernelsSse2.cpp`, `KernelsAvx2.cpp`, and
+ * 		`KernelsAvx512.cpp`.
+ * @{
+ */
+namespace sse2 { KernelTable makeTable(); }
+namespace avx2 { KernelTable makeTable(); }
+namespace avx512 { KernelTable makeTable(); }
+/**
+ * @}
+ */
+
+} // namespace kernels
+
+#endif
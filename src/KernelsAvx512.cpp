@@ -0,0 +1,4 @@
+// See `KernelsImpl.hpp` and `CMakeLists.txt` for how this file is built.
+#define MLE_KERNEL_ISA avx512
+#define MLE_VECTOR_BYTES 64
+#include "KernelsImpl.hpp"
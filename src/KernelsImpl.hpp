@@ -0,0 +1,773 @@
+// No include guard: this file is meant to be included several times, once
+// per instruction set, by `KernelsSse2.cpp`, `KernelsAvx2.cpp`, and
+// `KernelsAvx512.cpp`. Each of those defines:
+//
+//		MLE_KERNEL_ISA		The namespace to put this copy of the kernels in.
+//		MLE_VECTOR_BYTES	The width of one SIMD register, in bytes.
+//
+// ...and is compiled with the matching `-m` flags (see `CMakeLists.txt`).
+//
+// IMPORTANT:	Don't call `inline` or template functions defined outside of
+// 				this file (e.g. `std::min`) in here. The linker keeps only
+// 				one copy of each such function, and it might pick the one
+// 				that was compiled with, say, `-mavx512f`; the baseline
+// 				kernels would then crash on CPUs without AVX-512. Everything
+// 				below lives in an anonymous namespace for the same reason.
+
+#if !defined(MLE_KERNEL_ISA) || !defined(MLE_VECTOR_BYTES)
+#error "Define MLE_KERNEL_ISA and MLE_VECTOR_BYTES before including this file."
+#endif
+
+#include "Kernels.hpp"
+
+namespace kernels
+{
+namespace MLE_KERNEL_ISA
+{
+namespace
+{
+
+constexpr size_t lanes = MLE_VECTOR_BYTES / sizeof(double);
+
+/**
+ * @brief One SIMD register's worth of doubles.
+ * @detail A GCC/Clang vector extension type, so the compiler emits the
+ * 		instructions for whichever `-m` flags this file was built with. The
+ * 		`aligned` and `may_alias` attributes let us load from and store to
+ * 		any `double*`.
+ */
+typedef double Vec
+	__attribute__((vector_size(MLE_VECTOR_BYTES), aligned(8), may_alias));
+
+inline Vec load(const double* ptr)
+{
+	return *reinterpret_cast<const Vec*>(ptr);
+}
+
+inline void store(double* ptr, Vec value)
+{
+	*reinterpret_cast<Vec*>(ptr) = value;
+}
+
+inline Vec broadcast(double value)
+{
+	Vec zero = {};
+	return zero + value;
+}
+
+inline double horizontalSum(Vec value)
+{
+	double total = 0.0;
+	for (size_t lane = 0; lane != lanes; ++lane) total += value[lane];
+	return total;
+}
+
+inline Vec absolute(Vec value)
+{
+	return value < 0.0 ? -value : value;
+}
+
+inline double absolute(double value)
+{
+	return value < 0.0 ? -value : value;
+}
+
+inline size_t smaller(size_t lhs, size_t rhs)
+{
+	return lhs < rhs ? lhs : rhs;
+}
+
+//------------------------------------------------------------------------------
+// Element-wise operations
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Apply `op` element-wise, a full register at a time where possible.
+ * @detail `op` is a generic lambda, so the same expression works on both
+ * 		`Vec`s and the scalar tail.
+ */
+template <typename Op>
+inline void elementwise(size_t n, const double* a, const double* b,
+						double* out, Op op)
+{
+	size_t i = 0;
+	for (; i + lanes <= n; i += lanes)
+	{
+		store(out + i, op(load(a + i), load(b + i)));
+	}
+	for (; i != n; ++i) out[i] = op(a[i], b[i]);
+}
+
+void add(size_t n, const double* a, const double* b, double* out)
+{
+	elementwise(n, a, b, out, [](auto x, auto y){ return x + y; });
+}
+
+void subtract(size_t n, const double* a, const double* b, double* out)
+{
+	elementwise(n, a, b, out, [](auto x, auto y){ return x - y; });
+}
+
+void multiply(size_t n, const double* a, const double* b, double* out)
+{
+	elementwise(n, a, b, out, [](auto x, auto y){ return x * y; });
+}
+
+void divide(size_t n, const double* a, const double* b, double* out)
+{
+	elementwise(n, a, b, out, [](auto x, auto y){ return x / y; });
+}
+
+void scale(size_t n, double alpha, const double* a, double* out)
+{
+	const Vec alpha_vec = broadcast(alpha);
+	size_t i = 0;
+	for (; i + lanes <= n; i += lanes) store(out + i, alpha_vec * load(a + i));
+	for (; i != n; ++i) out[i] = alpha * a[i];
+}
+
+void axpy(size_t n, double alpha, const double* x, double* y)
+{
+	const Vec alpha_vec = broadcast(alpha);
+	size_t i = 0;
+	for (; i + 2 * lanes <= n; i += 2 * lanes)
+	{
+		store(y + i, load(y + i) + alpha_vec * load(x + i));
+		store(y + i + lanes,
+			  load(y + i + lanes) + alpha_vec * load(x + i + lanes));
+	}
+	for (; i + lanes <= n; i += lanes)
+	{
+		store(y + i, load(y + i) + alpha_vec * load(x + i));
+	}
+	for (; i != n; ++i) y[i] += alpha * x[i];
+}
+
+//------------------------------------------------------------------------------
+// Reductions
+//------------------------------------------------------------------------------
+
+/**
+ * @brief Add `value` to `total`, keeping the rounding error in `error`.
+ * @detail Kahan-Babuska (Neumaier) summation, one lane at a time.
+ *
+ * 		(This isn't a template because template argument deduction drops
+ * 		the `aligned(8)` attribute from `Vec`.)
+ */
+inline void compensatedAdd(Vec& total, Vec& error, Vec value)
+{
+	const Vec new_total = total + value;
+	error += absolute(total) >= absolute(value)
+		? (total - new_total) + value
+		: (value - new_total) + total;
+	total = new_total;
+}
+
+inline void compensatedAdd(double& total, double& error, double value)
+{
+	const double new_total = total + value;
+	error += absolute(total) >= absolute(value)
+		? (total - new_total) + value
+		: (value - new_total) + total;
+	total = new_total;
+}
+
+double sum(size_t n, const double* a)
+{
+	// Compensated, so that summing a long array doesn't lose precision;
+	// two independent accumulators hide some of the extra latency.
+	Vec acc0 = {}, err0 = {}, acc1 = {}, err1 = {};
+	size_t i = 0;
+	for (; i + 2 * lanes <= n; i += 2 * lanes)
+	{
+		compensatedAdd(acc0, err0, load(a + i));
+		compensatedAdd(acc1, err1, load(a + i + lanes));
+	}
+	for (; i + lanes <= n; i += lanes) compensatedAdd(acc0, err0, load(a + i));
+
+	double total = 0.0;
+	double error = 0.0;
+	for (size_t lane = 0; lane != lanes; ++lane)
+	{
+		compensatedAdd(total, error, acc0[lane]);
+		compensatedAdd(total, error, acc1[lane]);
+		error += err0[lane] + err1[lane];
+	}
+	for (; i != n; ++i) compensatedAdd(total, error, a[i]);
+	return total + error;
+}
+
+double dot(size_t n, const double* a, const double* b)
+{
+	Vec acc0 = {}, acc1 = {}, acc2 = {}, acc3 = {};
+	size_t i = 0;
+	for (; i + 4 * lanes <= n; i += 4 * lanes)
+	{
+		acc0 += load(a + i) * load(b + i);
+		acc1 += load(a + i + lanes) * load(b + i + lanes);
+		acc2 += load(a + i + 2 * lanes) * load(b + i + 2 * lanes);
+		acc3 += load(a + i + 3 * lanes) * load(b + i + 3 * lanes);
+	}
+	for (; i + lanes <= n; i += lanes) acc0 += load(a + i) * load(b + i);
+
+	double total = horizontalSum((acc0 + acc1) + (acc2 + acc3));
+	for (; i != n; ++i) total += a[i] * b[i];
+	return total;
+}
+
+double sumAbs(size_t n, const double* a)
+{
+	Vec acc0 = {}, acc1 = {};
+	size_t i = 0;
+	for (; i + 2 * lanes <= n; i += 2 * lanes)
+	{
+		acc0 += absolute(load(a + i));
+		acc1 += absolute(load(a + i + lanes));
+	}
+	for (; i + lanes <= n; i += lanes) acc0 += absolute(load(a + i));
+
+	double total = horizontalSum(acc0 + acc1);
+	for (; i != n; ++i) total += absolute(a[i]);
+	return total;
+}
+
+void addAbs(size_t n, const double* a, double* acc)
+{
+	size_t i = 0;
+	for (; i + lanes <= n; i += lanes)
+	{
+		store(acc + i, load(acc + i) + absolute(load(a + i)));
+	}
+	for (; i != n; ++i) acc[i] += absolute(a[i]);
+}
+
+void minMax(size_t n, const double* a, double* min, double* max)
+{
+	double lo = a[0];
+	double hi = a[0];
+	size_t i = 0;
+	if (n >= lanes)
+	{
+		Vec lo_vec = load(a);
+		Vec hi_vec = lo_vec;
+		// A NaN replaces whatever is there, and nothing compares past it.
+		for (i = lanes; i + lanes <= n; i += lanes)
+		{
+			const Vec vals = load(a + i);
+			const auto is_nan = vals != vals;
+			lo_vec = (vals < lo_vec) | is_nan ? vals : lo_vec;
+			hi_vec = (vals > hi_vec) | is_nan ? vals : hi_vec;
+		}
+		for (size_t lane = 0; lane != lanes; ++lane)
+		{
+			const double lo_lane = lo_vec[lane];
+			const double hi_lane = hi_vec[lane];
+			if (lo_lane < lo or lo_lane != lo_lane) lo = lo_lane;
+			if (hi_lane > hi or hi_lane != hi_lane) hi = hi_lane;
+		}
+	}
+	for (; i != n; ++i)
+	{
+		if (a[i] < lo or a[i] != a[i]) lo = a[i];
+		if (a[i] > hi or a[i] != a[i]) hi = a[i];
+	}
+	*min = lo;
+	*max = hi;
+}
+
+size_t firstMismatch(size_t n, const double* a, const double* b,
+					 double abs_tol, double rel_tol)
+{
+	const Vec abs_vec = broadcast(abs_tol);
+	const Vec rel_vec = broadcast(rel_tol);
+
+	size_t i = 0;
+	for (; i + lanes <= n; i += lanes)
+	{
+		const Vec lhs = absolute(load(a + i));
+		const Vec rhs = absolute(load(b + i));
+		const Vec diff = absolute(load(a + i) - load(b + i));
+		const Vec larger = lhs > rhs ? lhs : rhs;
+		const Vec rel_bound = rel_vec * larger;
+		const Vec bound = rel_bound > abs_vec ? rel_bound : abs_vec;
+
+		// `diff <= bound` is false for NaNs, which is what we want.
+		const auto ok = diff <= bound;
+		for (size_t lane = 0; lane != lanes; ++lane)
+		{
+			if (not ok[lane]) return i + lane;
+		}
+	}
+	for (; i != n; ++i)
+	{
+		const double lhs = absolute(a[i]);
+		const double rhs = absolute(b[i]);
+		const double rel_bound = rel_tol * (lhs > rhs ? lhs : rhs);
+		const double bound = rel_bound > abs_tol ? rel_bound : abs_tol;
+		if (not (absolute(a[i] - b[i]) <= bound)) return i;
+	}
+	return n;
+}
+
+//------------------------------------------------------------------------------
+// GEMM
+//------------------------------------------------------------------------------
+
+// Register tile: `gemm_mr` rows by two registers' worth of columns.
+constexpr size_t gemm_mr = 4;
+constexpr size_t gemm_nr = 2 * lanes;
+
+// Cache blocks: a `gemm_kc x gemm_nc` panel of B is reused for every row
+// of A, so it should stay resident in L2.
+constexpr size_t gemm_kc = 128;
+constexpr size_t gemm_nc = 256;
+
+/**
+ * @brief `C[0..4)[0..gemm_nr) += alpha * A[0..4)[0..kc) * B[0..kc)[0..gemm_nr)`
+ */
+inline void gemmMicroKernel(size_t kc, double alpha,
+							const double* a, size_t lda,
+							const double* b, size_t ldb,
+							double* c, size_t ldc)
+{
+	Vec c00 = {}, c01 = {}, c10 = {}, c11 = {};
+	Vec c20 = {}, c21 = {}, c30 = {}, c31 = {};
+
+	for (size_t p = 0; p != kc; ++p)
+	{
+		const Vec b0 = load(b + p * ldb);
+		const Vec b1 = load(b + p * ldb + lanes);
+
+		const Vec a0 = broadcast(a[p]);
+		const Vec a1 = broadcast(a[lda + p]);
+		const Vec a2 = broadcast(a[2 * lda + p]);
+		const Vec a3 = broadcast(a[3 * lda + p]);
+
+		c00 += a0 * b0; c01 += a0 * b1;
+		c10 += a1 * b0; c11 += a1 * b1;
+		c20 += a2 * b0; c21 += a2 * b1;
+		c30 += a3 * b0; c31 += a3 * b1;
+	}
+
+	const Vec alpha_vec = broadcast(alpha);
+	double* c0 = c;
+	double* c1 = c + ldc;
+	double* c2 = c + 2 * ldc;
+	double* c3 = c + 3 * ldc;
+	store(c0, load(c0) + alpha_vec * c00);
+	store(c0 + lanes, load(c0 + lanes) + alpha_vec * c01);
+	store(c1, load(c1) + alpha_vec * c10);
+	store(c1 + lanes, load(c1 + lanes) + alpha_vec * c11);
+	store(c2, load(c2) + alpha_vec * c20);
+	store(c2 + lanes, load(c2 + lanes) + alpha_vec * c21);
+	store(c3, load(c3) + alpha_vec * c30);
+	store(c3 + lanes, load(c3 + lanes) + alpha_vec * c31);
+}
+
+/**
+ * @brief Handle the rows and columns that don't fill a whole register tile.
+ */
+inline void gemmEdge(size_t mr, size_t nr, size_t kc, double alpha,
+					 const double* a, size_t lda,
+					 const double* b, size_t ldb,
+					 double* c, size_t ldc)
+{
+	for (size_t row = 0; row != mr; ++row)
+	{
+		double* c_row = c + row * ldc;
+		for (size_t p = 0; p != kc; ++p)
+		{
+			const double a_val = alpha * a[row * lda + p];
+			const Vec a_vec = broadcast(a_val);
+			const double* b_row = b + p * ldb;
+
+			size_t col = 0;
+			for (; col + lanes <= nr; col += lanes)
+			{
+				store(c_row + col, load(c_row + col) + a_vec * load(b_row + col));
+			}
+			for (; col != nr; ++col) c_row[col] += a_val * b_row[col];
+		}
+	}
+}
+
+void gemm(size_t m, size_t n, size_t k, double alpha,
+		  const double* a, size_t lda,
+		  const double* b, size_t ldb,
+		  double* c, size_t ldc)
+{
+	for (size_t jj = 0; jj < n; jj += gemm_nc)
+	{
+		const size_t nc = smaller(gemm_nc, n - jj);
+		for (size_t pp = 0; pp < k; pp += gemm_kc)
+		{
+			const size_t kc = smaller(gemm_kc, k - pp);
+			for (size_t i = 0; i < m; i += gemm_mr)
+			{
+				const size_t mr = smaller(gemm_mr, m - i);
+				const double* a_blk = a + i * lda + pp;
+				const double* b_blk = b + pp * ldb + jj;
+				double* c_blk = c + i * ldc + jj;
+
+				size_t j = 0;
+				if (mr == gemm_mr)
+				{
+					for (; j + gemm_nr <= nc; j += gemm_nr)
+					{
+						gemmMicroKernel(kc, alpha, a_blk, lda, b_blk + j, ldb,
+										c_blk + j, ldc);
+					}
+				}
+				gemmEdge(mr, nc - j, kc, alpha, a_blk, lda, b_blk + j, ldb,
+						 c_blk + j, ldc);
+			}
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+// GEMV
+//------------------------------------------------------------------------------
+
+// Matrix-vector products read each element of A exactly once, so they're
+// bound by memory bandwidth. The trick is to stream A through as few times
+// as possible, touching `x` and `y` (which stay in cache) as often as needed.
+constexpr size_t gemv_rows = 4;
+
+void gemv(size_t m, size_t n, double alpha, const double* a, size_t lda,
+		  const double* x, double* y)
+{
+	// Four rows at a time: each load of `x` feeds four dot products, and the
+	// four accumulators are independent, which hides the FMA latency.
+	size_t row = 0;
+	for (; row + gemv_rows <= m; row += gemv_rows)
+	{
+		const double* a0 = a + row * lda;
+		const double* a1 = a0 + lda;
+		const double* a2 = a1 + lda;
+		const double* a3 = a2 + lda;
+
+		Vec acc0 = {}, acc1 = {}, acc2 = {}, acc3 = {};
+		size_t col = 0;
+		for (; col + lanes <= n; col += lanes)
+		{
+			const Vec x_vec = load(x + col);
+			acc0 += load(a0 + col) * x_vec;
+			acc1 += load(a1 + col) * x_vec;
+			acc2 += load(a2 + col) * x_vec;
+			acc3 += load(a3 + col) * x_vec;
+		}
+
+		double total0 = horizontalSum(acc0);
+		double total1 = horizontalSum(acc1);
+		double total2 = horizontalSum(acc2);
+		double total3 = horizontalSum(acc3);
+		for (; col != n; ++col)
+		{
+			total0 += a0[col] * x[col];
+			total1 += a1[col] * x[col];
+			total2 += a2[col] * x[col];
+			total3 += a3[col] * x[col];
+		}
+		y[row] += alpha * total0;
+		y[row + 1] += alpha * total1;
+		y[row + 2] += alpha * total2;
+		y[row + 3] += alpha * total3;
+	}
+	for (; row != m; ++row) y[row] += alpha * dot(n, a + row * lda, x);
+}
+
+void gemvTransposed(size_t m, size_t n, double alpha, const double* a,
+					size_t lda, const double* x, double* y)
+{
+	// `y` is a linear combination of the rows of A. Adding four rows in at
+	// once means `y` is loaded and stored a quarter as often.
+	size_t row = 0;
+	for (; row + gemv_rows <= m; row += gemv_rows)
+	{
+		const double* a0 = a + row * lda;
+		const double* a1 = a0 + lda;
+		const double* a2 = a1 + lda;
+		const double* a3 = a2 + lda;
+		const double s0 = alpha * x[row];
+		const double s1 = alpha * x[row + 1];
+		const double s2 = alpha * x[row + 2];
+		const double s3 = alpha * x[row + 3];
+		const Vec v0 = broadcast(s0);
+		const Vec v1 = broadcast(s1);
+		const Vec v2 = broadcast(s2);
+		const Vec v3 = broadcast(s3);
+
+		size_t col = 0;
+		for (; col + lanes <= n; col += lanes)
+		{
+			store(y + col, load(y + col)
+				+ (v0 * load(a0 + col) + v1 * load(a1 + col))
+				+ (v2 * load(a2 + col) + v3 * load(a3 + col)));
+		}
+		for (; col != n; ++col)
+		{
+			y[col] += (s0 * a0[col] + s1 * a1[col])
+				+ (s2 * a2[col] + s3 * a3[col]);
+		}
+	}
+	for (; row != m; ++row) axpy(n, alpha * x[row], a + row * lda, y);
+}
+
+//------------------------------------------------------------------------------
+// Filtering
+//------------------------------------------------------------------------------
+
+// Output pixels are computed two rows by this many registers at a time.
+// Every tap is applied to them before they're stored, so each output is
+// written once; each input register loaded feeds both rows; and there are
+// enough independent sums to hide the FMA latency.
+constexpr size_t correlate_registers = 4;
+
+// Rows of taps up to this long get a copy of the loops with the row length
+// fixed at compile time, so the loop over them is fully unrolled.
+constexpr size_t correlate_max_unrolled = 7;
+
+/**
+ * @brief `sums[v] += weight * in[v * lanes + t]` for each register `v` and
+ * 		each tap `t` in one row of `cols` taps.
+ */
+template <size_t Cols>
+inline void correlateTaps(size_t cols, const double* weights,
+						  const double* in, Vec* sums)
+{
+	if (Cols != 0) cols = Cols;
+	for (size_t t = 0; t != cols; ++t)
+	{
+		const Vec weight = broadcast(weights[t]);
+		for (size_t v = 0; v != correlate_registers; ++v)
+		{
+			sums[v] += weight * load(in + t + v * lanes);
+		}
+	}
+}
+
+/**
+ * @brief The same for two output rows, `first` and `second`, whose taps on
+ * 		this input row are `first_weights` and `second_weights`.
+ */
+template <size_t Cols>
+inline void correlateTapsTwice(size_t cols, const double* first_weights,
+							   const double* second_weights,
+							   const double* in, Vec* first, Vec* second)
+{
+	if (Cols != 0) cols = Cols;
+	for (size_t t = 0; t != cols; ++t)
+	{
+		const Vec first_weight = broadcast(first_weights[t]);
+		const Vec second_weight = broadcast(second_weights[t]);
+		for (size_t v = 0; v != correlate_registers; ++v)
+		{
+			const Vec pixels = load(in + t + v * lanes);
+			first[v] += first_weight * pixels;
+			second[v] += second_weight * pixels;
+		}
+	}
+}
+
+/**
+ * @brief The pixels from `j` on that don't fill a whole register block,
+ * 		for one output row.
+ */
+inline void correlateTail(size_t j, size_t n, size_t rows, size_t cols,
+						  const double* weights, const double* in,
+						  size_t ld_in, double* out)
+{
+	for (; j + lanes <= n; j += lanes)
+	{
+		Vec sum = {};
+		for (size_t i = 0; i != rows; ++i)
+		{
+			for (size_t t = 0; t != cols; ++t)
+			{
+				sum += broadcast(weights[i * cols + t])
+					* load(in + i * ld_in + j + t);
+			}
+		}
+		store(out + j, sum);
+	}
+	for (; j != n; ++j)
+	{
+		double sum = 0.0;
+		for (size_t i = 0; i != rows; ++i)
+		{
+			for (size_t t = 0; t != cols; ++t)
+			{
+				sum += weights[i * cols + t] * in[i * ld_in + j + t];
+			}
+		}
+		out[j] = sum;
+	}
+}
+
+/**
+ * @brief `correlateRows()` for `cols` taps per row, where `Cols` is either
+ * 		`cols` or zero for "not known at compile time."
+ * @detail Each output is summed in the same order whichever path computes
+ * 		it, so the result doesn't depend on how the rows pair up.
+ */
+template <size_t Cols>
+inline void correlateRowsFor(size_t num_out, size_t n, size_t rows,
+							 size_t cols, const double* weights,
+							 const double* in, size_t ld_in,
+							 double* out, size_t ld_out)
+{
+	const size_t block = correlate_registers * lanes;
+	size_t row = 0;
+	for (; row + 2 <= num_out; row += 2)
+	{
+		const double* in_rows = in + row * ld_in;
+		double* first_out = out + row * ld_out;
+		double* second_out = first_out + ld_out;
+
+		size_t j = 0;
+		for (; j + block <= n; j += block)
+		{
+			Vec first[correlate_registers] = {};
+			Vec second[correlate_registers] = {};
+
+			// Input row `i` is row `i` of the first output's taps, and row
+			// `i - 1` of the second's.
+			correlateTaps<Cols>(cols, weights, in_rows + j, first);
+			for (size_t i = 1; i != rows; ++i)
+			{
+				correlateTapsTwice<Cols>(cols, weights + i * cols,
+										 weights + (i - 1) * cols,
+										 in_rows + i * ld_in + j,
+										 first, second);
+			}
+			correlateTaps<Cols>(cols, weights + (rows - 1) * cols,
+								in_rows + rows * ld_in + j, second);
+
+			for (size_t v = 0; v != correlate_registers; ++v)
+			{
+				store(first_out + j + v * lanes, first[v]);
+				store(second_out + j + v * lanes, second[v]);
+			}
+		}
+		correlateTail(j, n, rows, cols, weights, in_rows, ld_in, first_out);
+		correlateTail(j, n, rows, cols, weights, in_rows + ld_in, ld_in,
+					  second_out);
+	}
+
+	for (; row != num_out; ++row)
+	{
+		const double* in_rows = in + row * ld_in;
+		double* out_row = out + row * ld_out;
+
+		size_t j = 0;
+		for (; j + block <= n; j += block)
+		{
+			Vec sums[correlate_registers] = {};
+			for (size_t i = 0; i != rows; ++i)
+			{
+				correlateTaps<Cols>(cols, weights + i * cols,
+									in_rows + i * ld_in + j, sums);
+			}
+			for (size_t v = 0; v != correlate_registers; ++v)
+			{
+				store(out_row + j + v * lanes, sums[v]);
+			}
+		}
+		correlateTail(j, n, rows, cols, weights, in_rows, ld_in, out_row);
+	}
+}
+
+template <size_t Cols>
+inline void correlateRowsDispatch(size_t num_out, size_t n, size_t rows,
+								  size_t cols, const double* weights,
+								  const double* in, size_t ld_in,
+								  double* out, size_t ld_out)
+{
+	if (cols == Cols)
+	{
+		correlateRowsFor<Cols>(num_out, n, rows, cols, weights, in, ld_in,
+							   out, ld_out);
+	}
+	else
+	{
+		correlateRowsDispatch<Cols - 1>(num_out, n, rows, cols, weights, in,
+										ld_in, out, ld_out);
+	}
+}
+
+template <>
+inline void correlateRowsDispatch<0>(size_t num_out, size_t n, size_t rows,
+									 size_t cols, const double* weights,
+									 const double* in, size_t ld_in,
+									 double* out, size_t ld_out)
+{
+	correlateRowsFor<0>(num_out, n, rows, cols, weights, in, ld_in, out,
+						ld_out);
+}
+
+void correlateRows(size_t num_out, size_t n, size_t rows, size_t cols,
+				   const double* weights, const double* in, size_t ld_in,
+				   double* out, size_t ld_out)
+{
+	if (rows == 0) return;
+	correlateRowsDispatch<correlate_max_unrolled>(num_out, n, rows, cols,
+												  weights, in, ld_in, out,
+												  ld_out);
+}
+
+//------------------------------------------------------------------------------
+// Transpose
+//------------------------------------------------------------------------------
+
+// Square tiles, so that both the reads and the writes stay within a few
+// cache lines per row.
+constexpr size_t transpose_tile = 16;
+
+void transpose(size_t rows, size_t cols, const double* in, size_t ld_in,
+			   double* out, size_t ld_out)
+{
+	for (size_t ii = 0; ii < rows; ii += transpose_tile)
+	{
+		const size_t row_end = smaller(ii + transpose_tile, rows);
+		for (size_t jj = 0; jj < cols; jj += transpose_tile)
+		{
+			const size_t col_end = smaller(jj + transpose_tile, cols);
+			for (size_t row = ii; row != row_end; ++row)
+			{
+				for (size_t col = jj; col != col_end; ++col)
+				{
+					out[col * ld_out + row] = in[row * ld_in + col];
+				}
+			}
+		}
+	}
+}
+
+} // anonymous namespace
+
+KernelTable makeTable()
+{
+	KernelTable table;
+	table.add = add;
+	table.subtract = subtract;
+	table.multiply = multiply;
+	table.divide = divide;
+	table.scale = scale;
+	table.axpy = axpy;
+	table.gemm = gemm;
+	table.gemv = gemv;
+	table.gemvTransposed = gemvTransposed;
+	table.transpose = transpose;
+	table.correlateRows = correlateRows;
+	table.sum = sum;
+	table.dot = dot;
+	table.sumAbs = sumAbs;
+	table.addAbs = addAbs;
+	table.minMax = minMax;
+	table.firstMismatch = firstMismatch;
+	return table;
+}
+
+} // namespace MLE_KERNEL_ISA
+} // namespace kernels
@@ -1,98 +1,455 @@
 #include "Matrix.hpp"
+#include "Backend.hpp"
+#include "Decompositions.hpp"
+#include "Kernels.hpp"
+
+#include <algorithm>	// std::copy, std::max, std::min
+#include <atomic>		// std::atomic_thread_fence
 #include <cassert>		// assert
 #include <exception>	// std::runtime_error
+#include <memory>		// std::make_shared, std::shared_ptr
+#include <stdexcept>	// std::runtime_error
+#include <utility>		// std::move
+#include <vector>		// std::vector
 
 using std::ostream;
 using std::runtime_error;
 
 using SizePair = std::pair<size_t, size_t>;
 
-Matrix::Matrix(size_t num_rows, size_t num_cols)
+namespace
+{
+
+/**
+ * @brief Throw if the given Matrix storage is "blank."
+ */
+void checkNotBlank(const std::shared_ptr<Array2D>& contents)
+{
+	if (not contents)
+	{
+		throw runtime_error{"Operation invoked on a blank Matrix!"};
+	}
+}
+
+/**
+ * @brief Throw if the two arrays don't have the same dimensions.
+ */
+void checkSameSize(const Array2D& lhs, const Array2D& rhs)
+{
+	if (lhs.size() != rhs.size())
+	{
+		throw runtime_error{"Matrix dimensions do not match!"};
+	}
+}
+
+/**
+ * @brief Return the number of rows of `array`'s storage, viewed as a
+ * 		row-major array; i.e. the number of columns of a column-major one.
+ */
+size_t outerSize(const Array2D& array)
 {
-	// ADD IMPLEMENTATION HERE
+	return array.layout() == Layout::RowMajor ? array.size().first
+											  : array.size().second;
 }
 
+} // anonymous namespace
+
+Matrix::Matrix(size_t num_rows, size_t num_cols, Layout layout)
+	: contents{std::make_shared<Array2D>(num_rows, num_cols, layout)}
+{}
+
 Matrix::Matrix(const Matrix& to_copy)
+	: copy_on_write{to_copy.copy_on_write}
 {
-	// ADD IMPLEMENTATION HERE
+	if (to_copy.copy_on_write)
+	{
+		contents = to_copy.contents;
+	}
+	else if (to_copy.contents)
+	{
+		contents = std::make_shared<Array2D>(*to_copy.contents);
+	}
 }
 
 Matrix& Matrix::operator=(const Matrix& assign_from)
 {
-	// ADD IMPLEMENTATION HERE
+	if (this == &assign_from) return *this;
+
+	if (assign_from.copy_on_write or not assign_from.contents)
+	{
+		contents = assign_from.contents;
+	}
+	else if (contents and not isShared())
+	{
+		*contents = *assign_from.contents;
+	}
+	else
+	{
+		// Don't write through storage that other matrices can see.
+		contents = std::make_shared<Array2D>(*assign_from.contents);
+	}
+	copy_on_write = assign_from.copy_on_write;
+	return *this;
 }
 
-Matrix::~Matrix()
+Matrix::Matrix(Matrix&& to_move) noexcept
+	: contents{std::move(to_move.contents)},
+	  copy_on_write{to_move.copy_on_write}
+{}
+
+Matrix& Matrix::operator=(Matrix&& assign_from) noexcept
 {
-	// ADD IMPLEMENTATION HERE
+	contents = std::move(assign_from.contents);
+	copy_on_write = assign_from.copy_on_write;
+	return *this;
 }
 
+Matrix::~Matrix() = default;
+
 const SizePair& Matrix::size() const
 {
-	// ADD IMPLEMENTATION HERE
+	checkNotBlank(contents);
+	return contents->size();
 }
 
 double& Matrix::operator()(size_t row, size_t col)
 {
-	// ADD IMPLEMENTATION HERE
+	checkNotBlank(contents);
+	if (row == 0 or col == 0)
+	{
+		throw runtime_error{"Matrix indices start from one!"};
+	}
+	return mutableContents()(row - 1, col - 1);
 }
 
 double Matrix::operator()(size_t row, size_t col) const
 {
-	// ADD IMPLEMENTATION HERE
+	checkNotBlank(contents);
+	if (row == 0 or col == 0)
+	{
+		throw runtime_error{"Matrix indices start from one!"};
+	}
+	return (*contents)(row - 1, col - 1);
+}
+
+double* Matrix::data()
+{
+	return mutableContents().data();
+}
+
+const double* Matrix::data() const
+{
+	checkNotBlank(contents);
+	return contents->data();
+}
+
+Layout Matrix::layout() const
+{
+	checkNotBlank(contents);
+	return contents->layout();
+}
+
+Matrix Matrix::toLayout(Layout layout) const
+{
+	checkNotBlank(contents);
+
+	Matrix converted;
+	converted.contents = layout == contents->layout()
+		? contents
+		: std::make_shared<Array2D>(contents->toLayout(layout));
+	return converted;
+}
+
+void Matrix::setCopyOnWrite(bool enabled)
+{
+	if (not enabled and isShared())
+	{
+		contents = std::make_shared<Array2D>(*contents);
+	}
+	copy_on_write = enabled;
+}
+
+bool Matrix::copyOnWrite() const
+{
+	return copy_on_write;
+}
+
+bool Matrix::isShared() const
+{
+	return contents and contents.use_count() > 1;
 }
 
-Matrix& resize(size_t num_rows, size_t num_cols)
+Array2D& Matrix::mutableContents()
 {
-	// ADD IMPLEMENTATION HERE
+	checkNotBlank(contents);
+	if (contents.use_count() > 1)
+	{
+		contents = std::make_shared<Array2D>(*contents);
+	}
+	else
+	{
+		// The last other owner may have just let go of this buffer on
+		// another thread; make sure its reads finish before our writes.
+		std::atomic_thread_fence(std::memory_order_acquire);
+	}
+	return *contents;
+}
+
+Matrix& Matrix::resize(size_t num_rows, size_t num_cols)
+{
+	if (contents and contents->size() == SizePair{num_rows, num_cols})
+	{
+		return *this;
+	}
+
+	const Layout layout = contents ? contents->layout() : Layout::RowMajor;
+	std::shared_ptr<Array2D> resized{
+		std::make_shared<Array2D>(num_rows, num_cols, layout)};
+
+	if (contents)
+	{
+		// Copy line by line, where a "line" is a row or a column depending
+		// on the layout.
+		const size_t old_ld = contents->leadingDimension();
+		const size_t new_ld = resized->leadingDimension();
+		const size_t lines = std::min(outerSize(*contents), outerSize(*resized));
+		const size_t line_length = std::min(old_ld, new_ld);
+		for (size_t line = 0; line != lines; ++line)
+		{
+			const double* from = contents->data() + line * old_ld;
+			std::copy(from, from + line_length,
+					  resized->data() + line * new_ld);
+		}
+	}
+
+	contents = std::move(resized);
+	return *this;
 }
 
 Matrix Matrix::operator+(const Matrix& rhs) const
 {
-	// ADD IMPLEMENTATION HERE
+	checkNotBlank(contents);
+	checkNotBlank(rhs.contents);
+	checkSameSize(*contents, *rhs.contents);
+	const Matrix same_layout = rhs.toLayout(layout());
+
+	Matrix sum{*this};
+	const size_t num_elements = contents->size().first * contents->size().second;
+	double* out = sum.mutableContents().data();
+	kernels::active().add(num_elements, out, same_layout.data(), out);
+	return sum;
 }
 
 Matrix Matrix::operator-(const Matrix& rhs) const
 {
-	// ADD IMPLEMENTATION HERE
+	checkNotBlank(contents);
+	checkNotBlank(rhs.contents);
+	checkSameSize(*contents, *rhs.contents);
+	const Matrix same_layout = rhs.toLayout(layout());
+
+	Matrix difference{*this};
+	const size_t num_elements = contents->size().first * contents->size().second;
+	double* out = difference.mutableContents().data();
+	kernels::active().subtract(num_elements, out, same_layout.data(), out);
+	return difference;
 }
 
 Matrix Matrix::operator*(const Matrix& rhs) const
 {
-	// ADD IMPLEMENTATION HERE
+	checkNotBlank(contents);
+	checkNotBlank(rhs.contents);
+
+	const size_t m = contents->size().first;
+	const size_t k = contents->size().second;
+	const size_t n = rhs.contents->size().second;
+	if (k != rhs.contents->size().first)
+	{
+		throw runtime_error{"Matrix dimensions are invalid for multiplication!"};
+	}
+
+	const Layout layout = contents->layout();
+	const Matrix same_layout = rhs.toLayout(layout);
+	Matrix product{m, n, layout};
+
+	if (layout == Layout::RowMajor)
+	{
+		if (backend::shouldDispatch(std::max({m, k, n})))
+		{
+			backend::multiply(*contents, *same_layout.contents,
+							  *product.contents);
+			return product;
+		}
+		kernels::active().gemm(m, n, k, 1.0, contents->data(), k,
+			same_layout.data(), n, product.contents->data(), n);
+		return product;
+	}
+
+	// Column-major storage of A is row-major storage of A', so compute
+	// C' = B' * A' with the same (row-major) kernel.
+	if (backend::shouldDispatch(std::max({m, k, n})))
+	{
+		Matrix row_major = toLayout(Layout::RowMajor)
+			* same_layout.toLayout(Layout::RowMajor);
+		return row_major.toLayout(layout);
+	}
+	kernels::active().gemm(n, m, k, 1.0, same_layout.data(), k,
+		contents->data(), m, product.contents->data(), m);
+	return product;
 }
 
 Matrix Matrix::operator/(double divisor) const
 {
-	// ADD IMPLEMENTATION HERE
+	checkNotBlank(contents);
+
+	Matrix quotient{*this};
+	const size_t num_elements = contents->size().first * contents->size().second;
+	double* out = quotient.mutableContents().data();
+	for (size_t i = 0; i != num_elements; ++i)
+	{
+		out[i] /= divisor;
+	}
+	return quotient;
 }
 
 Matrix Matrix::divide(const Matrix& rhs) const
 {
-	// ADD IMPLEMENTATION HERE
+	checkNotBlank(contents);
+	checkNotBlank(rhs.contents);
+	checkSameSize(*contents, *rhs.contents);
+	const Matrix same_layout = rhs.toLayout(layout());
+
+	Matrix quotient{*this};
+	const size_t num_elements = contents->size().first * contents->size().second;
+	double* out = quotient.mutableContents().data();
+	kernels::active().divide(num_elements, out, same_layout.data(), out);
+	return quotient;
 }
 
 Matrix Matrix::inverse() const
 {
-	// ADD IMPLEMENTATION HERE
+	checkNotBlank(contents);
+
+	const size_t n = contents->size().first;
+	if (n != contents->size().second)
+	{
+		throw runtime_error{"Cannot invert a non-square matrix!"};
+	}
+
+	// The backend and the LU routines treat storage as row-major, so given
+	// a column-major A, they invert A' instead. But inv(A') = inv(A)', and
+	// the row-major storage of inv(A)' is the column-major storage of
+	// inv(A), so this works for either layout without converting.
+	Matrix inverted{n, n, contents->layout()};
+	if (backend::shouldDispatch(n))
+	{
+		backend::inverse(*contents, *inverted.contents);
+		return inverted;
+	}
+
+	Array2D lu{*contents};
+	std::vector<size_t> pivots;
+	if (not luFactor(lu, pivots))
+	{
+		throw runtime_error{"Matrix is singular!"};
+	}
+
+	for (size_t i = 0; i != n; ++i)
+	{
+		(*inverted.contents)[i * n + i] = 1.0;
+	}
+	luSolve(lu, pivots, *inverted.contents);
+	return inverted;
+}
+
+Matrix Matrix::solve(const Matrix& rhs) const
+{
+	checkNotBlank(contents);
+	checkNotBlank(rhs.contents);
+
+	const size_t n = contents->size().first;
+	if (n != contents->size().second)
+	{
+		throw runtime_error{"Cannot solve with a non-square matrix!"};
+	}
+	if (n != rhs.contents->size().first)
+	{
+		throw runtime_error{"Right-hand side has the wrong number of rows!"};
+	}
+
+	// The solvers work on row-major storage; converting costs O(n^2), next
+	// to the O(n^3) factorization.
+	if (backend::shouldDispatch(n))
+	{
+		Matrix solution{n, rhs.contents->size().second};
+		backend::solve(*toLayout(Layout::RowMajor).contents,
+					   *rhs.toLayout(Layout::RowMajor).contents,
+					   *solution.contents);
+		return solution.toLayout(layout());
+	}
+
+	Array2D lu = contents->toLayout(Layout::RowMajor);
+	std::vector<size_t> pivots;
+	if (not luFactor(lu, pivots))
+	{
+		throw runtime_error{"Matrix is singular!"};
+	}
+
+	Matrix solution = rhs.toLayout(Layout::RowMajor);
+	luSolve(lu, pivots, solution.mutableContents());
+	return solution.toLayout(layout());
 }
 
 Matrix Matrix::transpose() const
 {
-	// ADD IMPLEMENTATION HERE
+	checkNotBlank(contents);
+
+	const size_t rows = contents->size().first;
+	const size_t cols = contents->size().second;
+	Matrix transposed{cols, rows, contents->layout()};
+
+	// Either way, the storage of the result is the transpose of this
+	// Matrix's storage.
+	const size_t outer = outerSize(*contents);
+	const size_t inner = contents->leadingDimension();
+	kernels::active().transpose(outer, inner, contents->data(), inner,
+		transposed.contents->data(), outer);
+	return transposed;
 }
 
 bool Matrix::operator==(const Matrix& rhs) const
 {
-	// ADD IMPLEMENTATION HERE
+	checkNotBlank(contents);
+	checkNotBlank(rhs.contents);
+	if (contents->size() != rhs.contents->size()) return false;
+	const Matrix same_layout = rhs.toLayout(layout());
+
+	const size_t num_elements = contents->size().first * contents->size().second;
+	const double* lhs_vals = contents->data();
+	const double* rhs_vals = same_layout.contents->data();
+	for (size_t i = 0; i != num_elements; ++i)
+	{
+		if (lhs_vals[i] != rhs_vals[i]) return false;
+	}
+	return true;
 }
 
 bool Matrix::operator!=(const Matrix& rhs) const
 {
-	// ADD IMPLEMENTATION HERE
+	return not (*this == rhs);
 }
 
 ostream& operator<<(ostream& os, const Matrix& mat)
 {
-	// ADD IMPLEMENTATION HERE
+	const auto& mat_size = mat.size();
+	for (size_t row = 1; row <= mat_size.first; ++row)
+	{
+		os << "[";
+		for (size_t col = 1; col <= mat_size.second; ++col)
+		{
+			if (col != 1) os << "\t";
+			os << mat(row, col);
+		}
+		os << "]\n";
+	}
+	return os;
 }
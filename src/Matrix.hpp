@@ -4,7 +4,7 @@
 #include "Array2D.hpp"
 
 #include <iostream>	// std::ostream
-#include <memory>	// std::unique_ptr
+#include <memory>	// std::shared_ptr
 
 /**
  * @brief Represents a two-dimensional matrix, to be used for linear algebra.
@@ -53,8 +53,12 @@ public:
 	 *
 	 * 		Zero-initialization means that every element of this Matrix will
 	 * 		have a starting value of zero.
+	 *
+	 * 		`layout` picks how the elements are stored; see `Layout` and
+	 * 		`toLayout()`. Almost everything works the same either way.
 	 */
-	Matrix(size_t num_rows, size_t num_cols);
+	Matrix(size_t num_rows, size_t num_cols,
+		   Layout layout = Layout::RowMajor);
 
 	/**
 	 * @addtogroup BIG_THREE The Big Three
@@ -70,6 +74,10 @@ public:
 		 * @detail See the copy constructor for Array2D--as well as the
 		 * 		project documentation--for more information on copy
 		 * 		construction.
+		 *
+		 * 		If `to_copy` is in copy-on-write mode, the new Matrix shares
+		 * 		its storage instead, and this takes O(1) time. See
+		 * 		`setCopyOnWrite()`.
 		 */
 		Matrix(const Matrix& to_copy);
 
@@ -78,9 +86,26 @@ public:
 		 * @detail See the assignment operator for Array2D--as well as the
 		 * 		project documentation--for more information on what the
 		 * 		assignment operator does and needs to do.
+		 *
+		 * 		Like the copy constructor, this shares `assign_from`'s storage
+		 * 		if it's in copy-on-write mode. This Matrix takes on
+		 * 		`assign_from`'s mode either way.
 		 */
 		Matrix& operator=(const Matrix& assign_from);
 
+		/**
+		 * @brief Take over `to_move`'s storage and mode, leaving it blank.
+		 * @detail Nothing is copied, in either mode, so returning a Matrix
+		 * 		or assigning a temporary (`a = Matrix{b}`) costs O(1).
+		 */
+		Matrix(Matrix&& to_move) noexcept;
+
+		/**
+		 * @brief Release this Matrix's storage and take over
+		 * 		`assign_from`'s storage and mode, leaving it blank.
+		 */
+		Matrix& operator=(Matrix&& assign_from) noexcept;
+
 		/**
 		 * @brief Destroy this Matrix.
 		 * @detail See the destructor for Array2D, as well as the project
@@ -106,6 +131,14 @@ public:
 
 		/**
 	 	 * @brief Allow modificiation of a specific element in this Matrix.
+		 * @detail Like MATLAB (and unlike Array2D), rows and columns are
+		 * 		numbered starting from one. Throws an `std::runtime_error` if
+		 * 		the index is out of range.
+		 *
+		 * 		If this Matrix shares its storage with a copy-on-write copy,
+		 * 		it first makes a private copy of it. The returned reference
+		 * 		is only guaranteed to refer to this Matrix until this Matrix
+		 * 		is next copied.
 		 */
 		double& operator()(size_t row, size_t col);
 
@@ -114,6 +147,87 @@ public:
 		 */
 		double operator()(size_t row, size_t col) const;
 
+		/**
+		 * @brief Return a pointer to this Matrix's element storage.
+		 * @detail In a row-major Matrix (the default), element `(row, col)`
+		 * 		lives at `data()[(row - 1) * size().second + (col - 1)]`; in a
+		 * 		column-major one, it's at
+		 * 		`data()[(col - 1) * size().first + (row - 1)]`. This is the
+		 * 		hook that the Eigen adapters and the optimized kernels use to
+		 * 		work on a Matrix without copying it.
+		 *
+		 * 		Like the non-const `operator()`, this first makes a private
+		 * 		copy of shared storage.
+		 */
+		double* data();
+
+		/**
+		 * @brief Return a read-only pointer to this Matrix's storage.
+		 */
+		const double* data() const;
+
+		/**
+		 * @brief Return the order in which this Matrix's elements are stored.
+		 */
+		Layout layout() const;
+
+	/**
+	 * @}
+	 */
+
+	/**
+	 * @brief Return this Matrix, stored in the given layout.
+	 * @detail Converting is an explicit, cache-blocked transpose of the
+	 * 		storage. If this Matrix already has the requested layout, the
+	 * 		result shares its storage (until either one is written to), so
+	 * 		code that needs a particular layout can call this
+	 * 		unconditionally.
+	 *
+	 * 		Operations on two matrices with different layouts convert the
+	 * 		right-hand one first, and results take the left-hand one's
+	 * 		layout. Code that reads `data()` directly should convert first,
+	 * 		too.
+	 */
+	Matrix toLayout(Layout layout) const;
+
+	/**
+	 * @addtogroup COPY_ON_WRITE Copy-on-Write Mode
+	 * @brief Make copies of large, read-mostly matrices cheap.
+	 * @detail By default, every copy of a Matrix is a deep copy. In
+	 * 		copy-on-write mode, copies share one reference-counted buffer
+	 * 		instead, and a Matrix only makes its own copy of the buffer the
+	 * 		first time it's written to (through the non-const `operator()`
+	 * 		or `data()`). Copies inherit the mode of the Matrix they were
+	 * 		copied from.
+	 *
+	 * 		The reference count is atomic, so different Matrix objects that
+	 * 		share a buffer may be copied, read, and written from different
+	 * 		threads. As with any other object, one Matrix object still
+	 * 		mustn't be written from one thread while it's used from another.
+	 *
+	 * 		Unlike the rest of Matrix's methods, these may be called on a
+	 * 		blank Matrix.
+	 * @{
+	 */
+
+		/**
+		 * @brief Turn copy-on-write mode on or off for this Matrix.
+		 * @detail Turning it off makes a private copy of the storage if
+		 * 		it's currently shared, so later copies are independent.
+		 */
+		void setCopyOnWrite(bool enabled);
+
+		/**
+		 * @brief Return true if this Matrix is in copy-on-write mode.
+		 */
+		bool copyOnWrite() const;
+
+		/**
+		 * @brief Return true if this Matrix currently shares its storage
+		 * 		with another Matrix.
+		 */
+		bool isShared() const;
+
 	/**
 	 * @}
 	 */
@@ -131,6 +245,9 @@ public:
 	 *
 	 * 		Note that, in order to do this, you have to manipulate the
 	 * 		`contents` `Array2D` storing
+	 *
+	 * 		Resizing to the current size does nothing, so a Matrix that is
+	 * 		refilled in a loop keeps its storage.
 	 */
 	Matrix& resize(size_t num_rows, size_t num_cols);
 
@@ -260,11 +377,48 @@ public:
 	 *				(1 / (ad - bc))	*	[ d	-b]
 	 *									[-a	 c]
 	 *
-	 *		**For this function,** you don't need to handle matrices larger
-	 *		than 2x2.
+	 *		Larger matrices are inverted through an LU decomposition with
+	 *		partial pivoting. Above the configured dispatch threshold, this
+	 *		is routed to the external backend (see `Backend.hpp`).
 	 */
 	Matrix inverse() const;
 
+	/**
+	 * @brief Solve `(*this) * x = rhs` for `x` and return it.
+	 * @detail `rhs` may have any number of columns; each one is solved as a
+	 * 		separate right-hand side. Throws an `std::runtime_error` if this
+	 * 		Matrix isn't square, if the row counts don't match, or if this
+	 * 		Matrix is singular.
+	 *
+	 * 		Prefer this over `inverse() * rhs`: it's cheaper and more
+	 * 		accurate.
+	 */
+	Matrix solve(const Matrix& rhs) const;
+
+	/**
+	 * @brief Return this matrix raised to the power `exponent`.
+	 * @detail Uses repeated squaring, so it takes about `2 * log2(exponent)`
+	 * 		matrix products, all into scratch space allocated once up front.
+	 * 		A zero exponent gives the identity, and a negative one inverts
+	 * 		first. Throws an `std::runtime_error` if this Matrix isn't square
+	 * 		(or, for a negative exponent, is singular).
+	 */
+	Matrix pow(int exponent) const;
+
+	/**
+	 * @brief Return the matrix exponential `e^A` of this matrix.
+	 * @detail Uses scaling and squaring with a Padé approximant (Higham,
+	 * 		2005): `A` is scaled by a power of two until a Padé approximant
+	 * 		of degree at most 13 is accurate to machine precision, which
+	 * 		costs a handful of products and one LU solve, and the result is
+	 * 		then squared back up. Small-normed matrices skip the scaling and
+	 * 		use a lower degree.
+	 *
+	 * 		Throws an `std::runtime_error` if this Matrix isn't square or
+	 * 		has elements that aren't finite.
+	 */
+	Matrix expm() const;
+
 	/**
 	 * @brief Return the transpose of this matrix.
 	 * @detail Return a copy of this matrix, with every element "flipped"
@@ -297,20 +451,41 @@ public:
 
 private:
 
+	/**
+	 * @brief Vector shares storage with `n x 1` and `1 x n` matrices; see
+	 * 		`Vector.hpp`.
+	 */
+	friend class Vector;
+
+	/**
+	 * @brief Return `contents`, first making a private copy of it if it's
+	 * 		shared. Throws if this Matrix is blank.
+	 * @detail Everything that writes into a Matrix's storage goes through
+	 * 		this.
+	 */
+	Array2D& mutableContents();
+
 	/**
 	 * @addtogroup NO_CHANGE Can't Modify These Declarations
 	 * @brief You aren't allowed to modify these variable declarations.
 	 * @detail You will be manipulating the contents of these variables in
 	 * 		your implementation of this class, but you aren't allowed to,
-	 * 		say, replace the `unique_ptr` to an `Array2D` with an
+	 * 		say, replace the `shared_ptr` to an `Array2D` with an
 	 * 		`Eigen::Matrix`.
 	 * @{
 	 */
 
 		/**
 		 * @brief The contents of this matrix as a dynamically-allocated array.
+		 * @detail Only ever shared with other matrices in copy-on-write
+		 * 		mode; otherwise, this Matrix is its only owner.
+		 */
+		std::shared_ptr<Array2D> contents;
+
+		/**
+		 * @brief True if copies of this Matrix should share `contents`.
 		 */
-		std::unique_ptr<Array2D> contents;
+		bool copy_on_write{false};
 
 	/**
 	 * @}
@@ -0,0 +1,489 @@
+#include "Matrix.hpp"
+#include "Backend.hpp"
+#include "Decompositions.hpp"
+#include "Kernels.hpp"
+
+#include <algorithm>	// std::copy, std::fill, std::max, std::swap
+#include <array>		// std::array
+#include <cmath>		// std::abs, std::ceil, std::isfinite, std::ldexp, ...
+#include <stdexcept>	// std::runtime_error
+#include <vector>		// std::vector
+
+using std::runtime_error;
+
+namespace
+{
+
+/**
+ * @brief Square matrices up to this size get code compiled for their exact
+ * 		size, with scratch space on the stack.
+ * @detail Small state-space models are the common case, and at these sizes
+ * 		loop overhead and heap allocation cost more than the arithmetic.
+ */
+constexpr size_t largest_fixed_size = 6;
+
+/**
+ * @brief `count` square, row-major scratch matrices, and the operations
+ * 		that `pow()` and `expm()` need on them, for `N x N` matrices.
+ * @detail The primary template is for a compile-time size `N`; `N == 0`
+ * 		(below) is for any other size.
+ */
+template <size_t N, size_t count>
+class Squares
+{
+public:
+
+	explicit Squares(size_t)
+	{
+	}
+
+	constexpr size_t n() const
+	{
+		return N;
+	}
+
+	double* operator[](size_t i)
+	{
+		return buffers[i].data();
+	}
+
+	/**
+	 * @brief Store `(*this)[lhs] * (*this)[rhs]` in `(*this)[out]`, which
+	 * 		must be a third buffer.
+	 */
+	void multiply(size_t lhs, size_t rhs, size_t out)
+	{
+		const double* a = buffers[lhs].data();
+		const double* b = buffers[rhs].data();
+		double* c = buffers[out].data();
+		std::fill(c, c + N * N, 0.0);
+		for (size_t i = 0; i != N; ++i)
+		{
+			for (size_t k = 0; k != N; ++k)
+			{
+				const double a_ik = a[i * N + k];
+				for (size_t j = 0; j != N; ++j) c[i * N + j] += a_ik * b[k * N + j];
+			}
+		}
+	}
+
+	/**
+	 * @brief Overwrite `(*this)[rhs]` with `inv((*this)[lhs]) * (*this)[rhs]`,
+	 * 		destroying `(*this)[lhs]`.
+	 * @detail Gaussian elimination with partial pivoting.
+	 */
+	void solve(size_t lhs, size_t rhs)
+	{
+		double* a = buffers[lhs].data();
+		double* b = buffers[rhs].data();
+		for (size_t k = 0; k != N; ++k)
+		{
+			size_t pivot = k;
+			for (size_t i = k + 1; i != N; ++i)
+			{
+				if (std::abs(a[i * N + k]) > std::abs(a[pivot * N + k])) pivot = i;
+			}
+			if (a[pivot * N + k] == 0.0) throw runtime_error{"Matrix is singular!"};
+			for (size_t j = 0; j != N and pivot != k; ++j)
+			{
+				std::swap(a[k * N + j], a[pivot * N + j]);
+				std::swap(b[k * N + j], b[pivot * N + j]);
+			}
+
+			for (size_t i = k + 1; i != N; ++i)
+			{
+				const double factor = a[i * N + k] / a[k * N + k];
+				for (size_t j = k + 1; j != N; ++j) a[i * N + j] -= factor * a[k * N + j];
+				for (size_t j = 0; j != N; ++j) b[i * N + j] -= factor * b[k * N + j];
+			}
+		}
+
+		for (size_t k = N; k-- > 0;)
+		{
+			for (size_t i = k + 1; i != N; ++i)
+			{
+				const double a_ki = a[k * N + i];
+				for (size_t j = 0; j != N; ++j) b[k * N + j] -= a_ki * b[i * N + j];
+			}
+			for (size_t j = 0; j != N; ++j) b[k * N + j] /= a[k * N + k];
+		}
+	}
+
+private:
+
+	std::array<std::array<double, N * N>, count> buffers;
+};
+
+template <size_t count>
+class Squares<0, count>
+{
+public:
+
+	explicit Squares(size_t n)
+		: size{n}, buffers(count, Array2D::uninitialized(n, n))
+	{
+	}
+
+	size_t n() const
+	{
+		return size;
+	}
+
+	double* operator[](size_t i)
+	{
+		return buffers[i].data();
+	}
+
+	void multiply(size_t lhs, size_t rhs, size_t out)
+	{
+		if (backend::shouldDispatch(size))
+		{
+			backend::multiply(buffers[lhs], buffers[rhs], buffers[out]);
+			return;
+		}
+
+		double* c = buffers[out].data();
+		std::fill(c, c + size * size, 0.0);
+		kernels::active().gemm(size, size, size, 1.0, buffers[lhs].data(), size,
+							   buffers[rhs].data(), size, c, size);
+	}
+
+	void solve(size_t lhs, size_t rhs)
+	{
+		if (not luFactor(buffers[lhs], pivots))
+		{
+			throw runtime_error{"Matrix is singular!"};
+		}
+		luSolve(buffers[lhs], pivots, buffers[rhs]);
+	}
+
+private:
+
+	const size_t size;
+	std::vector<Array2D> buffers;
+	std::vector<size_t> pivots;
+};
+
+/**
+ * @brief Call `body(squares)` with the `Squares` specialized for `n`, if
+ * 		there is one, or the general one otherwise.
+ */
+template <size_t count, size_t N = largest_fixed_size>
+struct WithSquares
+{
+	template <typename Body>
+	static void run(size_t n, Body& body)
+	{
+		if (n != N) return WithSquares<count, N - 1>::run(n, body);
+
+		Squares<N, count> squares{n};
+		body(squares);
+	}
+};
+
+template <size_t count>
+struct WithSquares<count, 0>
+{
+	template <typename Body>
+	static void run(size_t n, Body& body)
+	{
+		Squares<0, count> squares{n};
+		body(squares);
+	}
+};
+
+/**
+ * @brief Set `squares[out]` to `identity * I` plus the sum of
+ * 		`weights[t] * squares[terms[t]]` over the first `num_used` terms,
+ * 		added onto what's already there if `keep` is true.
+ * @detail `out` must not be one of the `terms`.
+ */
+template <typename Squares, size_t num_terms>
+void combine(Squares& squares, size_t out, bool keep, double identity,
+			 const std::array<double, num_terms>& weights,
+			 const std::array<size_t, num_terms>& terms,
+			 size_t num_used = num_terms)
+{
+	const size_t n = squares.n();
+	double* result = squares[out];
+	std::array<const double*, num_terms> sources;
+	for (size_t t = 0; t != num_used; ++t) sources[t] = squares[terms[t]];
+
+	for (size_t i = 0; i != n * n; ++i)
+	{
+		double value = keep ? result[i] : 0.0;
+		for (size_t t = 0; t != num_used; ++t) value += weights[t] * sources[t][i];
+		result[i] = value;
+	}
+	for (size_t i = 0; i != n; ++i) result[i * n + i] += identity;
+}
+
+/**
+ * @brief Raise `squares[0]` to the power `exponent`, which must be positive,
+ * 		and return the index of the buffer holding the result.
+ * @detail Uses (and overwrites) buffers 0 to 2.
+ */
+template <typename Squares>
+size_t power(Squares& squares, unsigned int exponent)
+{
+	const size_t n = squares.n();
+	size_t base = 0;
+	size_t result = 1;
+	size_t temporary = 2;
+	bool identity = true;
+	while (true)
+	{
+		if (exponent & 1)
+		{
+			if (identity)
+			{
+				std::copy(squares[base], squares[base] + n * n, squares[result]);
+				identity = false;
+			}
+			else
+			{
+				squares.multiply(result, base, temporary);
+				std::swap(result, temporary);
+			}
+		}
+
+		exponent >>= 1;
+		if (exponent == 0) return result;
+		squares.multiply(base, base, temporary);
+		std::swap(base, temporary);
+	}
+}
+
+/**
+ * @brief Buffers used by `exponential()`.
+ */
+enum Buffer : size_t
+{
+	a_1,
+	a_2,
+	a_4,
+	a_6,
+	scratch,
+	even,
+	odd,
+	num_buffers
+};
+
+/**
+ * @brief The largest 1-norms for which the Padé approximants of degree 3, 5,
+ * 		7, 9, and 13 are accurate to double precision (Higham, 2005,
+ * 		Table 2.3).
+ */
+constexpr double theta_3 = 1.495585217958292e-2;
+constexpr double theta_5 = 2.539398330063230e-1;
+constexpr double theta_7 = 9.504178996162932e-1;
+constexpr double theta_9 = 2.097847961257068e0;
+constexpr double theta_13 = 5.371920351148152e0;
+
+/**
+ * @brief The coefficients of the degree-13 Padé approximant's numerator,
+ * 		lowest order first.
+ */
+constexpr double pade_13[] = {
+	64764752532480000.0, 32382376266240000.0, 7771770303897600.0,
+	1187353796428800.0, 129060195264000.0, 10559470521600.0, 670442572800.0,
+	33522128640.0, 1323241920.0, 40840800.0, 960960.0, 16380.0, 182.0, 1.0};
+
+/**
+ * @brief Turn the odd and even parts of a Padé numerator, `U` and `V`, into
+ * 		the approximant `inv(V - U) * (V + U)`, and return the index of the
+ * 		buffer holding it.
+ */
+template <typename Squares>
+size_t padeQuotient(Squares& squares, size_t u, size_t v)
+{
+	const size_t n = squares.n();
+	double* odd_part = squares[u];
+	double* even_part = squares[v];
+	for (size_t i = 0; i != n * n; ++i)
+	{
+		const double sum = even_part[i] + odd_part[i];
+		odd_part[i] = even_part[i] - odd_part[i];
+		even_part[i] = sum;
+	}
+	squares.solve(u, v);
+	return v;
+}
+
+/**
+ * @brief Return the Padé approximant of degree 3, 5, 7, or 9 to the
+ * 		exponential of `squares[a_1]`, whose even powers up to `A^(degree - 1)`
+ * 		have to be computed already, with `A^8` in `scratch`.
+ */
+template <typename Squares>
+size_t padeLow(Squares& squares, size_t degree)
+{
+	static constexpr double coefficients[][10] = {
+		{120.0, 60.0, 12.0, 1.0},
+		{30240.0, 15120.0, 3360.0, 420.0, 30.0, 1.0},
+		{17297280.0, 8648640.0, 1995840.0, 277200.0, 25200.0, 1512.0, 56.0, 1.0},
+		{17643225600.0, 8821612800.0, 2075673600.0, 302702400.0, 30270240.0,
+		 2162160.0, 110880.0, 3960.0, 90.0, 1.0}};
+	const double* b = coefficients[(degree - 3) / 2];
+
+	// U = A * (b_degree A^(degree - 1) + ... + b3 A^2 + b1 I)
+	// V = b_(degree - 1) A^(degree - 1) + ... + b2 A^2 + b0 I
+	const std::array<size_t, 4> powers{{a_2, a_4, a_6, scratch}};
+	const size_t num_powers = (degree - 1) / 2;
+	std::array<double, 4> odd_weights{};
+	std::array<double, 4> even_weights{};
+	for (size_t j = 1; j <= num_powers; ++j)
+	{
+		odd_weights[j - 1] = b[2 * j + 1];
+		even_weights[j - 1] = b[2 * j];
+	}
+
+	combine(squares, even, false, b[1], odd_weights, powers, num_powers);
+	squares.multiply(a_1, even, odd);
+	combine(squares, even, false, b[0], even_weights, powers, num_powers);
+	return padeQuotient(squares, odd, even);
+}
+
+/**
+ * @brief Return the index of the buffer holding the exponential of
+ * 		`squares[a_1]`.
+ */
+template <typename Squares>
+size_t exponential(Squares& squares)
+{
+	const size_t n = squares.n();
+
+	// The 1-norm (the largest column sum) picks the degree and scaling.
+	double norm = 0.0;
+	{
+		const double* a = squares[a_1];
+		std::array<double, largest_fixed_size> fixed_sums{};
+		std::vector<double> sums;
+		double* column_sums = fixed_sums.data();
+		if (n > largest_fixed_size)
+		{
+			sums.assign(n, 0.0);
+			column_sums = sums.data();
+		}
+		for (size_t i = 0; i != n * n; ++i) column_sums[i % n] += std::abs(a[i]);
+		for (size_t j = 0; j != n; ++j) norm = std::max(norm, column_sums[j]);
+		if (not std::isfinite(norm))
+		{
+			throw runtime_error{"Cannot exponentiate a non-finite matrix!"};
+		}
+	}
+
+	if (norm <= theta_9)
+	{
+		squares.multiply(a_1, a_1, a_2);
+		if (norm <= theta_3) return padeLow(squares, 3);
+		squares.multiply(a_2, a_2, a_4);
+		if (norm <= theta_5) return padeLow(squares, 5);
+		squares.multiply(a_4, a_2, a_6);
+		if (norm <= theta_7) return padeLow(squares, 7);
+		squares.multiply(a_6, a_2, scratch);
+		return padeLow(squares, 9);
+	}
+
+	// Scale A by 2^-s (exactly, being a power of two) to bring its norm
+	// under `theta_13`, and only then form its powers: A^6 of the unscaled
+	// A overflows once its norm passes about 1e51, even where e^A is still
+	// representable.
+	const int s = norm > theta_13
+		? static_cast<int>(std::ceil(std::log2(norm / theta_13))) : 0;
+	double* scaled = squares[a_1];
+	for (size_t i = 0; i != n * n and s != 0; ++i)
+	{
+		scaled[i] = std::ldexp(scaled[i], -s);
+	}
+	squares.multiply(a_1, a_1, a_2);
+	squares.multiply(a_2, a_2, a_4);
+	squares.multiply(a_4, a_2, a_6);
+
+	// U = A * (A^6 * (b13 A^6 + b11 A^4 + b9 A^2) + b7 A^6 + ... + b1 I)
+	// V = A^6 * (b12 A^6 + b10 A^4 + b8 A^2) + b6 A^6 + ... + b0 I
+	const double* b = pade_13;
+	const std::array<size_t, 3> even_powers{{a_6, a_4, a_2}};
+	combine(squares, scratch, false, 0.0,
+			std::array<double, 3>{{b[13], b[11], b[9]}}, even_powers);
+	squares.multiply(a_6, scratch, even);
+	combine(squares, even, true, b[1],
+			std::array<double, 3>{{b[7], b[5], b[3]}}, even_powers);
+	squares.multiply(a_1, even, odd);
+	combine(squares, scratch, false, 0.0,
+			std::array<double, 3>{{b[12], b[10], b[8]}}, even_powers);
+	squares.multiply(a_6, scratch, even);
+	combine(squares, even, true, b[0],
+			std::array<double, 3>{{b[6], b[4], b[2]}}, even_powers);
+
+	size_t result = padeQuotient(squares, odd, even);
+	size_t spare = scratch;
+	for (int i = 0; i != s; ++i)
+	{
+		squares.multiply(result, result, spare);
+		std::swap(result, spare);
+	}
+	return result;
+}
+
+} // anonymous namespace
+
+Matrix Matrix::pow(int exponent) const
+{
+	const size_t n = size().first;
+	if (n != size().second)
+	{
+		throw runtime_error{"Cannot raise a non-square matrix to a power!"};
+	}
+	if (exponent < 0)
+	{
+		// Negating the smallest int overflows, so take one factor out first.
+		const Matrix inverted = inverse();
+		return inverted.pow(-(exponent + 1)) * inverted;
+	}
+
+	Matrix result{n, n, layout()};
+	double* result_vals = result.data();
+	if (exponent == 0)
+	{
+		for (size_t i = 0; i != n; ++i) result_vals[i * n + i] = 1.0;
+		return result;
+	}
+	if (n == 0) return result;
+
+	// Powers of A' are the transposes of powers of A, so the storage can be
+	// treated as row-major whatever its layout.
+	const double* vals = data();
+	auto body = [&](auto& squares) {
+		std::copy(vals, vals + n * n, squares[0]);
+		const size_t power_index = power(squares, exponent);
+		std::copy(squares[power_index], squares[power_index] + n * n,
+				  result_vals);
+	};
+	WithSquares<3>::run(n, body);
+	return result;
+}
+
+Matrix Matrix::expm() const
+{
+	const size_t n = size().first;
+	if (n != size().second)
+	{
+		throw runtime_error{"Cannot exponentiate a non-square matrix!"};
+	}
+
+	Matrix result{n, n, layout()};
+	if (n == 0) return result;
+
+	// As in `pow()`, e^(A') = (e^A)', so either layout works as is.
+	const double* vals = data();
+	double* result_vals = result.data();
+	auto body = [&](auto& squares) {
+		std::copy(vals, vals + n * n, squares[a_1]);
+		const size_t exponential_index = exponential(squares);
+		std::copy(squares[exponential_index],
+				  squares[exponential_index] + n * n, result_vals);
+	};
+	WithSquares<num_buffers>::run(n, body);
+	return result;
+}
@@ -0,0 +1,510 @@
+#include "PackedMatrix.hpp"
+#include "Kernels.hpp"
+#include "Parallel.hpp"
+
+#include <algorithm>	// std::min
+#include <stdexcept>	// std::runtime_error
+#include <utility>		// std::swap
+#include <vector>		// std::vector
+
+using std::runtime_error;
+
+namespace
+{
+
+constexpr size_t block_size = PackedTriangle::block_size;
+
+/**
+ * @brief The minimum number of right-hand-side columns per thread.
+ */
+constexpr size_t column_grain = 32;
+
+/**
+ * @brief Convert one-based indices to zero-based ones, checking them.
+ */
+void checkIndices(size_t& row, size_t& col, size_t n)
+{
+	if (row == 0 or col == 0)
+	{
+		throw runtime_error{"Matrix indices start from one!"};
+	}
+	if (row > n or col > n)
+	{
+		throw runtime_error{"Matrix index out of range!"};
+	}
+	--row;
+	--col;
+}
+
+void checkSquare(const Matrix& dense)
+{
+	if (dense.size().first != dense.size().second)
+	{
+		throw runtime_error{"Cannot pack a non-square matrix!"};
+	}
+}
+
+void checkRhs(const Matrix& rhs, size_t n)
+{
+	if (n == 0)
+	{
+		throw runtime_error{"Operation invoked on a blank Matrix!"};
+	}
+	if (rhs.size().first != n)
+	{
+		throw runtime_error{"Matrix dimensions are invalid for multiplication!"};
+	}
+}
+
+/**
+ * @brief Split the columns of a right-hand side among the worker threads.
+ * @detail `body(first_col, num_cols, scratch, scratch2)` gets two private
+ * 		`block_size x block_size` buffers.
+ */
+template <typename Body>
+void forColumns(size_t num_cols, Body body)
+{
+	parallel::forRange(0, num_cols, column_grain, [&](size_t first, size_t last) {
+		std::vector<double> scratch(block_size * block_size);
+		std::vector<double> scratch2(block_size * block_size);
+		body(first, last - first, scratch.data(), scratch2.data());
+	});
+}
+
+} // anonymous namespace
+
+//---------------------------------------------------------------------
+// PackedTriangle
+//---------------------------------------------------------------------
+
+constexpr size_t PackedTriangle::block_size;
+
+PackedTriangle::PackedTriangle(size_t n)
+	: n{n}, values(n * (n + 1) / 2, 0.0)
+{
+}
+
+size_t PackedTriangle::numBlocks() const
+{
+	return (n + block_size - 1) / block_size;
+}
+
+size_t PackedTriangle::blockRows(size_t block) const
+{
+	return std::min(block_size, n - block * block_size);
+}
+
+size_t PackedTriangle::blockRowStart(size_t block) const
+{
+	// Every earlier block-row is full height: `block` of them hold
+	// 0 + 1 + ... + (block - 1) off-diagonal tiles plus one diagonal tile.
+	return block_size * block_size * (block * (block - 1) / 2)
+		 + block * (block_size * (block_size + 1) / 2);
+}
+
+size_t PackedTriangle::offset(size_t row, size_t col) const
+{
+	const size_t block_row = row / block_size;
+	const size_t block_col = col / block_size;
+	const size_t r = row % block_size;
+	const size_t c = col % block_size;
+	const size_t start = blockRowStart(block_row);
+	const size_t rows = blockRows(block_row);
+
+	if (block_col < block_row)
+	{
+		return start + block_col * rows * block_size + r * block_size + c;
+	}
+	return start + block_row * rows * block_size + r * (r + 1) / 2 + c;
+}
+
+const double* PackedTriangle::tile(size_t block_row, size_t block_col) const
+{
+	return values.data() + blockRowStart(block_row)
+		 + block_col * blockRows(block_row) * block_size;
+}
+
+double* PackedTriangle::tile(size_t block_row, size_t block_col)
+{
+	return values.data() + blockRowStart(block_row)
+		 + block_col * blockRows(block_row) * block_size;
+}
+
+void PackedTriangle::unpackDiagonal(size_t block, double* out,
+									bool mirror) const
+{
+	const size_t rows = blockRows(block);
+	const double* packed = tile(block, block);
+
+	for (size_t r = 0; r != rows; ++r)
+	{
+		const double* packed_row = packed + r * (r + 1) / 2;
+		for (size_t c = 0; c <= r; ++c)
+		{
+			out[r * rows + c] = packed_row[c];
+			if (mirror) out[c * rows + r] = packed_row[c];
+		}
+		if (not mirror)
+		{
+			for (size_t c = r + 1; c < rows; ++c) out[r * rows + c] = 0.0;
+		}
+	}
+}
+
+//---------------------------------------------------------------------
+// SymmetricMatrix
+//---------------------------------------------------------------------
+
+SymmetricMatrix::SymmetricMatrix(size_t n)
+	: storage{n}, matrix_size{n, n}
+{
+}
+
+SymmetricMatrix SymmetricMatrix::fromDense(const Matrix& dense)
+{
+	checkSquare(dense);
+	const size_t n = dense.size().first;
+	SymmetricMatrix packed{n};
+
+	const Matrix row_major = dense.toLayout(Layout::RowMajor);
+	const double* vals = row_major.data();
+	for (size_t row = 0; row != n; ++row)
+	{
+		for (size_t col = 0; col <= row; ++col)
+		{
+			packed.storage[packed.storage.offset(row, col)] = vals[row * n + col];
+		}
+	}
+	return packed;
+}
+
+Matrix SymmetricMatrix::toDense() const
+{
+	const size_t n = matrix_size.first;
+	Matrix dense{n, n};
+
+	double* vals = dense.data();
+	for (size_t row = 0; row != n; ++row)
+	{
+		for (size_t col = 0; col <= row; ++col)
+		{
+			const double value = storage[storage.offset(row, col)];
+			vals[row * n + col] = value;
+			vals[col * n + row] = value;
+		}
+	}
+	return dense;
+}
+
+const SymmetricMatrix::SizePair& SymmetricMatrix::size() const
+{
+	return matrix_size;
+}
+
+size_t SymmetricMatrix::numStored() const
+{
+	return storage.numStored();
+}
+
+double& SymmetricMatrix::operator()(size_t row, size_t col)
+{
+	checkIndices(row, col, matrix_size.first);
+	if (row < col) std::swap(row, col);
+	return storage[storage.offset(row, col)];
+}
+
+double SymmetricMatrix::operator()(size_t row, size_t col) const
+{
+	checkIndices(row, col, matrix_size.first);
+	if (row < col) std::swap(row, col);
+	return storage[storage.offset(row, col)];
+}
+
+Matrix SymmetricMatrix::operator*(const Matrix& rhs) const
+{
+	const size_t n = matrix_size.first;
+	checkRhs(rhs, n);
+
+	const size_t p = rhs.size().second;
+	Matrix result{n, p};
+	const Matrix row_major = rhs.toLayout(Layout::RowMajor);
+	const double* x = row_major.data();
+	double* y = result.data();
+	const kernels::KernelTable& kernel = kernels::active();
+
+	forColumns(p, [&](size_t c0, size_t cols, double* scratch, double*) {
+		for (size_t i = 0; i != storage.numBlocks(); ++i)
+		{
+			const size_t i0 = i * block_size;
+			const size_t rows = storage.blockRows(i);
+
+			// Each stored tile below the diagonal also stands in for its
+			// mirror image above it.
+			for (size_t j = 0; j != i; ++j)
+			{
+				const size_t j0 = j * block_size;
+				const double* t = storage.tile(i, j);
+				kernel.gemm(rows, cols, block_size, 1.0, t, block_size,
+							x + j0 * p + c0, p, y + i0 * p + c0, p);
+
+				kernel.transpose(rows, block_size, t, block_size, scratch, rows);
+				kernel.gemm(block_size, cols, rows, 1.0, scratch, rows,
+							x + i0 * p + c0, p, y + j0 * p + c0, p);
+			}
+
+			storage.unpackDiagonal(i, scratch, true);
+			kernel.gemm(rows, cols, rows, 1.0, scratch, rows,
+						x + i0 * p + c0, p, y + i0 * p + c0, p);
+		}
+	});
+
+	return result;
+}
+
+//---------------------------------------------------------------------
+// TriangularMatrix
+//---------------------------------------------------------------------
+
+TriangularMatrix::TriangularMatrix(size_t n, Triangle triangle)
+	: storage{n}, matrix_size{n, n}, which{triangle}
+{
+}
+
+TriangularMatrix TriangularMatrix::fromDense(const Matrix& dense,
+											 Triangle triangle)
+{
+	checkSquare(dense);
+	const size_t n = dense.size().first;
+	TriangularMatrix packed{n, triangle};
+
+	// Upper-triangular matrices are stored as their (lower) transpose.
+	const bool lower = triangle == Triangle::Lower;
+	const Matrix row_major = dense.toLayout(Layout::RowMajor);
+	const double* vals = row_major.data();
+	for (size_t row = 0; row != n; ++row)
+	{
+		for (size_t col = 0; col <= row; ++col)
+		{
+			packed.storage[packed.storage.offset(row, col)] =
+				lower ? vals[row * n + col] : vals[col * n + row];
+		}
+	}
+	return packed;
+}
+
+Matrix TriangularMatrix::toDense() const
+{
+	const size_t n = matrix_size.first;
+	Matrix dense{n, n};
+
+	const bool lower = which == Triangle::Lower;
+	double* vals = dense.data();
+	for (size_t row = 0; row != n; ++row)
+	{
+		for (size_t col = 0; col <= row; ++col)
+		{
+			const double value = storage[storage.offset(row, col)];
+			if (lower) vals[row * n + col] = value;
+			else vals[col * n + row] = value;
+		}
+	}
+	return dense;
+}
+
+Triangle TriangularMatrix::triangle() const
+{
+	return which;
+}
+
+const TriangularMatrix::SizePair& TriangularMatrix::size() const
+{
+	return matrix_size;
+}
+
+size_t TriangularMatrix::numStored() const
+{
+	return storage.numStored();
+}
+
+bool TriangularMatrix::isStored(size_t row, size_t col) const
+{
+	return which == Triangle::Lower ? row >= col : row <= col;
+}
+
+double& TriangularMatrix::operator()(size_t row, size_t col)
+{
+	checkIndices(row, col, matrix_size.first);
+	if (not isStored(row, col))
+	{
+		throw runtime_error{"Cannot modify the zero triangle!"};
+	}
+	if (row < col) std::swap(row, col);
+	return storage[storage.offset(row, col)];
+}
+
+double TriangularMatrix::operator()(size_t row, size_t col) const
+{
+	checkIndices(row, col, matrix_size.first);
+	if (not isStored(row, col)) return 0.0;
+	if (row < col) std::swap(row, col);
+	return storage[storage.offset(row, col)];
+}
+
+TriangularMatrix TriangularMatrix::transpose() const
+{
+	TriangularMatrix result{*this};
+	result.which = which == Triangle::Lower ? Triangle::Upper : Triangle::Lower;
+	return result;
+}
+
+Matrix TriangularMatrix::operator*(const Matrix& rhs) const
+{
+	const size_t n = matrix_size.first;
+	checkRhs(rhs, n);
+
+	const size_t p = rhs.size().second;
+	Matrix result{n, p};
+	const Matrix row_major = rhs.toLayout(Layout::RowMajor);
+	const double* x = row_major.data();
+	double* y = result.data();
+	const kernels::KernelTable& kernel = kernels::active();
+	const bool lower = which == Triangle::Lower;
+
+	forColumns(p, [&](size_t c0, size_t cols, double* scratch,
+					  double* scratch2) {
+		for (size_t i = 0; i != storage.numBlocks(); ++i)
+		{
+			const size_t i0 = i * block_size;
+			const size_t rows = storage.blockRows(i);
+
+			for (size_t j = 0; j != i; ++j)
+			{
+				const size_t j0 = j * block_size;
+				const double* t = storage.tile(i, j);
+				if (lower)
+				{
+					kernel.gemm(rows, cols, block_size, 1.0, t, block_size,
+								x + j0 * p + c0, p, y + i0 * p + c0, p);
+				}
+				else
+				{
+					kernel.transpose(rows, block_size, t, block_size,
+									 scratch, rows);
+					kernel.gemm(block_size, cols, rows, 1.0, scratch, rows,
+								x + i0 * p + c0, p, y + j0 * p + c0, p);
+				}
+			}
+
+			storage.unpackDiagonal(i, scratch, false);
+			const double* diag = scratch;
+			if (not lower)
+			{
+				kernel.transpose(rows, rows, scratch, rows, scratch2, rows);
+				diag = scratch2;
+			}
+			kernel.gemm(rows, cols, rows, 1.0, diag, rows,
+						x + i0 * p + c0, p, y + i0 * p + c0, p);
+		}
+	});
+
+	return result;
+}
+
+Matrix TriangularMatrix::solve(const Matrix& rhs) const
+{
+	const size_t n = matrix_size.first;
+	checkRhs(rhs, n);
+	for (size_t k = 0; k != n; ++k)
+	{
+		if (storage[storage.offset(k, k)] == 0.0)
+		{
+			throw runtime_error{"Matrix is singular!"};
+		}
+	}
+
+	const size_t p = rhs.size().second;
+	Matrix result = rhs.toLayout(Layout::RowMajor);
+	double* x = result.data();
+	const kernels::KernelTable& kernel = kernels::active();
+	const size_t num_blocks = storage.numBlocks();
+
+	// Both directions work a block-row at a time: subtract the contributions
+	// of the blocks that are already solved with GEMMs, then substitute
+	// within the diagonal tile.
+	if (which == Triangle::Lower)
+	{
+		forColumns(p, [&](size_t c0, size_t cols, double*, double*) {
+			for (size_t i = 0; i != num_blocks; ++i)
+			{
+				const size_t i0 = i * block_size;
+				const size_t rows = storage.blockRows(i);
+				double* x_i = x + i0 * p + c0;
+
+				for (size_t j = 0; j != i; ++j)
+				{
+					kernel.gemm(rows, cols, block_size, -1.0, storage.tile(i, j),
+								block_size, x + j * block_size * p + c0, p,
+								x_i, p);
+				}
+
+				for (size_t r = 0; r != rows; ++r)
+				{
+					double* x_row = x_i + r * p;
+					for (size_t c = 0; c != r; ++c)
+					{
+						const double l = storage[storage.offset(i0 + r, i0 + c)];
+						const double* x_c = x_i + c * p;
+						for (size_t col = 0; col != cols; ++col)
+						{
+							x_row[col] -= l * x_c[col];
+						}
+					}
+					const double inv_diag =
+						1.0 / storage[storage.offset(i0 + r, i0 + r)];
+					for (size_t col = 0; col != cols; ++col) x_row[col] *= inv_diag;
+				}
+			}
+		});
+	}
+	else
+	{
+		forColumns(p, [&](size_t c0, size_t cols, double* scratch, double*) {
+			for (size_t i = num_blocks; i-- > 0;)
+			{
+				const size_t i0 = i * block_size;
+				const size_t rows = storage.blockRows(i);
+				double* x_i = x + i0 * p + c0;
+
+				// Row block `i` of the upper triangle is column block `i` of
+				// the stored lower triangle.
+				for (size_t j = i + 1; j < num_blocks; ++j)
+				{
+					const size_t j_rows = storage.blockRows(j);
+					kernel.transpose(j_rows, block_size, storage.tile(j, i),
+									 block_size, scratch, j_rows);
+					kernel.gemm(rows, cols, j_rows, -1.0, scratch, j_rows,
+								x + j * block_size * p + c0, p, x_i, p);
+				}
+
+				for (size_t r = rows; r-- > 0;)
+				{
+					double* x_row = x_i + r * p;
+					for (size_t c = r + 1; c < rows; ++c)
+					{
+						const double u = storage[storage.offset(i0 + c, i0 + r)];
+						const double* x_c = x_i + c * p;
+						for (size_t col = 0; col != cols; ++col)
+						{
+							x_row[col] -= u * x_c[col];
+						}
+					}
+					const double inv_diag =
+						1.0 / storage[storage.offset(i0 + r, i0 + r)];
+					for (size_t col = 0; col != cols; ++col) x_row[col] *= inv_diag;
+				}
+			}
+		});
+	}
+
+	return result;
+}
@@ -0,0 +1,248 @@
+#ifndef MAAV_PROJECT_3_PACKED_MATRIX_HPP
+#define MAAV_PROJECT_3_PACKED_MATRIX_HPP
+
+#include "Matrix.hpp"
+
+#include <cstdlib>	// size_t
+#include <utility>	// std::pair
+#include <vector>	// std::vector
+
+/**
+ * @brief Storage for one triangle of a square matrix, `n * (n + 1) / 2`
+ * 		elements in a cache-friendly blocked layout.
+ * @detail The lower triangle is cut into `block_size x block_size` tiles.
+ * 		Tiles are stored one block-row after another. Off-diagonal tiles are
+ * 		stored in full, row-major, so that the kernels can run on them
+ * 		as they would on any other dense block. Tiles on the diagonal only
+ * 		store their own lower triangle, so nothing above the diagonal takes
+ * 		up memory.
+ *
+ * 		This is an implementation detail of SymmetricMatrix and
+ * 		TriangularMatrix; indices here start from zero.
+ */
+class PackedTriangle
+{
+public:
+
+	/**
+	 * @brief The side length of one tile.
+	 */
+	static constexpr size_t block_size = 32;
+
+	PackedTriangle() = default;
+
+	/**
+	 * @brief Create zero-initialized storage for an `n x n` triangle.
+	 */
+	explicit PackedTriangle(size_t n);
+
+	/**
+	 * @brief Return the side length of the matrix.
+	 */
+	size_t dim() const { return n; }
+
+	/**
+	 * @brief Return the number of stored elements, `n * (n + 1) / 2`.
+	 */
+	size_t numStored() const { return values.size(); }
+
+	/**
+	 * @brief Return the position of lower-triangle element `(row, col)`.
+	 * @detail Requires `row >= col`.
+	 */
+	size_t offset(size_t row, size_t col) const;
+
+	/**
+	 * @brief Return a pointer to the first element of the off-diagonal tile
+	 * 		in block-row `block_row` and block-column `block_col`.
+	 * @detail Requires `block_row > block_col`. The tile is row-major, with
+	 * 		a leading dimension of `block_size`.
+	 */
+	const double* tile(size_t block_row, size_t block_col) const;
+	double* tile(size_t block_row, size_t block_col);
+
+	/**
+	 * @brief Write diagonal tile `block` into the dense, row-major
+	 * 		`rows x rows` array `out`, where `rows` is the tile's height.
+	 * @param mirror	If true, also fill in the upper triangle of `out`, so
+	 * 					that it's symmetric. Otherwise, the upper triangle is
+	 * 					zeroed.
+	 */
+	void unpackDiagonal(size_t block, double* out, bool mirror) const;
+
+	/**
+	 * @brief Return the number of rows in block-row `block`.
+	 */
+	size_t blockRows(size_t block) const;
+
+	/**
+	 * @brief Return the number of block-rows.
+	 */
+	size_t numBlocks() const;
+
+	double& operator[](size_t index) { return values[index]; }
+	double operator[](size_t index) const { return values[index]; }
+
+private:
+
+	/**
+	 * @brief Return the position of the first element of block-row `block`.
+	 */
+	size_t blockRowStart(size_t block) const;
+
+	size_t n{0};
+	std::vector<double> values;
+};
+
+/**
+ * @brief Which triangle of a square matrix holds its nonzero elements.
+ */
+enum class Triangle
+{
+	Lower,
+	Upper
+};
+
+/**
+ * @brief A symmetric matrix that only stores one of its triangles.
+ * @detail Uses about half the memory (and memory bandwidth) of a Matrix of
+ * 		the same size. Like Matrix, `operator()` indexes from one; `(i, j)`
+ * 		and `(j, i)` refer to the same element.
+ */
+class SymmetricMatrix
+{
+	using SizePair = std::pair<size_t, size_t>;
+
+public:
+
+	SymmetricMatrix() = default;
+
+	/**
+	 * @brief Create a zero-initialized `n x n` symmetric matrix.
+	 */
+	explicit SymmetricMatrix(size_t n);
+
+	/**
+	 * @brief Pack a dense, square Matrix.
+	 * @detail Only the lower triangle of `dense` is read. Throws an
+	 * 		`std::runtime_error` if `dense` isn't square.
+	 */
+	static SymmetricMatrix fromDense(const Matrix& dense);
+
+	/**
+	 * @brief Return a dense copy of this matrix, with both triangles filled.
+	 */
+	Matrix toDense() const;
+
+	/**
+	 * @brief Return this matrix's size as an `(n, n)` pair.
+	 */
+	const SizePair& size() const;
+
+	/**
+	 * @brief Return the number of elements actually stored.
+	 */
+	size_t numStored() const;
+
+	double& operator()(size_t row, size_t col);
+	double operator()(size_t row, size_t col) const;
+
+	/**
+	 * @brief Return the product of this matrix with a dense Matrix.
+	 * @detail Throws an `std::runtime_error` if the sizes don't match.
+	 */
+	Matrix operator*(const Matrix& rhs) const;
+
+private:
+
+	PackedTriangle storage;
+	SizePair matrix_size{0, 0};
+};
+
+/**
+ * @brief A lower- or upper-triangular matrix that only stores its nonzero
+ * 		triangle.
+ * @detail `operator()` indexes from one. Reading from the zero triangle
+ * 		returns zero; trying to modify it throws an `std::runtime_error`.
+ *
+ * 		Upper-triangular matrices are stored as the transpose of a
+ * 		lower-triangular one, so `transpose()` only relabels the storage.
+ */
+class TriangularMatrix
+{
+	using SizePair = std::pair<size_t, size_t>;
+
+public:
+
+	TriangularMatrix() = default;
+
+	/**
+	 * @brief Create a zero-initialized `n x n` triangular matrix.
+	 */
+	TriangularMatrix(size_t n, Triangle triangle);
+
+	/**
+	 * @brief Pack the given triangle of a dense, square Matrix.
+	 * @detail Elements outside of `triangle` are ignored. Throws an
+	 * 		`std::runtime_error` if `dense` isn't square.
+	 */
+	static TriangularMatrix fromDense(const Matrix& dense, Triangle triangle);
+
+	/**
+	 * @brief Return a dense copy of this matrix, zeroes included.
+	 */
+	Matrix toDense() const;
+
+	/**
+	 * @brief Return which triangle holds this matrix's elements.
+	 */
+	Triangle triangle() const;
+
+	/**
+	 * @brief Return this matrix's size as an `(n, n)` pair.
+	 */
+	const SizePair& size() const;
+
+	/**
+	 * @brief Return the number of elements actually stored.
+	 */
+	size_t numStored() const;
+
+	double& operator()(size_t row, size_t col);
+	double operator()(size_t row, size_t col) const;
+
+	/**
+	 * @brief Return the transpose of this matrix.
+	 * @detail The transpose of a lower-triangular matrix is upper-triangular
+	 * 		and vice versa. No elements are moved.
+	 */
+	TriangularMatrix transpose() const;
+
+	/**
+	 * @brief Return the product of this matrix with a dense Matrix.
+	 * @detail Throws an `std::runtime_error` if the sizes don't match.
+	 */
+	Matrix operator*(const Matrix& rhs) const;
+
+	/**
+	 * @brief Solve `(*this) * x = rhs` for `x` by forward or back
+	 * 		substitution, and return it.
+	 * @detail Each column of `rhs` is a separate right-hand side. Throws an
+	 * 		`std::runtime_error` if the sizes don't match or if a diagonal
+	 * 		element is zero.
+	 */
+	Matrix solve(const Matrix& rhs) const;
+
+private:
+
+	/**
+	 * @brief True if `(row, col)` (zero-indexed) is in the stored triangle.
+	 */
+	bool isStored(size_t row, size_t col) const;
+
+	PackedTriangle storage;
+	SizePair matrix_size{0, 0};
+	Triangle which{Triangle::Lower};
+};
+
+#endif
@@ -0,0 +1,232 @@
+#include "Parallel.hpp"
+
+#include <atomic>				// std::atomic
+#include <condition_variable>	// std::condition_variable
+#include <cstdlib>				// std::getenv, std::strtoul
+#include <exception>			// std::exception_ptr
+#include <memory>				// std::unique_ptr
+#include <mutex>				// std::mutex, std::unique_lock
+#include <thread>				// std::thread
+#include <vector>				// std::vector
+
+namespace
+{
+
+/**
+ * @brief True on threads that are currently running a `forRange()` slice.
+ */
+thread_local bool inside_parallel_region{false};
+
+/**
+ * @brief A fixed set of worker threads that run one job at a time.
+ * @detail Worker `i` always runs slice `i` of a job; the thread that
+ * 		submitted the job runs slice zero.
+ */
+class WorkerPool
+{
+public:
+
+	explicit WorkerPool(size_t num_workers)
+	{
+		for (size_t id = 1; id <= num_workers; ++id)
+		{
+			workers.emplace_back([this, id]{ workerLoop(id); });
+		}
+	}
+
+	~WorkerPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock{mutex};
+			stopping = true;
+		}
+		wake.notify_all();
+		for (std::thread& worker : workers) worker.join();
+	}
+
+	/**
+	 * @brief Run `task(slice)` for every slice in `[0, num_slices)`.
+	 * @detail `num_slices` must not exceed the number of workers plus one.
+	 */
+	void run(size_t num_slices, parallel::FunctionRef<void(size_t)> task)
+	{
+		{
+			std::lock_guard<std::mutex> lock{mutex};
+			current_task = &task;
+			current_slices = num_slices;
+			pending = workers.size();
+			error = nullptr;
+			++generation;
+		}
+		wake.notify_all();
+
+		runSlice(task, 0);
+
+		std::unique_lock<std::mutex> lock{mutex};
+		finished.wait(lock, [this]{ return pending == 0; });
+		current_task = nullptr;
+		if (error) std::rethrow_exception(error);
+	}
+
+	size_t size() const
+	{
+		return workers.size();
+	}
+
+private:
+
+	void workerLoop(size_t id)
+	{
+		size_t seen_generation = 0;
+		while (true)
+		{
+			const parallel::FunctionRef<void(size_t)>* task = nullptr;
+			size_t num_slices = 0;
+			{
+				std::unique_lock<std::mutex> lock{mutex};
+				wake.wait(lock, [&]{
+					return stopping or generation != seen_generation;
+				});
+				if (stopping) return;
+				seen_generation = generation;
+				task = current_task;
+				num_slices = current_slices;
+			}
+
+			if (id < num_slices) runSlice(*task, id);
+
+			std::lock_guard<std::mutex> lock{mutex};
+			if (--pending == 0) finished.notify_one();
+		}
+	}
+
+	void runSlice(parallel::FunctionRef<void(size_t)> task, size_t slice)
+	{
+		inside_parallel_region = true;
+		try
+		{
+			task(slice);
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lock{mutex};
+			if (not error) error = std::current_exception();
+		}
+		inside_parallel_region = false;
+	}
+
+	std::vector<std::thread> workers;
+
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable finished;
+
+	const parallel::FunctionRef<void(size_t)>* current_task{nullptr};
+	size_t current_slices{0};
+	size_t generation{0};
+	size_t pending{0};
+	bool stopping{false};
+	std::exception_ptr error;
+};
+
+/**
+ * @brief Guards `pool`, and serializes jobs.
+ */
+std::mutex pool_mutex;
+std::unique_ptr<WorkerPool> pool;
+
+/**
+ * @brief The configured thread count, or zero if it hasn't been decided yet.
+ */
+std::atomic<size_t> thread_count{0};
+
+size_t defaultThreadCount()
+{
+	const char* from_env = std::getenv("MLE_NUM_THREADS");
+	if (from_env != nullptr)
+	{
+		const unsigned long requested = std::strtoul(from_env, nullptr, 10);
+		if (requested > 0) return requested;
+	}
+	const unsigned hardware = std::thread::hardware_concurrency();
+	return hardware > 0 ? hardware : 1;
+}
+
+/**
+ * @brief Return the pool, creating it if necessary.
+ * @detail Must be called with `pool_mutex` held.
+ */
+WorkerPool& lockedPool()
+{
+	const size_t threads = parallel::numThreads();
+	if (not pool or pool->size() + 1 != threads)
+	{
+		pool.reset();
+		pool.reset(new WorkerPool{threads - 1});
+	}
+	return *pool;
+}
+
+} // anonymous namespace
+
+namespace parallel
+{
+
+size_t numThreads()
+{
+	size_t threads = thread_count.load(std::memory_order_relaxed);
+	if (threads == 0)
+	{
+		threads = defaultThreadCount();
+		thread_count.store(threads, std::memory_order_relaxed);
+	}
+	return threads;
+}
+
+void setNumThreads(size_t num_threads)
+{
+	std::lock_guard<std::mutex> lock{pool_mutex};
+	thread_count.store(num_threads, std::memory_order_relaxed);
+	pool.reset();
+}
+
+size_t numSlices(size_t begin, size_t end, size_t grain)
+{
+	if (end <= begin) return 0;
+	const size_t length = end - begin;
+	const size_t by_grain = grain > 0 ? length / grain : length;
+	const size_t threads = numThreads();
+	if (by_grain <= 1) return 1;
+	return by_grain < threads ? by_grain : threads;
+}
+
+void forRange(size_t begin, size_t end, size_t grain,
+			  FunctionRef<void(size_t, size_t)> body)
+{
+	if (end <= begin) return;
+
+	const size_t length = end - begin;
+	const size_t slices =
+		inside_parallel_region ? 1 : numSlices(begin, end, grain);
+	if (slices <= 1)
+	{
+		body(begin, end);
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock{pool_mutex, std::try_to_lock};
+	if (not lock.owns_lock())
+	{
+		// Another thread is using the pool; don't wait for it.
+		body(begin, end);
+		return;
+	}
+
+	const auto slice_body = [&](size_t slice) {
+		body(begin + slice * length / slices,
+			 begin + (slice + 1) * length / slices);
+	};
+	lockedPool().run(slices, slice_body);
+}
+
+} // namespace parallel
@@ -0,0 +1,109 @@
+#ifndef MAAV_PROJECT_3_PARALLEL_HPP
+#define MAAV_PROJECT_3_PARALLEL_HPP
+
+#include <cstdlib>		// size_t
+#include <memory>		// std::addressof
+#include <type_traits>	// std::decay, std::enable_if, std::is_same
+#include <utility>		// std::forward
+
+/**
+ * @brief The library's shared worker threads.
+ * @detail Kernels that are worth splitting across cores call `forRange()`,
+ * 		which hands contiguous slices of an index range to a pool of
+ * 		persistent threads. Starting a thread costs tens of microseconds, so
+ * 		the pool is created once and reused.
+ *
+ * 		The split is static: with `t` threads, slice `i` always covers the
+ * 		same indices and always runs on the same thread. Memory that one
+ * 		kernel initializes is therefore touched by the same threads that the
+ * 		next kernel uses on it.
+ *
+ * 		The thread count defaults to the number of hardware threads, and can
+ * 		be overridden with the `MLE_NUM_THREADS` environment variable or
+ * 		with `setNumThreads()`.
+ */
+namespace parallel
+{
+
+template <typename Signature>
+class FunctionRef;
+
+/**
+ * @brief A non-owning reference to a callable, for passing lambdas to
+ * 		`forRange()` without allocating.
+ * @detail `std::function` copies its target, and a lambda that captures
+ * 		more than a couple of references doesn't fit in its inline buffer,
+ * 		so every call would go to the heap. This only stores the callable's
+ * 		address, so the callable must outlive it; a lambda written in the
+ * 		call to `forRange()` always does.
+ */
+template <typename Result, typename... Args>
+class FunctionRef<Result(Args...)>
+{
+public:
+
+	template <typename Callable, typename = typename std::enable_if<
+		not std::is_same<typename std::decay<Callable>::type,
+						 FunctionRef>::value>::type>
+	FunctionRef(Callable&& callable)
+		: object{const_cast<void*>(
+			  static_cast<const void*>(std::addressof(callable)))},
+		  call{&invoke<typename std::remove_reference<Callable>::type>}
+	{
+	}
+
+	Result operator()(Args... args) const
+	{
+		return call(object, std::forward<Args>(args)...);
+	}
+
+private:
+
+	template <typename Callable>
+	static Result invoke(void* object, Args... args)
+	{
+		return (*static_cast<Callable*>(object))(std::forward<Args>(args)...);
+	}
+
+	void* object;
+	Result (*call)(void*, Args...);
+};
+
+/**
+ * @brief Return the number of threads (including the caller) that
+ * 		`forRange()` may use.
+ */
+size_t numThreads();
+
+/**
+ * @brief Change the number of threads used by `forRange()`.
+ * @detail Zero restores the default. Don't call this while another thread
+ * 		is inside `forRange()`.
+ */
+void setNumThreads(size_t num_threads);
+
+/**
+ * @brief Return how many slices `forRange()` would split `[begin, end)` into.
+ * @detail Each slice is at least `grain` indices long, and there is at most
+ * 		one slice per thread.
+ */
+size_t numSlices(size_t begin, size_t end, size_t grain);
+
+/**
+ * @brief Call `body(slice_begin, slice_end)` on disjoint slices that cover
+ * 		`[begin, end)`, in parallel.
+ * @detail The calling thread runs the first slice itself, and `forRange()`
+ * 		returns once every slice has finished. If any slice throws, one of
+ * 		the exceptions is rethrown in the caller.
+ *
+ * 		Calls made from inside a `body` (or while another thread is using the
+ * 		pool) run serially on the calling thread instead of deadlocking.
+ *
+ * 		Nothing is allocated per call, once the pool exists.
+ */
+void forRange(size_t begin, size_t end, size_t grain,
+			  FunctionRef<void(size_t, size_t)> body);
+
+} // namespace parallel
+
+#endif
@@ -0,0 +1,573 @@
+#include "QR.hpp"
+#include "Kernels.hpp"
+#include "Parallel.hpp"
+
+#include <algorithm>	// std::copy, std::fill, std::max, std::max_element, ...
+#include <cmath>		// std::abs, std::copysign, std::hypot, std::sqrt
+#include <limits>		// std::numeric_limits
+#include <numeric>		// std::iota
+#include <stdexcept>	// std::runtime_error
+#include <utility>		// std::move
+
+using std::runtime_error;
+using std::vector;
+
+namespace
+{
+
+/**
+ * @brief The number of reflectors that are applied together as one block.
+ */
+constexpr size_t block_size = 32;
+
+/**
+ * @brief Block updates smaller than this many columns (of `A`, or of the
+ * 		right-hand sides) run on the calling thread.
+ */
+constexpr size_t parallel_grain = 64;
+
+/**
+ * @brief Matrices with at least this many times as many rows as columns
+ * 		get an unpivoted QR first; see `QR::QR()`.
+ */
+constexpr size_t tall_ratio = 2;
+
+/**
+ * @brief Turn `x[0..n)` into a Householder vector `v` with `v[0] = 1`, and
+ * 		return the `tau` for which `(I - tau * v * v') * x = (beta, 0, ...)`.
+ * @detail Leaves `beta` in `x[0]` and the rest of `v` in `x[1..n)`. If
+ * 		`x[1..n)` is already zero, returns zero and leaves `x` alone.
+ */
+double householder(size_t n, double* x, const kernels::KernelTable& kernel)
+{
+	if (n <= 1) return 0.0;
+
+	const double tail_norm = std::sqrt(kernel.dot(n - 1, x + 1, x + 1));
+	if (tail_norm == 0.0) return 0.0;
+
+	// Pick the sign of `beta` that avoids cancellation in `alpha - beta`.
+	const double alpha = x[0];
+	const double beta = -std::copysign(std::hypot(alpha, tail_norm), alpha);
+	kernel.scale(n - 1, 1.0 / (alpha - beta), x + 1, x + 1);
+	x[0] = beta;
+	return (beta - alpha) / beta;
+}
+
+/**
+ * @brief The product `H_first * ... * H_(first + count - 1)` of consecutive
+ * 		Householder reflectors, in the compact WY form `I - V * T * V'`.
+ * @detail It only touches rows `first` and up, so `rows` is `m - first`.
+ * 		Applying it is three GEMMs: one with `V'`, one with the small `T`,
+ * 		and one with `V`.
+ */
+struct BlockReflector
+{
+	/**
+	 * @param reflectors	Column-major, `m` rows, with the Householder
+	 * 						vectors below the diagonal.
+	 */
+	BlockReflector(const Array2D& reflectors, const vector<double>& taus,
+				   size_t first, size_t count)
+		: rows{reflectors.size().first - first}, count{count},
+		  vt{count, rows}, v{rows, count}, t{count, count}, tt{count, count}
+	{
+		const kernels::KernelTable& kernel = kernels::active();
+		const size_t m = reflectors.size().first;
+
+		// V', with the leading ones and the zeros above them filled in.
+		double* vt_vals = vt.data();
+		for (size_t i = 0; i != count; ++i)
+		{
+			const double* column = reflectors.data() + (first + i) * m + first;
+			double* vt_row = vt_vals + i * rows;
+			vt_row[i] = 1.0;
+			std::copy(column + i + 1, column + rows, vt_row + i + 1);
+		}
+		kernel.transpose(count, rows, vt_vals, rows, v.data(), count);
+
+		// Column `i` of `T` is `-tau_i * T(0:i, 0:i) * V(:, 0:i)' * v_i` above
+		// the diagonal, and `tau_i` on it.
+		Array2D overlaps{count, count};
+		kernel.gemm(count, count, rows, 1.0, vt_vals, rows, v.data(), count,
+					overlaps.data(), count);
+		double* t_vals = t.data();
+		for (size_t i = 0; i != count; ++i)
+		{
+			const double tau = taus[first + i];
+			for (size_t j = 0; j != i; ++j)
+			{
+				double sum = 0.0;
+				for (size_t s = j; s != i; ++s)
+				{
+					sum += t_vals[j * count + s] * overlaps[s * count + i];
+				}
+				t_vals[j * count + i] = -tau * sum;
+			}
+			t_vals[i * count + i] = tau;
+		}
+		kernel.transpose(count, count, t_vals, count, tt.data(), count);
+	}
+
+	/**
+	 * @brief Overwrite the `rows x k` row-major `b` with `H' * b`, or with
+	 * 		`H * b` if `transposed` is false.
+	 */
+	void applyToRows(double* b, size_t k, size_t ld, bool transposed) const
+	{
+		const kernels::KernelTable& kernel = kernels::active();
+		const double* t_vals = (transposed ? tt : t).data();
+		parallel::forRange(0, k, parallel_grain, [&](size_t lo, size_t hi) {
+			// B -= V * T * (V' * B), with `T'` for `H'`.
+			const size_t width = hi - lo;
+			Array2D w{count, width};
+			Array2D tw{count, width};
+			kernel.gemm(count, width, rows, 1.0, vt.data(), rows, b + lo, ld,
+						w.data(), width);
+			kernel.gemm(count, width, count, 1.0, t_vals, count, w.data(), width,
+						tw.data(), width);
+			kernel.gemm(rows, width, count, -1.0, v.data(), count, tw.data(),
+						width, b + lo, ld);
+		});
+	}
+
+	/**
+	 * @brief Like `applyToRows()`, but for a column-major `b`, whose column
+	 * 		`j` starts at `b + j * ld`.
+	 */
+	void applyToColumns(double* b, size_t k, size_t ld, bool transposed) const
+	{
+		const kernels::KernelTable& kernel = kernels::active();
+		const double* t_vals = (transposed ? t : tt).data();
+		parallel::forRange(0, k, parallel_grain, [&](size_t lo, size_t hi) {
+			// The storage is `B'`, and `(H' * B)' = B' - (B' * V) * T * V'`,
+			// with `T'` for `H`.
+			const size_t width = hi - lo;
+			Array2D w{width, count};
+			Array2D wt{width, count};
+			kernel.gemm(width, count, rows, 1.0, b + lo * ld, ld, v.data(), count,
+						w.data(), count);
+			kernel.gemm(width, count, count, 1.0, w.data(), count, t_vals, count,
+						wt.data(), count);
+			kernel.gemm(width, rows, count, -1.0, wt.data(), count, vt.data(),
+						rows, b + lo * ld, ld);
+		});
+	}
+
+	const size_t rows;
+	const size_t count;
+	Array2D vt;
+	Array2D v;
+	Array2D t;
+	Array2D tt;
+};
+
+/**
+ * @brief Overwrite the row-major `b`, which has as many rows as
+ * 		`reflectors` and `k` columns, with `Q' * b`, or with `Q * b` if
+ * 		`transposed` is false, where `Q` is the product of the reflectors.
+ */
+void applyReflectors(const Array2D& reflectors, const vector<double>& taus,
+					 double* b, size_t k, bool transposed)
+{
+	const size_t steps = taus.size();
+	if (steps == 0 or k == 0) return;
+
+	// `Q = H_0 * H_1 * ...`, so `Q'` applies the blocks first to last, and
+	// `Q` last to first.
+	const size_t num_blocks = (steps + block_size - 1) / block_size;
+	for (size_t block = 0; block != num_blocks; ++block)
+	{
+		const size_t first = block_size
+			* (transposed ? block : num_blocks - 1 - block);
+		const BlockReflector reflector{reflectors, taus, first,
+									   std::min(block_size, steps - first)};
+		reflector.applyToRows(b + first * k, k, k, transposed);
+	}
+}
+
+/**
+ * @brief Factor the column-major `a` in place into `Q * R`, without
+ * 		pivoting.
+ * @detail Each panel of `block_size` columns is factored one column at a
+ * 		time, and then applied to the rest of the columns as one block
+ * 		reflector.
+ */
+void householderQR(Array2D& a, vector<double>& taus)
+{
+	const size_t m = a.size().first;
+	const size_t n = a.size().second;
+	const size_t steps = std::min(m, n);
+	const kernels::KernelTable& kernel = kernels::active();
+	double* vals = a.data();
+	const auto column = [&](size_t j) { return vals + j * m; };
+
+	taus.assign(steps, 0.0);
+	for (size_t first = 0; first < steps; first += block_size)
+	{
+		const size_t last = std::min(first + block_size, steps);
+		for (size_t k = first; k != last; ++k)
+		{
+			double* a_k = column(k);
+			const double tau = householder(m - k, a_k + k, kernel);
+			taus[k] = tau;
+			if (tau == 0.0) continue;
+
+			const double diagonal = a_k[k];
+			a_k[k] = 1.0;
+			for (size_t j = k + 1; j != last; ++j)
+			{
+				double* a_j = column(j) + k;
+				kernel.axpy(m - k, -tau * kernel.dot(m - k, a_k + k, a_j),
+							a_k + k, a_j);
+			}
+			a_k[k] = diagonal;
+		}
+
+		if (last < n)
+		{
+			const BlockReflector reflector{a, taus, first, last - first};
+			reflector.applyToColumns(column(last) + first, n - last, m, true);
+		}
+	}
+}
+
+/**
+ * @brief Factor the column-major `a` in place into `Q * R * P'`, choosing
+ * 		the pivot columns as it goes.
+ * @detail This is the blocked algorithm of Quintana-Orti, Sun and Bischof
+ * 		(LAPACK's `dgeqp3`).
+ */
+void pivotedQR(Array2D& a, vector<double>& taus, vector<size_t>& columns)
+{
+	const size_t m = a.size().first;
+	const size_t n = a.size().second;
+	const size_t steps = std::min(m, n);
+	const kernels::KernelTable& kernel = kernels::active();
+	double* vals = a.data();
+	const auto column = [&](size_t j) { return vals + j * m; };
+
+	taus.assign(steps, 0.0);
+	columns.resize(n);
+	std::iota(columns.begin(), columns.end(), size_t{0});
+
+	// The norms of the unfactored parts of the columns, kept up to date
+	// cheaply as rows are factored off, and the norms they were last
+	// computed from scratch at. The cheap updates lose accuracy as a norm
+	// shrinks relative to where it started, so then it's recomputed.
+	vector<double> norms(n);
+	vector<double> exact_norms(n);
+	for (size_t j = 0; j != n; ++j)
+	{
+		norms[j] = exact_norms[j] = std::sqrt(kernel.dot(m, column(j),
+														 column(j)));
+	}
+	const double drift_tolerance =
+		std::sqrt(std::numeric_limits<double>::epsilon());
+	vector<size_t> stale;
+
+	// Row `j` of `f` is `F(j, :)`, where the block of reflectors factored so
+	// far in the current panel, applied to column `j` of `A`, subtracts
+	// `V * F(j, :)'` from it. The trailing columns are only brought up to
+	// date all at once, with a GEMM, at the end of each panel.
+	Array2D f{n, block_size};
+	double* f_vals = f.data();
+	vector<double> f_column(n);
+	vector<double> work(n);
+	vector<double> pivot_row(block_size);
+
+	for (size_t first = 0; first < steps;)
+	{
+		const size_t panel = std::min(block_size, steps - first);
+		size_t done = 0;
+		while (done != panel)
+		{
+			const size_t k = first + done;
+
+			// Bring the column with the largest remaining norm to the front.
+			const size_t pivot = static_cast<size_t>(
+				std::max_element(norms.begin() + k, norms.end()) - norms.begin());
+			if (pivot != k)
+			{
+				std::swap_ranges(column(pivot), column(pivot) + m, column(k));
+				std::swap_ranges(f_vals + pivot * block_size,
+								 f_vals + pivot * block_size + done,
+								 f_vals + k * block_size);
+				std::swap(columns[pivot], columns[k]);
+				norms[pivot] = norms[k];
+				exact_norms[pivot] = exact_norms[k];
+			}
+
+			// Apply the panel's earlier reflectors to the rest of column `k`,
+			// and make the next one out of it.
+			double* a_k = column(k);
+			if (done != 0)
+			{
+				kernel.gemvTransposed(done, m - k, -1.0, column(first) + k, m,
+									  f_vals + k * block_size, a_k + k);
+			}
+			const double tau = householder(m - k, a_k + k, kernel);
+			taus[k] = tau;
+			const double diagonal = a_k[k];
+			a_k[k] = 1.0;
+
+			// F(:, done) = tau * (A' * v - F * V' * v), for the unfactored
+			// columns of `A` as they were at the start of the panel.
+			std::fill(f_column.begin(), f_column.begin() + (n - first), 0.0);
+			if (k + 1 != n)
+			{
+				kernel.gemv(n - k - 1, m - k, tau, column(k + 1) + k, m, a_k + k,
+							f_column.data() + (k + 1 - first));
+			}
+			if (done != 0)
+			{
+				std::fill(work.begin(), work.begin() + done, 0.0);
+				kernel.gemv(done, m - k, -tau, column(first) + k, m, a_k + k,
+							work.data());
+				kernel.gemv(n - first, done, 1.0, f_vals + first * block_size,
+							block_size, work.data(), f_column.data());
+			}
+			for (size_t j = first; j != n; ++j)
+			{
+				f_vals[j * block_size + done] = f_column[j - first];
+			}
+
+			// Row `k` of the trailing columns is final now; the pivot
+			// choices below need it.
+			if (k + 1 != n)
+			{
+				for (size_t i = 0; i <= done; ++i)
+				{
+					pivot_row[i] = column(first + i)[k];
+				}
+				std::fill(work.begin(), work.begin() + (n - k - 1), 0.0);
+				kernel.gemv(n - k - 1, done + 1, 1.0,
+							f_vals + (k + 1) * block_size, block_size,
+							pivot_row.data(), work.data());
+				for (size_t j = k + 1; j != n; ++j)
+				{
+					column(j)[k] -= work[j - k - 1];
+				}
+			}
+
+			// Take row `k` out of the remaining columns' norms.
+			if (k + 1 < m)
+			{
+				for (size_t j = k + 1; j != n; ++j)
+				{
+					if (norms[j] == 0.0) continue;
+
+					const double ratio = std::abs(column(j)[k]) / norms[j];
+					const double left = std::max(0.0, (1.0 - ratio) * (1.0 + ratio));
+					const double drift = norms[j] / exact_norms[j];
+					if (left * drift * drift <= drift_tolerance)
+					{
+						stale.push_back(j);
+					}
+					else
+					{
+						norms[j] *= std::sqrt(left);
+					}
+				}
+			}
+
+			a_k[k] = diagonal;
+			++done;
+
+			// Stale norms can only be recomputed once the trailing columns
+			// are up to date, so end the panel early.
+			if (not stale.empty()) break;
+		}
+
+		// Apply the panel to the rows below it in the trailing columns:
+		// A(next:m, next:n) -= V(next:m, :) * F(next:n, :)'.
+		const size_t next = first + done;
+		if (next < steps)
+		{
+			parallel::forRange(next, n, parallel_grain,
+							   [&](size_t lo, size_t hi) {
+				kernel.gemm(hi - lo, m - next, done, -1.0,
+							f_vals + lo * block_size, block_size,
+							column(first) + next, m, column(lo) + next, m);
+			});
+		}
+
+		for (size_t j : stale)
+		{
+			norms[j] = exact_norms[j] = std::sqrt(
+				kernel.dot(m - next, column(j) + next, column(j) + next));
+		}
+		stale.clear();
+		first = next;
+	}
+}
+
+} // anonymous namespace
+
+QR::QR(const Matrix& a)
+	: a_size{a.size()}
+{
+	const size_t m = a_size.first;
+	const size_t n = a_size.second;
+
+	Array2D column_major{m, n, Layout::ColumnMajor};
+	if (a.layout() == Layout::ColumnMajor)
+	{
+		std::copy(a.data(), a.data() + m * n, column_major.data());
+	}
+	else
+	{
+		kernels::active().transpose(m, n, a.data(), n, column_major.data(), m);
+	}
+
+	// Choosing pivots takes a pass over the whole unfactored part of `A` for
+	// every column, which is memory-bound. For tall matrices, factor without
+	// pivoting first (all of whose updates are GEMMs), and then pivot on the
+	// small `R` instead. Column norms don't change under `Q'`, so the
+	// pivots come out the same.
+	if (n != 0 and m >= tall_ratio * n)
+	{
+		householderQR(column_major, tall_taus);
+		tall_factors = std::move(column_major);
+
+		factors = Array2D{n, n, Layout::ColumnMajor};
+		const double* tall_vals = tall_factors.data();
+		double* vals = factors.data();
+		for (size_t j = 0; j != n; ++j)
+		{
+			std::copy(tall_vals + j * m, tall_vals + j * m + j + 1, vals + j * n);
+		}
+	}
+	else
+	{
+		factors = std::move(column_major);
+	}
+	pivotedQR(factors, taus, columns);
+}
+
+const std::pair<size_t, size_t>& QR::size() const
+{
+	return a_size;
+}
+
+size_t QR::rank() const
+{
+	const double epsilon = std::numeric_limits<double>::epsilon();
+	return rank(std::max(size().first, size().second) * epsilon);
+}
+
+size_t QR::rank(double tolerance) const
+{
+	const size_t ld = factors.size().first;
+	const size_t steps = taus.size();
+	if (steps == 0) return 0;
+
+	const double* vals = factors.data();
+	const double threshold = tolerance * std::abs(vals[0]);
+	size_t num = 0;
+	while (num != steps and std::abs(vals[num * ld + num]) > threshold) ++num;
+	return num;
+}
+
+void QR::applyQ(Array2D& b, bool transposed) const
+{
+	// Q = Q_tall * Q_pivoted, where `Q_pivoted` only touches the first `n`
+	// rows.
+	const size_t k = b.size().second;
+	if (transposed)
+	{
+		applyReflectors(tall_factors, tall_taus, b.data(), k, true);
+		applyReflectors(factors, taus, b.data(), k, true);
+	}
+	else
+	{
+		applyReflectors(factors, taus, b.data(), k, false);
+		applyReflectors(tall_factors, tall_taus, b.data(), k, false);
+	}
+}
+
+Matrix QR::leastSquares(const Matrix& b) const
+{
+	const size_t m = size().first;
+	const size_t n = size().second;
+	if (b.size().first != m)
+	{
+		throw runtime_error{"Right-hand side has the wrong number of rows!"};
+	}
+	const size_t k = b.size().second;
+
+	// C = Q' * b, then solve R(0:r, 0:r) * z = C(0:r, :) for the rank `r`.
+	Array2D c{m, k};
+	if (m * k != 0)
+	{
+		const Matrix row_major = b.toLayout(Layout::RowMajor);
+		std::copy(row_major.data(), row_major.data() + m * k, c.data());
+	}
+	applyQ(c, true);
+
+	const kernels::KernelTable& kernel = kernels::active();
+	const size_t ld = factors.size().first;
+	const double* vals = factors.data();
+	double* c_vals = c.data();
+	const size_t r = rank();
+	for (size_t i = r; i-- > 0;)
+	{
+		double* c_i = c_vals + i * k;
+		for (size_t j = i + 1; j != r; ++j)
+		{
+			kernel.axpy(k, -vals[j * ld + i], c_vals + j * k, c_i);
+		}
+		kernel.scale(k, 1.0 / vals[i * ld + i], c_i, c_i);
+	}
+
+	// x = P * z, with zeros for the columns past the rank.
+	Matrix x{n, k};
+	double* x_vals = x.data();
+	for (size_t i = 0; i != r; ++i)
+	{
+		std::copy(c_vals + i * k, c_vals + (i + 1) * k,
+				  x_vals + columns[i] * k);
+	}
+	return x.toLayout(b.layout());
+}
+
+Matrix QR::q() const
+{
+	const size_t m = size().first;
+	const size_t steps = taus.size();
+
+	Array2D basis{m, steps};
+	for (size_t i = 0; i != steps; ++i) basis[i * steps + i] = 1.0;
+	applyQ(basis, false);
+
+	Matrix q{m, steps};
+	if (m * steps != 0)
+	{
+		std::copy(basis.data(), basis.data() + m * steps, q.data());
+	}
+	return q;
+}
+
+Matrix QR::r() const
+{
+	const size_t n = size().second;
+	const size_t ld = factors.size().first;
+	const size_t steps = taus.size();
+	const double* vals = factors.data();
+
+	Matrix r{steps, n};
+	for (size_t j = 1; j <= n; ++j)
+	{
+		for (size_t i = 1; i <= std::min(j, steps); ++i)
+		{
+			r(i, j) = vals[(j - 1) * ld + (i - 1)];
+		}
+	}
+	return r;
+}
+
+vector<size_t> QR::permutation() const
+{
+	vector<size_t> one_indexed(columns);
+	for (size_t& j : one_indexed) ++j;
+	return one_indexed;
+}
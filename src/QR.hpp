@@ -0,0 +1,130 @@
+#ifndef MAAV_PROJECT_3_QR_HPP
+#define MAAV_PROJECT_3_QR_HPP
+
+#include "Array2D.hpp"
+#include "Matrix.hpp"
+
+#include <cstdlib>	// size_t
+#include <utility>	// std::pair
+#include <vector>	// std::vector
+
+/**
+ * @brief The QR factorization `A * P = Q * R` of an `m x n` matrix `A`, with
+ * 		column pivoting.
+ * @detail `Q` is orthogonal, `R` is upper trapezoidal, and the permutation
+ * 		`P` moves the column with the largest remaining norm to the front at
+ * 		each step. That makes the diagonal of `R` shrink in magnitude, which
+ * 		is what `rank()` uses to estimate the rank of `A`.
+ *
+ * 		`Q` is kept as a sequence of Householder reflectors. Both factoring
+ * 		and applying them work a block of reflectors at a time: the block is
+ * 		applied in the compact WY form `I - V * T * V'` with a few GEMMs, so
+ * 		most of the work runs at matrix-multiply speed. Choosing the pivots
+ * 		costs one extra matrix-vector product per column, so a tall `A` is
+ * 		first factored without pivoting, and only its square `R` is
+ * 		factored again with pivoting.
+ *
+ * 		Use `leastSquares()` for overdetermined systems instead of the
+ * 		normal equations `A' * A * x = A' * b`, which square the condition
+ * 		number of `A`.
+ */
+class QR
+{
+	using SizePair = std::pair<size_t, size_t>;
+
+public:
+
+	QR() = default;
+
+	/**
+	 * @brief Factor `a`, which can have any shape and either layout.
+	 * @detail Takes about `2 * m * n^2 - 2 * n^3 / 3` flops for `m >= n`.
+	 * 		Throws an `std::runtime_error` if `a` is blank.
+	 */
+	explicit QR(const Matrix& a);
+
+	/**
+	 * @brief Return the size of the factored matrix `A`.
+	 */
+	const SizePair& size() const;
+
+	/**
+	 * @brief Estimate the rank of `A`: the number of diagonal elements of
+	 * 		`R` whose magnitude is greater than `tolerance` times the
+	 * 		largest one.
+	 * @detail With no `tolerance`, uses `max(m, n)` times machine epsilon.
+	 */
+	size_t rank() const;
+	size_t rank(double tolerance) const;
+
+	/**
+	 * @brief Return the `x` that minimizes `||A * x - b||` for each column
+	 * 		of `b`.
+	 * @detail `b` is `m x k` for any `k`, and `x` is `n x k`, with the same
+	 * 		layout as `b`. All of the right-hand sides are handled together,
+	 * 		a block of reflectors at a time, so many of them cost little more
+	 * 		than one.
+	 *
+	 * 		If `A` is rank-deficient (see `rank()`), this returns the "basic"
+	 * 		solution, which is zero in the columns that pivoting put last.
+	 * 		Throws an `std::runtime_error` if `b` doesn't have `m` rows.
+	 */
+	Matrix leastSquares(const Matrix& b) const;
+
+	/**
+	 * @brief Return the `m x min(m, n)` matrix whose columns are the first
+	 * 		`min(m, n)` columns of `Q`.
+	 */
+	Matrix q() const;
+
+	/**
+	 * @brief Return the `min(m, n) x n` upper-trapezoidal factor `R`.
+	 */
+	Matrix r() const;
+
+	/**
+	 * @brief Return the permutation `P` as a list of column numbers: column
+	 * 		`j` of `A * P` is column `permutation()[j - 1]` of `A`.
+	 * @detail Like Matrix indices, the column numbers start from one.
+	 */
+	std::vector<size_t> permutation() const;
+
+private:
+
+	/**
+	 * @brief Overwrite the row-major `m x k` array `b` with `Q' * b`, or with
+	 * 		`Q * b` if `transposed` is false.
+	 */
+	void applyQ(Array2D& b, bool transposed) const;
+
+	SizePair a_size{0, 0};
+
+	/**
+	 * @brief For a tall `A`, the unpivoted factorization `A = Q_1 * R_1`
+	 * 		that the pivoted one starts from; empty otherwise. Stored like
+	 * 		`factors`.
+	 */
+	Array2D tall_factors;
+	std::vector<double> tall_taus;
+
+	/**
+	 * @brief The pivoted factorization of `A` (or of `R_1`): `R` above the
+	 * 		diagonal and the Householder vectors below it, stored
+	 * 		column-major so that both are contiguous.
+	 * @detail The vectors' leading ones aren't stored.
+	 */
+	Array2D factors;
+
+	/**
+	 * @brief The Householder reflector `k` is `I - taus[k] * v * v'`.
+	 */
+	std::vector<double> taus;
+
+	/**
+	 * @brief Column `j` of `A * P` is column `columns[j]` of `A`, counting
+	 * 		from zero.
+	 */
+	std::vector<size_t> columns;
+};
+
+#endif
@@ -0,0 +1,483 @@
+#include "Reductions.hpp"
+#include "Kernels.hpp"
+#include "Parallel.hpp"
+
+#include <algorithm>	// std::max, std::min, std::max_element
+#include <atomic>		// std::atomic
+#include <cmath>		// std::isnan, std::isfinite, std::sqrt, std::frexp, std::ldexp
+#include <cstdint>		// int64_t, uint64_t
+#include <cstring>		// std::memcpy
+#include <limits>		// std::numeric_limits
+#include <stdexcept>	// std::runtime_error
+#include <vector>		// std::vector
+
+using std::runtime_error;
+using std::vector;
+
+namespace
+{
+
+/**
+ * @brief The number of elements that a kernel reduces in one call.
+ * @detail Small enough that the rounding error within a block stays
+ * 		negligible, large enough that the per-block overhead doesn't matter.
+ */
+constexpr size_t block_size = 2048;
+
+/**
+ * @brief The least amount of elements worth handing to another thread.
+ */
+constexpr size_t parallel_grain = size_t{1} << 16;
+
+/**
+ * @brief Kahan-Babuska (Neumaier) compensated summation.
+ */
+class CompensatedSum
+{
+public:
+
+	void add(double value)
+	{
+		const double total = sum + value;
+		if (not std::isfinite(total))
+		{
+			// The error terms below would be `inf - inf`, i.e. NaN.
+			sum = total;
+			return;
+		}
+		if (std::abs(sum) >= std::abs(value))
+		{
+			compensation += (sum - total) + value;
+		}
+		else
+		{
+			compensation += (value - total) + sum;
+		}
+		sum = total;
+	}
+
+	double value() const
+	{
+		return sum + compensation;
+	}
+
+private:
+
+	double sum{0.0};
+	double compensation{0.0};
+};
+
+size_t numElements(const Matrix& mat)
+{
+	return mat.size().first * mat.size().second;
+}
+
+void checkSameSize(const Matrix& lhs, const Matrix& rhs)
+{
+	if (lhs.size() != rhs.size())
+	{
+		throw runtime_error{"Matrix dimensions do not match!"};
+	}
+}
+
+void checkNotEmpty(const Matrix& mat)
+{
+	if (numElements(mat) == 0)
+	{
+		throw runtime_error{"Cannot reduce an empty Matrix!"};
+	}
+}
+
+/**
+ * @brief Sum `block_sum(begin, end)` over fixed blocks of `[0, n)`.
+ * @detail Blocks are reduced in parallel, then combined in order with
+ * 		compensated summation.
+ */
+template <typename BlockSum>
+double blockedSum(size_t n, BlockSum block_sum)
+{
+	const size_t num_blocks = (n + block_size - 1) / block_size;
+	if (num_blocks <= 1) return n == 0 ? 0.0 : block_sum(0, n);
+
+	vector<double> partials(num_blocks);
+	parallel::forRange(0, num_blocks, parallel_grain / block_size,
+		[&](size_t first, size_t last) {
+			for (size_t block = first; block != last; ++block)
+			{
+				const size_t begin = block * block_size;
+				partials[block] =
+					block_sum(begin, std::min(n, begin + block_size));
+			}
+		});
+
+	CompensatedSum total;
+	for (double partial : partials) total.add(partial);
+	return total.value();
+}
+
+/**
+ * @brief Map a double onto an integer, such that adjacent doubles map onto
+ * 		adjacent integers.
+ */
+int64_t orderedBits(double value)
+{
+	int64_t bits;
+	std::memcpy(&bits, &value, sizeof bits);
+	return bits < 0 ? std::numeric_limits<int64_t>::min() - bits : bits;
+}
+
+bool withinUlps(double lhs, double rhs, double max_ulps)
+{
+	if (std::isnan(lhs) or std::isnan(rhs)) return false;
+
+	const int64_t lhs_bits = orderedBits(lhs);
+	const int64_t rhs_bits = orderedBits(rhs);
+	const uint64_t distance = lhs_bits > rhs_bits
+		? static_cast<uint64_t>(lhs_bits) - static_cast<uint64_t>(rhs_bits)
+		: static_cast<uint64_t>(rhs_bits) - static_cast<uint64_t>(lhs_bits);
+	return static_cast<double>(distance) <= max_ulps;
+}
+
+} // anonymous namespace
+
+namespace reductions
+{
+
+double sum(const Matrix& mat)
+{
+	const double* vals = mat.data();
+	const kernels::KernelTable& kernel = kernels::active();
+	return blockedSum(numElements(mat), [&](size_t begin, size_t end) {
+		return kernel.sum(end - begin, vals + begin);
+	});
+}
+
+double dot(const Matrix& lhs, const Matrix& rhs)
+{
+	checkSameSize(lhs, rhs);
+	const Matrix same_layout = rhs.toLayout(lhs.layout());
+
+	const double* lhs_vals = lhs.data();
+	const double* rhs_vals = same_layout.data();
+	const kernels::KernelTable& kernel = kernels::active();
+	return blockedSum(numElements(lhs), [&](size_t begin, size_t end) {
+		return kernel.dot(end - begin, lhs_vals + begin, rhs_vals + begin);
+	});
+}
+
+double trace(const Matrix& mat)
+{
+	const size_t n = mat.size().first;
+	if (n != mat.size().second)
+	{
+		throw runtime_error{"Cannot take the trace of a non-square matrix!"};
+	}
+
+	const double* vals = mat.data();
+	CompensatedSum total;
+	for (size_t i = 0; i != n; ++i) total.add(vals[i * n + i]);
+	return total.value();
+}
+
+namespace
+{
+
+/**
+ * @brief Sums of squares at least this large lose nothing that matters to
+ * 		squares that underflowed.
+ */
+const double min_unscaled_squares = std::ldexp(1.0, -600);
+
+/**
+ * @brief Return the largest absolute value among the `n` elements of `vals`.
+ */
+double maxAbs(const double* vals, size_t n)
+{
+	const kernels::KernelTable& kernel = kernels::active();
+	double largest{0.0};
+	for (size_t begin = 0; begin < n; begin += block_size)
+	{
+		double min;
+		double max;
+		kernel.minMax(std::min(block_size, n - begin), vals + begin, &min, &max);
+		largest = std::max({largest, -min, max});
+	}
+	return largest;
+}
+
+} // anonymous namespace
+
+double frobeniusNorm(const Matrix& mat)
+{
+	const size_t n = numElements(mat);
+	if (n == 0) return 0.0;
+
+	const double* vals = mat.data();
+	const kernels::KernelTable& kernel = kernels::active();
+	const double squares = blockedSum(n, [&](size_t begin, size_t end) {
+		return kernel.dot(end - begin, vals + begin, vals + begin);
+	});
+	if (std::isnan(squares)
+		or (std::isfinite(squares) and squares >= min_unscaled_squares))
+	{
+		return std::sqrt(squares);
+	}
+
+	// The squares overflowed or underflowed, so do it again with every
+	// element scaled by a power of two that brings the largest one near 1,
+	// as LAPACK's dlange does. That scaling is exact.
+	const double largest = maxAbs(vals, n);
+	if (largest == 0.0 or std::isinf(largest)) return largest;
+
+	// Clamped, so that the scale factor itself stays finite for subnormals.
+	int exponent;
+	std::frexp(largest, &exponent);
+	exponent = std::max(-1000, std::min(exponent, 1000));
+	const double scale = std::ldexp(1.0, -exponent);
+	const double scaled_squares = blockedSum(n, [&](size_t begin, size_t end) {
+		double scaled[block_size];
+		kernel.scale(end - begin, scale, vals + begin, scaled);
+		return kernel.dot(end - begin, scaled, scaled);
+	});
+	return std::ldexp(std::sqrt(scaled_squares), exponent);
+}
+
+namespace
+{
+
+/**
+ * @brief Return the largest absolute column sum of the row-major
+ * 		`rows x cols` array `vals`.
+ */
+double maxColumnSum(const double* vals, size_t rows, size_t cols)
+{
+	if (rows == 0 or cols == 0) return 0.0;
+
+	// Walk the matrix row by row, accumulating every column's sum at once;
+	// each thread owns a range of columns.
+	const kernels::KernelTable& kernel = kernels::active();
+	vector<double> col_sums(cols, 0.0);
+	const size_t col_grain = std::max<size_t>(64, parallel_grain / rows);
+	parallel::forRange(0, cols, col_grain, [&](size_t first, size_t last) {
+		for (size_t row = 0; row != rows; ++row)
+		{
+			kernel.addAbs(last - first, vals + row * cols + first,
+						  col_sums.data() + first);
+		}
+	});
+
+	return *std::max_element(col_sums.begin(), col_sums.end());
+}
+
+/**
+ * @brief Return the largest absolute row sum of the row-major `rows x cols`
+ * 		array `vals`.
+ */
+double maxRowSum(const double* vals, size_t rows, size_t cols)
+{
+	if (rows == 0 or cols == 0) return 0.0;
+
+	const kernels::KernelTable& kernel = kernels::active();
+	vector<double> row_sums(rows);
+	const size_t row_grain = std::max<size_t>(1, parallel_grain / cols);
+	parallel::forRange(0, rows, row_grain, [&](size_t first, size_t last) {
+		for (size_t row = first; row != last; ++row)
+		{
+			row_sums[row] = kernel.sumAbs(cols, vals + row * cols);
+		}
+	});
+
+	return *std::max_element(row_sums.begin(), row_sums.end());
+}
+
+} // anonymous namespace
+
+// The storage of a column-major Matrix is the row-major storage of its
+// transpose, whose row sums are the original's column sums.
+
+double oneNorm(const Matrix& mat)
+{
+	const size_t rows = mat.size().first;
+	const size_t cols = mat.size().second;
+	return mat.layout() == Layout::RowMajor
+		? maxColumnSum(mat.data(), rows, cols)
+		: maxRowSum(mat.data(), cols, rows);
+}
+
+double infNorm(const Matrix& mat)
+{
+	const size_t rows = mat.size().first;
+	const size_t cols = mat.size().second;
+	return mat.layout() == Layout::RowMajor
+		? maxRowSum(mat.data(), rows, cols)
+		: maxColumnSum(mat.data(), cols, rows);
+}
+
+namespace
+{
+
+/**
+ * @brief Find the smallest and largest elements of a non-empty Matrix.
+ */
+void findMinMax(const Matrix& mat, double& min, double& max)
+{
+	checkNotEmpty(mat);
+
+	const size_t n = numElements(mat);
+	const size_t num_blocks = (n + block_size - 1) / block_size;
+	const double* vals = mat.data();
+	const kernels::KernelTable& kernel = kernels::active();
+
+	vector<double> mins(num_blocks);
+	vector<double> maxes(num_blocks);
+	parallel::forRange(0, num_blocks, parallel_grain / block_size,
+		[&](size_t first, size_t last) {
+			for (size_t block = first; block != last; ++block)
+			{
+				const size_t begin = block * block_size;
+				const size_t end = std::min(n, begin + block_size);
+				kernel.minMax(end - begin, vals + begin, &mins[block],
+							  &maxes[block]);
+			}
+		});
+
+	// Block results are NaN if the block had one, and NaNs have to win here
+	// too.
+	min = mins[0];
+	max = maxes[0];
+	for (size_t block = 1; block != num_blocks; ++block)
+	{
+		if (mins[block] < min or std::isnan(mins[block])) min = mins[block];
+		if (maxes[block] > max or std::isnan(maxes[block])) max = maxes[block];
+		if (std::isnan(min)) break;
+	}
+}
+
+} // anonymous namespace
+
+double minCoeff(const Matrix& mat)
+{
+	double min;
+	double max;
+	findMinMax(mat, min, max);
+	return min;
+}
+
+double maxCoeff(const Matrix& mat)
+{
+	double min;
+	double max;
+	findMinMax(mat, min, max);
+	return max;
+}
+
+std::pair<size_t, size_t> argMax(const Matrix& mat)
+{
+	checkNotEmpty(mat);
+
+	const size_t n = numElements(mat);
+	const size_t num_blocks = (n + block_size - 1) / block_size;
+	const double* vals = mat.data();
+	const kernels::KernelTable& kernel = kernels::active();
+
+	// Each block records its largest value together with where it first
+	// occurs, so that the two can never disagree.
+	vector<double> maxes(num_blocks);
+	vector<size_t> indices(num_blocks);
+	parallel::forRange(0, num_blocks, parallel_grain / block_size,
+		[&](size_t first, size_t last) {
+			for (size_t block = first; block != last; ++block)
+			{
+				const size_t begin = block * block_size;
+				const size_t end = std::min(n, begin + block_size);
+				double min;
+				double max;
+				kernel.minMax(end - begin, vals + begin, &min, &max);
+
+				size_t index = begin;
+				if (std::isnan(max))
+				{
+					while (not std::isnan(vals[index])) ++index;
+				}
+				else
+				{
+					while (vals[index] != max) ++index;
+				}
+				maxes[block] = max;
+				indices[block] = index;
+			}
+		});
+
+	size_t best = 0;
+	for (size_t block = 1; block != num_blocks; ++block)
+	{
+		if (std::isnan(maxes[best])) break;
+		if (maxes[block] > maxes[best] or std::isnan(maxes[block])) best = block;
+	}
+	const size_t index = indices[best];
+
+	if (mat.layout() == Layout::ColumnMajor)
+	{
+		const size_t rows = mat.size().first;
+		return {index % rows + 1, index / rows + 1};
+	}
+	const size_t cols = mat.size().second;
+	return {index / cols + 1, index % cols + 1};
+}
+
+bool isApprox(const Matrix& lhs, const Matrix& rhs, double tolerance,
+			  Tolerance mode)
+{
+	if (lhs.size() != rhs.size()) return false;
+	const Matrix same_layout = rhs.toLayout(lhs.layout());
+
+	const size_t n = numElements(lhs);
+	const size_t num_blocks = (n + block_size - 1) / block_size;
+	const double* lhs_vals = lhs.data();
+	const double* rhs_vals = same_layout.data();
+	const kernels::KernelTable& kernel = kernels::active();
+
+	const double abs_tol = mode == Tolerance::Absolute ? tolerance : 0.0;
+	const double rel_tol = mode == Tolerance::Relative ? tolerance : 0.0;
+
+	// Checked before every block, so that every thread stops soon after
+	// any of them finds a mismatch.
+	std::atomic<bool> mismatch{false};
+
+	parallel::forRange(0, num_blocks, parallel_grain / block_size,
+		[&](size_t first, size_t last) {
+			for (size_t block = first; block != last; ++block)
+			{
+				if (mismatch.load(std::memory_order_relaxed)) return;
+
+				const size_t begin = block * block_size;
+				const size_t len = std::min(n, begin + block_size) - begin;
+				const double* a = lhs_vals + begin;
+				const double* b = rhs_vals + begin;
+
+				bool block_ok = true;
+				if (mode == Tolerance::Ulp)
+				{
+					for (size_t i = 0; i != len and block_ok; ++i)
+					{
+						block_ok = withinUlps(a[i], b[i], tolerance);
+					}
+				}
+				else
+				{
+					block_ok = kernel.firstMismatch(len, a, b, abs_tol,
+													rel_tol) == len;
+				}
+
+				if (not block_ok)
+				{
+					mismatch.store(true, std::memory_order_relaxed);
+					return;
+				}
+			}
+		});
+
+	return not mismatch.load();
+}
+
+} // namespace reductions
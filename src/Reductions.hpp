@@ -0,0 +1,109 @@
+#ifndef MAAV_PROJECT_3_REDUCTIONS_HPP
+#define MAAV_PROJECT_3_REDUCTIONS_HPP
+
+#include "Matrix.hpp"
+
+#include <cstdlib>	// size_t
+#include <utility>	// std::pair
+
+/**
+ * @brief Functions that boil a Matrix down to a single number.
+ * @detail These run on the per-instruction-set kernels (see `Kernels.hpp`)
+ * 		and, for large matrices, on several threads (see `Parallel.hpp`).
+ *
+ * 		Sums are accumulated in fixed-size blocks, and the block sums are
+ * 		combined with compensated (Kahan-Babuska) summation, so the rounding
+ * 		error doesn't grow with the number of elements. The blocks don't
+ * 		depend on the thread count, so results are reproducible.
+ *
+ * 		Like every other Matrix function, these throw `std::runtime_error`s
+ * 		when given a blank Matrix or mismatched sizes.
+ */
+namespace reductions
+{
+
+/**
+ * @brief Return the sum of every element.
+ */
+double sum(const Matrix& mat);
+
+/**
+ * @brief Return the sum of the element-wise products of two same-sized
+ * 		matrices (the Frobenius inner product).
+ * @detail For two column vectors, this is the ordinary dot product.
+ */
+double dot(const Matrix& lhs, const Matrix& rhs);
+
+/**
+ * @brief Return the sum of the diagonal elements of a square Matrix.
+ */
+double trace(const Matrix& mat);
+
+/**
+ * @brief Return the square root of the sum of the squares of every element.
+ * @detail Doesn't overflow or underflow unless the result itself does:
+ * 		when the plain sum of squares would, the elements are rescaled first.
+ */
+double frobeniusNorm(const Matrix& mat);
+
+/**
+ * @brief Return the largest absolute column sum.
+ */
+double oneNorm(const Matrix& mat);
+
+/**
+ * @brief Return the largest absolute row sum.
+ */
+double infNorm(const Matrix& mat);
+
+/**
+ * @brief Return the smallest element. Throws if the Matrix is empty.
+ * @detail NaNs propagate: if any element is NaN, so is the result.
+ */
+double minCoeff(const Matrix& mat);
+
+/**
+ * @brief Return the largest element. Throws if the Matrix is empty.
+ * @detail NaNs propagate, as in `minCoeff()`.
+ */
+double maxCoeff(const Matrix& mat);
+
+/**
+ * @brief Return the one-indexed `(row, col)` of the largest element.
+ * @detail Ties go to the first such element in storage order (i.e.
+ * 		row-major order, unless `mat` is column-major). A NaN counts as
+ * 		larger than everything else, matching `maxCoeff()`, so the first NaN
+ * 		wins if there is one. Throws if the Matrix is empty.
+ */
+std::pair<size_t, size_t> argMax(const Matrix& mat);
+
+/**
+ * @brief How `isApprox` interprets its tolerance.
+ */
+enum class Tolerance
+{
+	/** @brief `|a - b| <= tolerance` */
+	Absolute,
+
+	/** @brief `|a - b| <= tolerance * max(|a|, |b|)` */
+	Relative,
+
+	/**
+	 * @brief `a` and `b` are at most `tolerance` representable doubles
+	 * 		apart. Zeroes of either sign are equal.
+	 */
+	Ulp
+};
+
+/**
+ * @brief Return true if two matrices have the same size and all of their
+ * 		corresponding elements are equal to within `tolerance`.
+ * @detail Stops as soon as it finds a mismatch. NaNs are never equal to
+ * 		anything.
+ */
+bool isApprox(const Matrix& lhs, const Matrix& rhs, double tolerance,
+			  Tolerance mode = Tolerance::Absolute);
+
+} // namespace reductions
+
+#endif
@@ -0,0 +1,469 @@
+#include "SharedMemory.hpp"
+
+#include <algorithm>	// std::copy
+#include <atomic>		// std::atomic
+#include <new>			// placement new
+#include <stdexcept>	// std::runtime_error
+#include <thread>		// std::this_thread::yield
+
+#include <fcntl.h>		// O_CREAT, O_EXCL, O_RDWR
+#include <sys/mman.h>	// mmap, munmap, shm_open, shm_unlink
+#include <sys/stat.h>	// fstat
+#include <unistd.h>		// close, ftruncate, sysconf
+
+using std::runtime_error;
+using std::uint64_t;
+
+namespace
+{
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2,
+			  "Channels need address-free 64-bit atomics!");
+
+/**
+ * @brief Marks a channel segment that a publisher has finished setting up.
+ */
+constexpr uint64_t channel_magic = 0x314e48432d454c4dull;	// "MLE-CHN1"
+
+/**
+ * @brief The sequence number of a slot that the publisher is writing into.
+ */
+constexpr uint64_t writing = ~uint64_t{0};
+
+/**
+ * @brief The start of a channel segment.
+ * @detail Followed by `num_slots` SlotStates, and then, starting on a page
+ * 		boundary, by the slots' elements. Everything up to `data_offset` is
+ * 		mapped read-write by every process; the elements are only writable
+ * 		by the publisher.
+ */
+struct Header
+{
+	std::atomic<uint64_t> magic;
+	uint64_t num_slots;
+
+	/** @brief The number of elements that fit in a slot. */
+	uint64_t slot_capacity;
+
+	/** @brief The distance, in elements, between the starts of two slots. */
+	uint64_t slot_stride;
+
+	uint64_t data_offset;
+	uint64_t total_size;
+
+	/** @brief The sequence number of the latest message, or zero. */
+	alignas(64) std::atomic<uint64_t> latest;
+};
+
+/**
+ * @brief The state of one slot, on a cache line of its own.
+ * @detail The shape is only written while `sequence` is `writing`, and read
+ * 		by subscribers that have pinned the slot, so it needn't be atomic.
+ */
+struct alignas(64) SlotState
+{
+	/** @brief The sequence number of the message in the slot, or zero. */
+	std::atomic<uint64_t> sequence;
+
+	/** @brief The number of subscribers holding on to the message. */
+	std::atomic<uint64_t> readers;
+
+	uint64_t rows;
+	uint64_t cols;
+	Layout layout;
+};
+
+size_t roundUp(size_t value, size_t multiple)
+{
+	return (value + multiple - 1) / multiple * multiple;
+}
+
+size_t pageSize()
+{
+	return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+/**
+ * @brief Closes a file descriptor when it goes out of scope.
+ */
+class FileDescriptor
+{
+public:
+	explicit FileDescriptor(int fd) : fd{fd} {}
+	~FileDescriptor() { if (fd >= 0) close(fd); }
+	FileDescriptor(const FileDescriptor&) = delete;
+	FileDescriptor& operator=(const FileDescriptor&) = delete;
+
+	const int fd;
+};
+
+/**
+ * @brief Map `length` bytes of `fd` starting at `offset`, or throw.
+ */
+void* mapOrThrow(int fd, size_t length, size_t offset, bool writable)
+{
+	const int protection = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+	void* address = mmap(nullptr, length, protection, MAP_SHARED, fd,
+						 static_cast<off_t>(offset));
+	if (address == MAP_FAILED)
+	{
+		throw runtime_error{"Couldn't map shared memory channel!"};
+	}
+	return address;
+}
+
+} // anonymous namespace
+
+namespace shm
+{
+
+class Channel
+{
+public:
+
+	/**
+	 * @brief Map the channel segment open as `fd`, whose `Header` says how
+	 * 		it's laid out. The slots are only mapped writable if
+	 * 		`writable_slots` is set.
+	 */
+	Channel(int fd, const Header& layout, bool writable_slots)
+		: control_size{static_cast<size_t>(layout.data_offset)},
+		  data_size{static_cast<size_t>(layout.total_size - layout.data_offset)}
+	{
+		control = mapOrThrow(fd, control_size, 0, true);
+		try
+		{
+			data = mapOrThrow(fd, data_size, control_size, writable_slots);
+		}
+		catch (...)
+		{
+			munmap(control, control_size);
+			throw;
+		}
+
+		header = static_cast<Header*>(control);
+		slots = reinterpret_cast<SlotState*>(header + 1);
+		elements = static_cast<double*>(data);
+	}
+
+	~Channel()
+	{
+		munmap(data, data_size);
+		munmap(control, control_size);
+	}
+
+	Channel(const Channel&) = delete;
+	Channel& operator=(const Channel&) = delete;
+
+	SlotState& slot(uint64_t sequence)
+	{
+		return slots[sequence % header->num_slots];
+	}
+
+	double* slotData(uint64_t sequence)
+	{
+		return elements + sequence % header->num_slots * header->slot_stride;
+	}
+
+	Header* header{nullptr};
+
+private:
+
+	SlotState* slots{nullptr};
+	double* elements{nullptr};
+
+	void* control{nullptr};
+	void* data{nullptr};
+	const size_t control_size;
+	const size_t data_size;
+};
+
+Publisher::Publisher(const std::string& name, size_t num_slots,
+					 size_t max_elements)
+	: channel_name{name}
+{
+	if (num_slots == 0)
+	{
+		throw runtime_error{"A channel needs at least one slot!"};
+	}
+
+	// Each slot starts on a cache line, like any other Array2D's storage.
+	Header layout;
+	layout.num_slots = num_slots;
+	layout.slot_capacity = max_elements;
+	layout.slot_stride = roundUp(std::max<size_t>(max_elements, 1),
+								 Array2D::alignment / sizeof(double));
+	layout.data_offset = roundUp(sizeof(Header) + num_slots * sizeof(SlotState),
+								 pageSize());
+	layout.total_size = layout.data_offset
+		+ roundUp(num_slots * layout.slot_stride * sizeof(double), pageSize());
+
+	// Replace any leftover channel of the same name, rather than attaching to
+	// it: its ring may not be laid out the same way.
+	shm_unlink(name.c_str());
+	const FileDescriptor file{shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR,
+									   0600)};
+	if (file.fd < 0
+		or ftruncate(file.fd, static_cast<off_t>(layout.total_size)) != 0)
+	{
+		shm_unlink(name.c_str());
+		throw runtime_error{"Couldn't create shared memory channel " + name
+							+ "!"};
+	}
+
+	try
+	{
+		channel = std::make_shared<Channel>(file.fd, layout, true);
+	}
+	catch (...)
+	{
+		shm_unlink(name.c_str());
+		throw;
+	}
+
+	// The segment starts out zeroed, which is already a valid empty ring;
+	// constructing the atomics in place just makes that official.
+	Header* header = new (channel->header) Header;
+	header->num_slots = layout.num_slots;
+	header->slot_capacity = layout.slot_capacity;
+	header->slot_stride = layout.slot_stride;
+	header->data_offset = layout.data_offset;
+	header->total_size = layout.total_size;
+	header->latest.store(0, std::memory_order_relaxed);
+	for (size_t i = 0; i != num_slots; ++i)
+	{
+		SlotState* slot = new (&channel->slot(i)) SlotState;
+		slot->sequence.store(0, std::memory_order_relaxed);
+		slot->readers.store(0, std::memory_order_relaxed);
+	}
+	header->magic.store(channel_magic, std::memory_order_release);
+}
+
+Publisher::~Publisher()
+{
+	// A half-written slot would look like one that's about to be published,
+	// so mark its old message as gone instead.
+	if (have_acquired)
+	{
+		channel->slot(next_sequence).sequence.store(0, std::memory_order_release);
+	}
+	shm_unlink(channel_name.c_str());
+}
+
+Array2D* Publisher::tryAcquire(size_t rows, size_t cols, Layout layout)
+{
+	if (rows * cols > channel->header->slot_capacity)
+	{
+		throw runtime_error{"Array is too big for the channel's slots!"};
+	}
+
+	if (have_acquired)
+	{
+		acquired = Array2D::wrap(channel->slotData(next_sequence), rows, cols,
+								 layout, channel);
+		return &acquired;
+	}
+
+	const uint64_t first_sequence = next_sequence;
+	for (uint64_t attempt = 0; attempt != channel->header->num_slots;
+		 ++attempt, ++next_sequence)
+	{
+		// Claim the slot, then check for readers. A subscriber pins the slot,
+		// then checks its sequence number. With both sides sequentially
+		// consistent, either we see its pin or it sees our claim.
+		SlotState& slot = channel->slot(next_sequence);
+		const uint64_t previous = slot.sequence.load(std::memory_order_relaxed);
+		slot.sequence.store(writing);
+		if (slot.readers.load() != 0)
+		{
+			// Put the message back, and give up this sequence number if a
+			// later slot is free. Subscribers will see that it was skipped.
+			slot.sequence.store(previous, std::memory_order_release);
+			continue;
+		}
+
+		acquired = Array2D::wrap(channel->slotData(next_sequence), rows, cols,
+								 layout, channel);
+		have_acquired = true;
+		return &acquired;
+	}
+
+	// Nothing was claimed, so no sequence number was given up either.
+	// Otherwise, subscribers would count the unused ones as dropped.
+	next_sequence = first_sequence;
+	return nullptr;
+}
+
+void Publisher::publish()
+{
+	if (not have_acquired)
+	{
+		throw runtime_error{"No slot has been acquired to publish!"};
+	}
+
+	double* storage = channel->slotData(next_sequence);
+	const size_t rows = acquired.size().first;
+	const size_t cols = acquired.size().second;
+	if (acquired.data() != storage)
+	{
+		if (rows * cols > channel->header->slot_capacity)
+		{
+			throw runtime_error{"Array is too big for the channel's slots!"};
+		}
+		std::copy(acquired.data(), acquired.data() + rows * cols, storage);
+	}
+
+	SlotState& slot = channel->slot(next_sequence);
+	slot.rows = rows;
+	slot.cols = cols;
+	slot.layout = acquired.layout();
+	slot.sequence.store(next_sequence, std::memory_order_release);
+	channel->header->latest.store(next_sequence, std::memory_order_release);
+
+	++next_sequence;
+	++num_published;
+	have_acquired = false;
+	acquired = Array2D{};
+}
+
+bool Publisher::tryPublish(const Array2D& array)
+{
+	Array2D* slot = tryAcquire(array.size().first, array.size().second,
+							   array.layout());
+	if (not slot) return false;
+
+	std::copy(array.data(),
+			  array.data() + array.size().first * array.size().second,
+			  slot->data());
+	publish();
+	return true;
+}
+
+bool Publisher::tryPublish(const Matrix& mat)
+{
+	Array2D* slot = tryAcquire(mat.size().first, mat.size().second,
+							   mat.layout());
+	if (not slot) return false;
+
+	std::copy(mat.data(), mat.data() + mat.size().first * mat.size().second,
+			  slot->data());
+	publish();
+	return true;
+}
+
+uint64_t Publisher::published() const
+{
+	return num_published;
+}
+
+Subscriber::Subscriber(const std::string& name)
+{
+	const FileDescriptor file{shm_open(name.c_str(), O_RDWR, 0)};
+	struct stat status;
+	if (file.fd < 0 or fstat(file.fd, &status) != 0)
+	{
+		throw runtime_error{"Couldn't open shared memory channel " + name
+							+ "!"};
+	}
+
+	// Read the header on its own first, to find out how to map the rest.
+	const size_t file_size = static_cast<size_t>(status.st_size);
+	if (file_size < sizeof(Header))
+	{
+		throw runtime_error{name + " isn't a matrix channel!"};
+	}
+	const void* first_page = mapOrThrow(file.fd, sizeof(Header), 0, false);
+	const Header& peek = *static_cast<const Header*>(first_page);
+	const bool valid =
+		peek.magic.load(std::memory_order_acquire) == channel_magic
+		and peek.total_size == file_size;
+	Header layout;
+	layout.data_offset = peek.data_offset;
+	layout.total_size = peek.total_size;
+	munmap(const_cast<void*>(first_page), sizeof(Header));
+	if (not valid)
+	{
+		throw runtime_error{name + " isn't a matrix channel!"};
+	}
+
+	channel = std::make_shared<Channel>(file.fd, layout, false);
+
+	const uint64_t latest =
+		channel->header->latest.load(std::memory_order_acquire);
+	const uint64_t num_slots = channel->header->num_slots;
+	next_sequence = latest >= num_slots ? latest - num_slots + 1 : 1;
+}
+
+Subscriber::~Subscriber() = default;
+
+std::shared_ptr<const Array2D> Subscriber::tryReceive()
+{
+	const uint64_t latest =
+		channel->header->latest.load(std::memory_order_acquire);
+	const uint64_t num_slots = channel->header->num_slots;
+
+	while (next_sequence <= latest)
+	{
+		// Anything more than a ring's length behind has been overwritten.
+		if (latest - next_sequence >= num_slots)
+		{
+			const uint64_t oldest = latest - num_slots + 1;
+			num_dropped += oldest - next_sequence;
+			next_sequence = oldest;
+		}
+
+		// Pin the slot, then check that our message is still in it; see
+		// `Publisher::tryAcquire()`.
+		SlotState& slot = channel->slot(next_sequence);
+		slot.readers.fetch_add(1);
+		const uint64_t sequence = slot.sequence.load();
+		if (sequence == next_sequence)
+		{
+			const std::shared_ptr<SlotState> pin{&slot,
+				[owner = channel](SlotState* pinned) {
+					pinned->readers.fetch_sub(1, std::memory_order_release);
+				}};
+			++next_sequence;
+
+			// The subscriber's mapping of the slot is read-only, so the
+			// message has to stay const.
+			return std::make_shared<Array2D>(Array2D::wrap(
+				channel->slotData(sequence), slot.rows, slot.cols,
+				slot.layout, pin));
+		}
+		slot.readers.fetch_sub(1, std::memory_order_release);
+
+		// The publisher is writing into the slot, either our message or one
+		// that's overwriting it. Check back later.
+		if (sequence == writing) return nullptr;
+
+		// Otherwise, the publisher either overwrote our message (the slot
+		// has a newer one) or skipped its slot because it was pinned (the
+		// slot has an older one).
+		if (sequence > next_sequence) ++num_dropped;
+		++next_sequence;
+	}
+	return nullptr;
+}
+
+std::shared_ptr<const Array2D> Subscriber::receive(
+	std::chrono::microseconds timeout)
+{
+	const auto deadline = std::chrono::steady_clock::now() + timeout;
+	while (true)
+	{
+		std::shared_ptr<const Array2D> message = tryReceive();
+		if (message or std::chrono::steady_clock::now() >= deadline)
+		{
+			return message;
+		}
+		std::this_thread::yield();
+	}
+}
+
+uint64_t Subscriber::dropped() const
+{
+	return num_dropped;
+}
+
+} // namespace shm
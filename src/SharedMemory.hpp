@@ -0,0 +1,201 @@
+#ifndef MAAV_PROJECT_3_SHARED_MEMORY_HPP
+#define MAAV_PROJECT_3_SHARED_MEMORY_HPP
+
+#include "Array2D.hpp"
+#include "Matrix.hpp"
+
+#include <chrono>	// std::chrono::microseconds
+#include <cstdint>	// std::uint64_t
+#include <cstdlib>	// size_t
+#include <memory>	// std::shared_ptr
+#include <string>	// std::string
+
+/**
+ * @brief Passing matrices between processes on the same host through POSIX
+ * 		shared memory, without serializing or copying them.
+ * @detail A `Publisher` creates a named "channel": a ring of slots in a
+ * 		shared memory segment, each big enough for one Array2D. It fills a
+ * 		slot in place (`tryAcquire()`) and then publishes it, which takes a
+ * 		couple of atomic stores. Any number of `Subscriber`s, in any process,
+ * 		open the channel by name and receive every message from then on,
+ * 		each at its own pace. A received message is an Array2D whose storage
+ * 		is the slot itself, mapped read-only into the subscriber's process.
+ *
+ * 		Nothing takes a lock. Each slot has a sequence number, which the
+ * 		publisher bumps when it publishes into the slot, and a count of
+ * 		subscribers that are holding on to the message in it. While that
+ * 		count is nonzero, the publisher won't overwrite the slot, so a
+ * 		received message never changes underneath its reader. A subscriber
+ * 		that falls more than a ring's length behind skips ahead to the
+ * 		oldest message still in the ring (see `Subscriber::dropped()`).
+ *
+ * 		A subscriber that dies while holding on to a message leaves its slot
+ * 		pinned for good, and the publisher will have to skip it forever; see
+ * 		`Publisher::tryAcquire()`.
+ */
+namespace shm
+{
+
+/**
+ * @brief A channel's shared memory segment, mapped into this process.
+ */
+class Channel;
+
+/**
+ * @brief The writing end of a channel. There can only be one per channel.
+ */
+class Publisher
+{
+public:
+
+	/**
+	 * @brief Create a channel called `name` with `num_slots` slots, each
+	 * 		holding up to `max_elements` doubles.
+	 * @detail `name` follows the rules for `shm_open()`: it should start
+	 * 		with a slash and have no others. A stale channel with the same
+	 * 		name (e.g. from a publisher that crashed) is replaced; processes
+	 * 		that still have it open keep it, but it won't get new messages.
+	 *
+	 * 		Throws an `std::runtime_error` if the channel can't be created,
+	 * 		or if `num_slots` is zero.
+	 */
+	Publisher(const std::string& name, size_t num_slots, size_t max_elements);
+
+	/**
+	 * @brief Remove the channel's name, so that no more subscribers can open
+	 * 		it. Existing subscribers can still read what was published.
+	 */
+	~Publisher();
+
+	Publisher(const Publisher&) = delete;
+	Publisher& operator=(const Publisher&) = delete;
+
+	/**
+	 * @brief Claim the next slot, and return an Array2D of the given shape
+	 * 		that lives in it, for the caller to fill in and `publish()`.
+	 * @return `nullptr` if subscribers are still reading every slot.
+	 * @detail Slots that subscribers are still reading are skipped over, so
+	 * 		a slot pinned by a dead subscriber only costs a slot. A call that
+	 * 		returns `nullptr` leaves the channel as it was. Calling
+	 * 		this again before publishing reshapes the same slot.
+	 *
+	 * 		The Array2D isn't zeroed: it holds whatever was last published in
+	 * 		the slot. Its storage is only valid until `publish()` is called.
+	 * 		Throws an `std::runtime_error` if `rows * cols` exceeds the
+	 * 		slots' capacity.
+	 */
+	Array2D* tryAcquire(size_t rows, size_t cols,
+						Layout layout = Layout::RowMajor);
+
+	/**
+	 * @brief Publish the slot claimed by the last call to `tryAcquire()`.
+	 * @detail If the acquired Array2D was assigned a different array in the
+	 * 		meantime, that array is copied into the slot first. Throws an
+	 * 		`std::runtime_error` if no slot is claimed, or if the array no
+	 * 		longer fits.
+	 */
+	void publish();
+
+	/**
+	 * @brief Copy `array` into the next slot and publish it.
+	 * @return False, without publishing, if every slot is still being read.
+	 */
+	bool tryPublish(const Array2D& array);
+	bool tryPublish(const Matrix& mat);
+
+	/**
+	 * @brief Return the number of messages published so far.
+	 */
+	std::uint64_t published() const;
+
+private:
+
+	/**
+	 * @brief The mapped channel, shared with the Array2Ds handed out by
+	 * 		`tryAcquire()`.
+	 */
+	std::shared_ptr<Channel> channel;
+
+	std::string channel_name;
+
+	/**
+	 * @brief The sequence number of the next message, which goes in slot
+	 * 		`next_sequence % num_slots`. Messages are numbered from one.
+	 */
+	std::uint64_t next_sequence{1};
+
+	std::uint64_t num_published{0};
+
+	/**
+	 * @brief The array handed out by `tryAcquire()`, if it hasn't been
+	 * 		published yet.
+	 */
+	Array2D acquired;
+	bool have_acquired{false};
+};
+
+/**
+ * @brief A reading end of a channel.
+ * @detail A Subscriber isn't safe to share between threads; give each
+ * 		thread its own, which costs one more mapping of the channel.
+ */
+class Subscriber
+{
+public:
+
+	/**
+	 * @brief Open the channel called `name`.
+	 * @detail Starts from the oldest message still in the ring, so that
+	 * 		messages published just before the subscriber opened the channel
+	 * 		aren't missed. Throws an `std::runtime_error` if there's no such
+	 * 		channel.
+	 */
+	explicit Subscriber(const std::string& name);
+
+	~Subscriber();
+
+	Subscriber(const Subscriber&) = delete;
+	Subscriber& operator=(const Subscriber&) = delete;
+
+	/**
+	 * @brief Return the next message, or `nullptr` if there isn't one yet.
+	 * @detail The message's storage is its slot in the channel, mapped
+	 * 		read-only. The publisher won't reuse the slot until every copy of
+	 * 		the returned pointer is gone, so let go of it promptly; copy the
+	 * 		Array2D to keep its contents around longer.
+	 */
+	std::shared_ptr<const Array2D> tryReceive();
+
+	/**
+	 * @brief Wait up to `timeout` for the next message.
+	 * @return `nullptr` if none arrived in time.
+	 * @detail Polls the channel, yielding the processor in between, so a
+	 * 		message is picked up within microseconds of being published.
+	 */
+	std::shared_ptr<const Array2D> receive(std::chrono::microseconds timeout);
+
+	/**
+	 * @brief Return the number of messages this Subscriber missed because it
+	 * 		fell too far behind the publisher.
+	 */
+	std::uint64_t dropped() const;
+
+private:
+
+	/**
+	 * @brief The mapped channel, shared with the messages handed out by
+	 * 		`tryReceive()`.
+	 */
+	std::shared_ptr<Channel> channel;
+
+	/**
+	 * @brief The sequence number of the next message to receive.
+	 */
+	std::uint64_t next_sequence{1};
+
+	std::uint64_t num_dropped{0};
+};
+
+} // namespace shm
+
+#endif
@@ -0,0 +1,182 @@
+#include "Symmetric.hpp"
+#include "Decompositions.hpp"
+#include "Kernels.hpp"
+#include "Parallel.hpp"
+
+#include <algorithm>	// std::copy, std::fill, std::min
+#include <stdexcept>	// std::runtime_error
+#include <string>		// std::string
+#include <utility>		// std::make_pair
+
+using std::runtime_error;
+
+namespace
+{
+
+/**
+ * @brief The side length of the square tiles that the result is computed in.
+ */
+constexpr size_t tile_size = 64;
+
+/**
+ * @brief Make sure that `array` is `rows x cols`, reallocating if needed.
+ * @detail The contents are unspecified afterwards.
+ */
+void ensureSize(Array2D& array, size_t rows, size_t cols)
+{
+	if (array.size() != std::make_pair(rows, cols))
+	{
+		array = Array2D{rows, cols};
+	}
+}
+
+void checkSize(const Matrix& mat, size_t rows, size_t cols, const char* what)
+{
+	if (mat.size() != std::make_pair(rows, cols))
+	{
+		throw runtime_error{std::string{what} + " has the wrong dimensions!"};
+	}
+}
+
+/**
+ * @brief `C += alpha * X * Y'`, computing only the tiles that intersect the
+ * 		upper triangle of `C`.
+ * @detail `X` and `Y` are `n x k`; `C` is `n x n`. `Y'` is materialized in
+ * 		`transposed`, so that every tile is a plain GEMM.
+ */
+void upperTimesTranspose(size_t n, size_t k, double alpha,
+						 const double* x, const double* y,
+						 Array2D& transposed, double* c)
+{
+	if (n == 0 or k == 0) return;
+
+	const kernels::KernelTable& kernel = kernels::active();
+	ensureSize(transposed, k, n);
+	double* yt = transposed.data();
+	kernel.transpose(n, k, y, k, yt, n);
+
+	const size_t num_tiles = (n + tile_size - 1) / tile_size;
+	parallel::forRange(0, num_tiles, 1, [&](size_t first, size_t last) {
+		for (size_t tile_row = first; tile_row != last; ++tile_row)
+		{
+			const size_t i0 = tile_row * tile_size;
+			const size_t rows = std::min(tile_size, n - i0);
+
+			// Tiles on the diagonal are computed in full; the wasted lower
+			// half of each one is overwritten by `mirrorUpper()`.
+			kernel.gemm(rows, n - i0, k, alpha, x + i0 * k, k, yt + i0, n,
+						c + i0 * n + i0, n);
+		}
+	});
+}
+
+/**
+ * @brief Copy the upper triangle of the `n x n` array `c` into its lower
+ * 		triangle.
+ */
+void mirrorUpper(size_t n, double* c)
+{
+	for (size_t row = 1; row < n; ++row)
+	{
+		for (size_t col = 0; col != row; ++col)
+		{
+			c[row * n + col] = c[col * n + row];
+		}
+	}
+}
+
+/**
+ * @brief `G = A * L`, where `L` is the `m x m` lower-triangular array
+ * 		produced by `choleskyFactor()`, and `A` is `n x m`.
+ * @detail Row block `J` of `L` only has nonzeros in its first
+ * 		`j0 + rows(J)` columns, so each block product skips the zero part.
+ */
+void timesLower(size_t n, size_t m, const double* a, const double* l,
+				double* g)
+{
+	const kernels::KernelTable& kernel = kernels::active();
+	std::fill(g, g + n * m, 0.0);
+
+	for (size_t j0 = 0; j0 < m; j0 += tile_size)
+	{
+		const size_t block = std::min(tile_size, m - j0);
+		kernel.gemm(n, j0 + block, block, 1.0, a + j0, m, l + j0 * m, m, g, m);
+	}
+}
+
+} // anonymous namespace
+
+namespace symmetric
+{
+
+void rankK(const Matrix& a_in, Matrix& out, Workspace& work,
+		   double alpha, double beta)
+{
+	// The symmetric arguments read the same in either layout; A doesn't.
+	const Matrix a = a_in.toLayout(Layout::RowMajor);
+	const size_t n = a.size().first;
+	const size_t k = a.size().second;
+	checkSize(out, n, n, "Output matrix");
+
+	double* c = out.data();
+	for (size_t row = 0; row != n; ++row)
+	{
+		double* c_row = c + row * n;
+		for (size_t col = row; col != n; ++col)
+		{
+			c_row[col] = beta == 0.0 ? 0.0 : beta * c_row[col];
+		}
+	}
+
+	upperTimesTranspose(n, k, alpha, a.data(), a.data(), work.transposed, c);
+	mirrorUpper(n, c);
+}
+
+void sandwich(const Matrix& a_in, const Matrix& p, const Matrix& q,
+			  Matrix& out, Workspace& work)
+{
+	const size_t n = a_in.size().first;
+	const size_t m = a_in.size().second;
+	checkSize(p, m, m, "Covariance matrix");
+	checkSize(q, n, n, "Process noise matrix");
+	checkSize(out, n, n, "Output matrix");
+	if (&out == &a_in or &out == &p)
+	{
+		throw runtime_error{"Output matrix may not alias A or P!"};
+	}
+	const Matrix a = a_in.toLayout(Layout::RowMajor);
+
+	double* c = out.data();
+	if (&q != &out)
+	{
+		const double* q_vals = q.data();
+		for (size_t row = 0; row != n; ++row)
+		{
+			std::copy(q_vals + row * n + row, q_vals + (row + 1) * n,
+					  c + row * n + row);
+		}
+	}
+
+	ensureSize(work.factor, m, m);
+	ensureSize(work.product, n, m);
+	std::copy(p.data(), p.data() + m * m, work.factor.data());
+	double* g = work.product.data();
+
+	if (choleskyFactor(work.factor))
+	{
+		// A * P * A' == (A * L) * (A * L)'
+		timesLower(n, m, a.data(), work.factor.data(), g);
+		upperTimesTranspose(n, m, 1.0, g, g, work.transposed, c);
+	}
+	else
+	{
+		// P is only semi-definite (or worse); use it as-is.
+		std::fill(g, g + n * m, 0.0);
+		kernels::active().gemm(n, m, m, 1.0, a.data(), m, p.data(), m, g, m);
+		upperTimesTranspose(n, m, 1.0, g, a.data(), work.transposed, c);
+	}
+
+	mirrorUpper(n, c);
+}
+
+} // namespace symmetric
@@ -0,0 +1,75 @@
+#ifndef MAAV_PROJECT_3_SYMMETRIC_HPP
+#define MAAV_PROJECT_3_SYMMETRIC_HPP
+
+#include "Array2D.hpp"
+#include "Matrix.hpp"
+
+/**
+ * @brief Fused kernels for products whose result is known to be symmetric.
+ * @detail The covariance update in a Kalman filter,
+ * 				P' = A * P * A' + Q
+ *
+ * 		...is symmetric by construction. Written with `operator*`,
+ * 		`transpose()`, and `operator+`, it allocates three temporaries and
+ * 		computes both triangles of the result. The functions below compute
+ * 		only the upper triangle, mirror it into the lower one, and write
+ * 		straight into a caller-provided Matrix.
+ *
+ * 		Scratch space comes from a `Workspace` that the caller keeps around
+ * 		between calls; once it has grown to the right size, no further
+ * 		memory is allocated, unless `A` is column-major and has to be
+ * 		converted first.
+ *
+ * 		As with the rest of the library, these throw `std::runtime_error`s
+ * 		on blank or mis-sized matrices. A symmetric matrix is stored the
+ * 		same way in either layout, so only `A` is ever converted.
+ */
+namespace symmetric
+{
+
+/**
+ * @brief Reusable scratch space for the functions in this namespace.
+ * @detail Each member is only reallocated when a call needs a different
+ * 		size than the previous one.
+ */
+struct Workspace
+{
+	/** @brief The Cholesky factor of `P`, in `sandwich()`. */
+	Array2D factor;
+
+	/** @brief `A * L` (or `A * P`), in `sandwich()`. */
+	Array2D product;
+
+	/** @brief A transposed copy of the right-hand factor. */
+	Array2D transposed;
+};
+
+/**
+ * @brief Compute `out = alpha * A * A' + beta * out`.
+ * @detail A symmetric rank-k update ("SYRK"). `A` is `n x k`, and `out`
+ * 		must already be `n x n`. Only the upper triangle of `out` is read.
+ * 		If `beta` is zero, `out`'s old contents are ignored entirely.
+ */
+void rankK(const Matrix& a, Matrix& out, Workspace& work,
+		   double alpha = 1.0, double beta = 0.0);
+
+/**
+ * @brief Compute `out = A * P * A' + Q`.
+ * @detail `A` is `n x m`; `P` must be a symmetric `m x m` Matrix, and `Q`
+ * 		and `out` must be symmetric `n x n` matrices. Only the upper
+ * 		triangle of `Q` is read. `Q` may be the same object as `out`, but `A`
+ * 		and `P` may not.
+ *
+ * 		When `P` is positive-definite (the usual case for a covariance), it
+ * 		is factored as `L * L'`, and the result is computed as
+ * 		`(A * L) * (A * L)' + Q`. `A * L` only touches the nonzero half of
+ * 		`L`, and the final product only computes one triangle, so this takes
+ * 		roughly half the flops of the naive expression. Otherwise, it falls
+ * 		back to computing `(A * P) * A'`, still one triangle at a time.
+ */
+void sandwich(const Matrix& a, const Matrix& p, const Matrix& q, Matrix& out,
+			  Workspace& work);
+
+} // namespace symmetric
+
+#endif
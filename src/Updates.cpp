@@ -0,0 +1,337 @@
+#include "Updates.hpp"
+#include "Array2D.hpp"
+#include "Decompositions.hpp"
+#include "Kernels.hpp"
+
+#include <algorithm>	// std::copy, std::min
+#include <cmath>		// std::hypot, std::sqrt
+#include <stdexcept>	// std::runtime_error
+#include <string>		// std::string
+#include <utility>		// std::make_pair
+#include <vector>		// std::vector
+
+using std::runtime_error;
+
+namespace
+{
+
+void checkSize(const Matrix& mat, size_t rows, size_t cols, const char* what)
+{
+	if (mat.size() != std::make_pair(rows, cols))
+	{
+		throw runtime_error{std::string{what} + " has the wrong dimensions!"};
+	}
+}
+
+size_t checkSquare(const Matrix& mat, const char* what)
+{
+	const size_t n = mat.size().first;
+	checkSize(mat, n, n, what);
+	return n;
+}
+
+/**
+ * @brief Call `update` on a row-major copy of `mat` if `mat` is column-major,
+ * 		and then copy the result back.
+ * @return False, without calling `update`, if `mat` is already row-major.
+ * @detail The routines below index row-major storage directly. Converting
+ * 		costs O(n^2), like the updates themselves. If `update` throws,
+ * 		`mat` is left alone.
+ */
+template <typename Update>
+bool viaRowMajor(Matrix& mat, Update update)
+{
+	if (mat.layout() == Layout::RowMajor) return false;
+
+	Matrix row_major = mat.toLayout(Layout::RowMajor);
+	update(row_major);
+	mat = row_major.toLayout(mat.layout());
+	return true;
+}
+
+/**
+ * @brief A plane rotation that maps `(a, b)` to `(hypot(a, b), 0)`.
+ */
+struct Givens
+{
+	Givens(double a, double b)
+	{
+		const double radius = std::hypot(a, b);
+		c = radius == 0.0 ? 1.0 : a / radius;
+		s = radius == 0.0 ? 0.0 : b / radius;
+	}
+
+	/**
+	 * @brief Rotate `(x[i], y[i])` for each `i` in `[first, last)`, where
+	 * 		consecutive elements are `stride` apart.
+	 */
+	void apply(double* x, double* y, size_t first, size_t last,
+			   size_t stride) const
+	{
+		for (size_t i = first; i < last; ++i)
+		{
+			const double x_i = x[i * stride];
+			const double y_i = y[i * stride];
+			x[i * stride] = c * x_i + s * y_i;
+			y[i * stride] = c * y_i - s * x_i;
+		}
+	}
+
+	double c;
+	double s;
+};
+
+} // anonymous namespace
+
+namespace updates
+{
+
+void shermanMorrison(Matrix& inverse, const Matrix& u, const Matrix& v)
+{
+	const size_t n = checkSquare(inverse, "Inverse");
+	checkSize(u, n, 1, "Update vector u");
+	checkSize(v, n, 1, "Update vector v");
+	if (viaRowMajor(inverse, [&](Matrix& row_major) {
+			shermanMorrison(row_major, u, v);
+		}))
+	{
+		return;
+	}
+
+	const kernels::KernelTable& kernel = kernels::active();
+	double* inv = inverse.data();
+
+	// w = A^-1 * u and z' = v' * A^-1
+	std::vector<double> w(n, 0.0);
+	std::vector<double> z(n, 0.0);
+	kernel.gemm(n, 1, n, 1.0, inv, n, u.data(), 1, w.data(), 1);
+	kernel.gemm(1, n, n, 1.0, v.data(), n, inv, n, z.data(), n);
+
+	const double denom = 1.0 + kernel.dot(n, v.data(), w.data());
+	if (denom == 0.0)
+	{
+		throw runtime_error{"Update makes the matrix singular!"};
+	}
+
+	kernel.gemm(n, n, 1, -1.0 / denom, w.data(), 1, z.data(), n, inv, n);
+}
+
+void woodbury(Matrix& inverse, const Matrix& u_in, const Matrix& c,
+			  const Matrix& v_in)
+{
+	const size_t n = checkSquare(inverse, "Inverse");
+	const size_t k = checkSquare(c, "Matrix C");
+	checkSize(u_in, n, k, "Matrix U");
+	checkSize(v_in, n, k, "Matrix V");
+	if (viaRowMajor(inverse, [&](Matrix& row_major) {
+			woodbury(row_major, u_in, c, v_in);
+		}))
+	{
+		return;
+	}
+	const Matrix u = u_in.toLayout(Layout::RowMajor);
+	const Matrix v = v_in.toLayout(Layout::RowMajor);
+
+	const kernels::KernelTable& kernel = kernels::active();
+	double* inv = inverse.data();
+
+	// AU = A^-1 * U and VA = V' * A^-1
+	Array2D au{n, k};
+	Array2D vt{k, n};
+	Array2D va{k, n};
+	kernel.gemm(n, k, n, 1.0, inv, n, u.data(), k, au.data(), k);
+	kernel.transpose(n, k, v.data(), k, vt.data(), n);
+	kernel.gemm(k, n, n, 1.0, vt.data(), n, inv, n, va.data(), n);
+
+	// S = C^-1 + V' * A^-1 * U, the "capacitance" matrix.
+	const Matrix c_inv = c.inverse().toLayout(Layout::RowMajor);
+	Array2D capacitance{k, k};
+	std::copy(c_inv.data(), c_inv.data() + k * k, capacitance.data());
+	kernel.gemm(k, k, n, 1.0, vt.data(), n, au.data(), k,
+				capacitance.data(), k);
+
+	std::vector<size_t> pivots;
+	if (not luFactor(capacitance, pivots))
+	{
+		throw runtime_error{"Update makes the matrix singular!"};
+	}
+	luSolve(capacitance, pivots, va);
+
+	// A^-1 - AU * S^-1 * VA
+	kernel.gemm(n, n, k, -1.0, au.data(), k, va.data(), n, inv, n);
+}
+
+void choleskyUpdate(Matrix& l, const Matrix& x)
+{
+	const size_t n = checkSquare(l, "Cholesky factor");
+	checkSize(x, n, 1, "Update vector");
+	if (viaRowMajor(l, [&](Matrix& row_major) {
+			choleskyUpdate(row_major, x);
+		}))
+	{
+		return;
+	}
+
+	std::vector<double> work(x.data(), x.data() + n);
+	double* factor = l.data();
+
+	for (size_t k = 0; k != n; ++k)
+	{
+		const double diag = factor[k * n + k];
+		const double radius = std::hypot(diag, work[k]);
+		const double c = radius / diag;
+		const double s = work[k] / diag;
+		factor[k * n + k] = radius;
+
+		for (size_t i = k + 1; i < n; ++i)
+		{
+			double& l_ik = factor[i * n + k];
+			l_ik = (l_ik + s * work[i]) / c;
+			work[i] = c * work[i] - s * l_ik;
+		}
+	}
+}
+
+void choleskyDowndate(Matrix& l, const Matrix& x)
+{
+	const size_t n = checkSquare(l, "Cholesky factor");
+	checkSize(x, n, 1, "Downdate vector");
+	if (viaRowMajor(l, [&](Matrix& row_major) {
+			choleskyDowndate(row_major, x);
+		}))
+	{
+		return;
+	}
+
+	double* factor = l.data();
+
+	// `A - x * x'` is positive-definite exactly when `p = L^-1 * x` has
+	// `p' * p < 1`. Checking first keeps `l` intact on failure.
+	std::vector<double> p(x.data(), x.data() + n);
+	double norm_sq = 0.0;
+	for (size_t row = 0; row != n; ++row)
+	{
+		const double* l_row = factor + row * n;
+		for (size_t col = 0; col != row; ++col) p[row] -= l_row[col] * p[col];
+		p[row] /= l_row[row];
+		norm_sq += p[row] * p[row];
+	}
+	if (not (norm_sq < 1.0))
+	{
+		throw runtime_error{"Downdate makes the matrix indefinite!"};
+	}
+
+	std::vector<double> work(x.data(), x.data() + n);
+	for (size_t k = 0; k != n; ++k)
+	{
+		const double diag = factor[k * n + k];
+		const double radius = std::sqrt((diag - work[k]) * (diag + work[k]));
+		const double c = radius / diag;
+		const double s = work[k] / diag;
+		factor[k * n + k] = radius;
+
+		for (size_t i = k + 1; i < n; ++i)
+		{
+			double& l_ik = factor[i * n + k];
+			l_ik = (l_ik - s * work[i]) / c;
+			work[i] = c * work[i] - s * l_ik;
+		}
+	}
+}
+
+void qrAppendRow(Matrix& q, Matrix& r, const Matrix& row)
+{
+	const size_t m = checkSquare(q, "Matrix Q");
+	const size_t n = r.size().second;
+	checkSize(r, m, n, "Matrix R");
+	checkSize(row, 1, n, "New row");
+	if (viaRowMajor(q, [&](Matrix& row_major) {
+			qrAppendRow(row_major, r, row);
+		})
+		or viaRowMajor(r, [&](Matrix& row_major) {
+			qrAppendRow(q, row_major, row);
+		}))
+	{
+		return;
+	}
+
+	// [A; row] = [Q 0; 0 1] * [R; row]
+	q.resize(m + 1, m + 1);
+	q(m + 1, m + 1) = 1.0;
+	r.resize(m + 1, n);
+	std::copy(row.data(), row.data() + n, r.data() + m * n);
+
+	// Rotate the new row into each of the old ones until it's zero below
+	// the diagonal.
+	double* q_vals = q.data();
+	double* r_vals = r.data();
+	double* new_row = r_vals + m * n;
+	for (size_t j = 0; j < std::min(m, n); ++j)
+	{
+		if (new_row[j] == 0.0) continue;
+
+		const Givens rotation{r_vals[j * n + j], new_row[j]};
+		rotation.apply(r_vals + j * n, new_row, j, n, 1);
+		new_row[j] = 0.0;
+		rotation.apply(q_vals + j, q_vals + m, 0, m + 1, m + 1);
+	}
+}
+
+void qrDeleteRow(Matrix& q, Matrix& r, size_t row)
+{
+	const size_t m = checkSquare(q, "Matrix Q");
+	const size_t n = r.size().second;
+	checkSize(r, m, n, "Matrix R");
+	if (row == 0)
+	{
+		throw runtime_error{"Matrix indices start from one!"};
+	}
+	if (row > m)
+	{
+		throw runtime_error{"Cannot delete a row that doesn't exist!"};
+	}
+	if (viaRowMajor(q, [&](Matrix& row_major) {
+			qrDeleteRow(row_major, r, row);
+		})
+		or viaRowMajor(r, [&](Matrix& row_major) {
+			qrDeleteRow(q, row_major, row);
+		}))
+	{
+		return;
+	}
+	const size_t k = row - 1;
+
+	// Rotate row `k` of Q into `e_1`, from the right end inwards. Each
+	// rotation leaves one entry below R's diagonal, so R ends up upper
+	// Hessenberg...
+	double* q_vals = q.data();
+	double* r_vals = r.data();
+	for (size_t j = m - 1; j > 0; --j)
+	{
+		const Givens rotation{q_vals[k * m + j - 1], q_vals[k * m + j]};
+		rotation.apply(q_vals + j - 1, q_vals + j, 0, m, m);
+		q_vals[k * m + j] = 0.0;
+		rotation.apply(r_vals + (j - 1) * n, r_vals + j * n,
+					   std::min(j - 1, n), n, 1);
+	}
+
+	// ...and since column one of Q is now `e_k`, dropping it along with row
+	// `k` of Q and row one of R leaves a triangular factorization of the
+	// remaining rows.
+	Matrix new_q{m - 1, m - 1};
+	Matrix new_r{m - 1, n};
+	double* new_q_vals = new_q.data();
+	for (size_t i = 0, dest = 0; i != m; ++i)
+	{
+		if (i == k) continue;
+		std::copy(q_vals + i * m + 1, q_vals + (i + 1) * m,
+				  new_q_vals + dest * (m - 1));
+		++dest;
+	}
+	std::copy(r_vals + n, r_vals + m * n, new_r.data());
+
+	q = new_q;
+	r = new_r;
+}
+
+} // namespace updates
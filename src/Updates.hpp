@@ -0,0 +1,87 @@
+#ifndef MAAV_PROJECT_3_UPDATES_HPP
+#define MAAV_PROJECT_3_UPDATES_HPP
+
+#include "Matrix.hpp"
+
+#include <cstdlib>	// size_t
+
+/**
+ * @brief Cheap updates to inverses and factorizations after a small change
+ * 		to the underlying matrix.
+ * @detail Recomputing an inverse or a factorization from scratch costs
+ * 		O(n^3). When the matrix only changes by a low-rank term, or gains or
+ * 		loses one row, the old result can be patched in O(n^2) instead.
+ *
+ * 		Every function here works in place and throws an
+ * 		`std::runtime_error` if its arguments are blank or mis-sized. If an
+ * 		update can't be carried out (e.g. because it would make the matrix
+ * 		singular), the function throws *before* modifying anything. Vectors
+ * 		are passed as `n x 1` matrices. Matrices may have either layout,
+ * 		and keep theirs.
+ *
+ * 		Updates accumulate rounding error, so long-running code should
+ * 		refactor from scratch every so often.
+ */
+namespace updates
+{
+
+/**
+ * @brief Turn `inverse`, the inverse of some `A`, into the inverse of
+ * 		`A + u * v'`.
+ * @detail Uses the Sherman-Morrison formula. Costs three `n x n`
+ * 		matrix-vector passes. Throws if `A + u * v'` is singular.
+ */
+void shermanMorrison(Matrix& inverse, const Matrix& u, const Matrix& v);
+
+/**
+ * @brief Turn `inverse`, the inverse of some `A`, into the inverse of
+ * 		`A + U * C * V'`.
+ * @detail Uses the Woodbury identity. `U` and `V` are `n x k` and `C` is
+ * 		`k x k`; this costs O(n^2 * k + k^3), so it pays off while `k` is
+ * 		much smaller than `n`. Throws if `C` or `A + U * C * V'` is singular.
+ */
+void woodbury(Matrix& inverse, const Matrix& u, const Matrix& c,
+			  const Matrix& v);
+
+/**
+ * @brief Turn `l`, the Cholesky factor of some `A = L * L'`, into the
+ * 		Cholesky factor of `A + x * x'`.
+ * @detail `l` must be lower-triangular with a positive diagonal, e.g. the
+ * 		output of `choleskyFactor()`. A rank-one update of a
+ * 		positive-definite matrix is always positive-definite, so this only
+ * 		throws on bad arguments.
+ */
+void choleskyUpdate(Matrix& l, const Matrix& x);
+
+/**
+ * @brief Turn `l`, the Cholesky factor of some `A = L * L'`, into the
+ * 		Cholesky factor of `A - x * x'`.
+ * @detail Throws, leaving `l` as it was, if `A - x * x'` wouldn't be
+ * 		positive-definite.
+ */
+void choleskyDowndate(Matrix& l, const Matrix& x);
+
+/**
+ * @brief Update the full QR factorization `A = Q * R` of an `m x n`
+ * 		matrix after appending `row` (a `1 x n` Matrix) to the bottom of `A`.
+ * @detail `q` is `m x m` and orthogonal, and `r` is `m x n` and upper
+ * 		triangular (or trapezoidal); afterwards they're `(m + 1) x (m + 1)`
+ * 		and `(m + 1) x n`. Costs O(m^2 + m * n).
+ *
+ * 		An empty factorization, `q` being `0 x 0` and `r` being `0 x n`, is
+ * 		a valid starting point, so a QR factorization can be built up one
+ * 		row at a time.
+ */
+void qrAppendRow(Matrix& q, Matrix& r, const Matrix& row);
+
+/**
+ * @brief Update the full QR factorization `A = Q * R` after removing row
+ * 		`row` (counting from one) from `A`.
+ * @detail `q` shrinks to `(m - 1) x (m - 1)` and `r` to `(m - 1) x n`.
+ * 		Costs O(m^2 + m * n).
+ */
+void qrDeleteRow(Matrix& q, Matrix& r, size_t row);
+
+} // namespace updates
+
+#endif
@@ -0,0 +1,331 @@
+#include "Vector.hpp"
+#include "Kernels.hpp"
+#include "Parallel.hpp"
+
+#include <algorithm>	// std::max
+#include <atomic>		// std::atomic_thread_fence
+#include <cmath>		// std::sqrt
+#include <memory>		// std::make_shared
+#include <stdexcept>	// std::runtime_error
+
+using std::ostream;
+using std::runtime_error;
+
+namespace
+{
+
+/**
+ * @brief Matrix-vector products smaller than this many elements of the
+ * 		matrix run on the calling thread.
+ */
+constexpr size_t parallel_gemv_elements = 1 << 16;
+
+void checkNotBlank(const std::shared_ptr<Array2D>& contents)
+{
+	if (not contents)
+	{
+		throw runtime_error{"Operation invoked on a blank Vector!"};
+	}
+}
+
+size_t numElements(const Array2D& array)
+{
+	return array.size().first * array.size().second;
+}
+
+void checkSameSize(const Vector& lhs, const Vector& rhs)
+{
+	if (lhs.size() != rhs.size())
+	{
+		throw runtime_error{"Vector dimensions do not match!"};
+	}
+}
+
+} // anonymous namespace
+
+Vector::Vector(size_t n)
+	: contents{std::make_shared<Array2D>(n, 1)}
+{}
+
+Vector::Vector(const Matrix& mat)
+{
+	checkNotBlank(mat.contents);
+	if (mat.contents->size().first != 1 and mat.contents->size().second != 1)
+	{
+		throw runtime_error{"Only a single row or column can be a Vector!"};
+	}
+	contents = mat.contents;
+}
+
+Vector::Vector(const Vector& to_copy)
+{
+	if (to_copy.contents)
+	{
+		contents = std::make_shared<Array2D>(*to_copy.contents);
+	}
+}
+
+Vector& Vector::operator=(const Vector& assign_from)
+{
+	if (this == &assign_from) return *this;
+
+	if (not assign_from.contents)
+	{
+		contents.reset();
+	}
+	else if (contents and contents.use_count() == 1)
+	{
+		*contents = *assign_from.contents;
+	}
+	else
+	{
+		contents = std::make_shared<Array2D>(*assign_from.contents);
+	}
+	return *this;
+}
+
+Vector::~Vector() = default;
+
+size_t Vector::size() const
+{
+	checkNotBlank(contents);
+	return numElements(*contents);
+}
+
+double& Vector::operator()(size_t index)
+{
+	checkNotBlank(contents);
+	if (index == 0)
+	{
+		throw runtime_error{"Vector indices start from one!"};
+	}
+	if (index > size())
+	{
+		throw runtime_error{"Vector index out of range!"};
+	}
+	return mutableContents()[index - 1];
+}
+
+double Vector::operator()(size_t index) const
+{
+	checkNotBlank(contents);
+	if (index == 0)
+	{
+		throw runtime_error{"Vector indices start from one!"};
+	}
+	if (index > size())
+	{
+		throw runtime_error{"Vector index out of range!"};
+	}
+	return (*contents)[index - 1];
+}
+
+double* Vector::data()
+{
+	return mutableContents().data();
+}
+
+const double* Vector::data() const
+{
+	checkNotBlank(contents);
+	return contents->data();
+}
+
+Matrix Vector::toColumn()
+{
+	return toMatrix(size(), 1);
+}
+
+Matrix Vector::toRow()
+{
+	return toMatrix(1, size());
+}
+
+Array2D& Vector::mutableContents()
+{
+	checkNotBlank(contents);
+	if (contents.use_count() > 1)
+	{
+		contents = std::make_shared<Array2D>(*contents);
+	}
+	else
+	{
+		// See `Matrix::mutableContents()`.
+		std::atomic_thread_fence(std::memory_order_acquire);
+	}
+	return *contents;
+}
+
+Matrix Vector::toMatrix(size_t rows, size_t cols)
+{
+	checkNotBlank(contents);
+	if (contents->size() != std::make_pair(rows, cols))
+	{
+		if (contents.use_count() > 1)
+		{
+			contents = std::make_shared<Array2D>(*contents);
+		}
+		contents->reshape(rows, cols);
+	}
+
+	Matrix mat;
+	mat.contents = contents;
+	return mat;
+}
+
+Vector Vector::operator+(const Vector& rhs) const
+{
+	checkSameSize(*this, rhs);
+	Vector sum{*this};
+	double* out = sum.data();
+	kernels::active().add(size(), out, rhs.data(), out);
+	return sum;
+}
+
+Vector Vector::operator-(const Vector& rhs) const
+{
+	checkSameSize(*this, rhs);
+	Vector difference{*this};
+	double* out = difference.data();
+	kernels::active().subtract(size(), out, rhs.data(), out);
+	return difference;
+}
+
+Vector Vector::operator*(double alpha) const
+{
+	Vector product{size()};
+	kernels::active().scale(size(), alpha, data(), product.data());
+	return product;
+}
+
+Vector& Vector::operator*=(double alpha)
+{
+	double* vals = data();
+	kernels::active().scale(size(), alpha, vals, vals);
+	return *this;
+}
+
+Vector& Vector::axpy(double alpha, const Vector& x)
+{
+	checkSameSize(*this, x);
+	kernels::active().axpy(size(), alpha, x.data(), data());
+	return *this;
+}
+
+double Vector::dot(const Vector& rhs) const
+{
+	checkSameSize(*this, rhs);
+	return kernels::active().dot(size(), data(), rhs.data());
+}
+
+double Vector::norm() const
+{
+	return std::sqrt(dot(*this));
+}
+
+bool Vector::operator==(const Vector& rhs) const
+{
+	if (size() != rhs.size()) return false;
+
+	const double* lhs_vals = data();
+	const double* rhs_vals = rhs.data();
+	for (size_t i = 0; i != size(); ++i)
+	{
+		if (lhs_vals[i] != rhs_vals[i]) return false;
+	}
+	return true;
+}
+
+bool Vector::operator!=(const Vector& rhs) const
+{
+	return not (*this == rhs);
+}
+
+Vector operator*(double alpha, const Vector& x)
+{
+	return x * alpha;
+}
+
+Vector operator*(const Matrix& a, const Vector& x)
+{
+	Vector product{a.size().first};
+	gemv(1.0, a, x, product);
+	return product;
+}
+
+Vector transposeMultiply(const Matrix& a, const Vector& x)
+{
+	Vector product{a.size().second};
+	gemv(1.0, a, x, product, true);
+	return product;
+}
+
+void gemv(double alpha, const Matrix& a, const Vector& x, Vector& y,
+		  bool transposed)
+{
+	const size_t m = a.size().first;
+	const size_t n = a.size().second;
+	if (x.size() != (transposed ? m : n) or y.size() != (transposed ? n : m))
+	{
+		throw runtime_error{"Matrix dimensions are invalid for multiplication!"};
+	}
+
+	const kernels::KernelTable& kernel = kernels::active();
+	const double* a_vals = a.data();
+	const double* x_vals = x.data();
+	double* y_vals = y.data();
+
+	// The storage of a column-major A is the row-major storage of A', so
+	// `A * x` on it is `A' * x` on the storage, and vice versa. From here
+	// on, `rows x cols` is the shape of the storage viewed as row-major.
+	const bool row_major = a.layout() == Layout::RowMajor;
+	const size_t rows = row_major ? m : n;
+	const size_t cols = row_major ? n : m;
+	const bool by_columns = transposed == row_major;
+
+	if (m * n < parallel_gemv_elements)
+	{
+		if (by_columns)
+		{
+			kernel.gemvTransposed(rows, cols, alpha, a_vals, cols, x_vals,
+								  y_vals);
+		}
+		else
+		{
+			kernel.gemv(rows, cols, alpha, a_vals, cols, x_vals, y_vals);
+		}
+		return;
+	}
+
+	// Give each thread its own slice of `y`, so that no two threads write
+	// the same element: rows of the storage for `gemv`, and columns of it
+	// for `gemvTransposed`.
+	if (by_columns)
+	{
+		const size_t grain = std::max<size_t>(64, parallel_gemv_elements / rows);
+		parallel::forRange(0, cols, grain, [&](size_t first, size_t last) {
+			kernel.gemvTransposed(rows, last - first, alpha, a_vals + first,
+								  cols, x_vals, y_vals + first);
+		});
+	}
+	else
+	{
+		const size_t grain = std::max<size_t>(4, parallel_gemv_elements / cols);
+		parallel::forRange(0, rows, grain, [&](size_t first, size_t last) {
+			kernel.gemv(last - first, cols, alpha, a_vals + first * cols, cols,
+						x_vals, y_vals + first);
+		});
+	}
+}
+
+ostream& operator<<(ostream& os, const Vector& vec)
+{
+	os << "[";
+	for (size_t i = 1; i <= vec.size(); ++i)
+	{
+		if (i != 1) os << "\t";
+		os << vec(i);
+	}
+	os << "]\n";
+	return os;
+}
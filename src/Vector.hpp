@@ -0,0 +1,163 @@
+#ifndef MAAV_PROJECT_3_VECTOR_HPP
+#define MAAV_PROJECT_3_VECTOR_HPP
+
+#include "Array2D.hpp"
+#include "Matrix.hpp"
+
+#include <cstdlib>	// size_t
+#include <iostream>	// std::ostream
+#include <memory>	// std::shared_ptr
+
+/**
+ * @brief A dense vector of doubles.
+ * @detail An `n x 1` Matrix works as a vector, but every product with one
+ * 		goes through the general matrix-matrix path. Vector keeps its
+ * 		elements in one contiguous, aligned block and sends products,
+ * 		AXPYs, dot products, and scaling straight to the SIMD kernels (see
+ * 		`Kernels.hpp`), which is what memory-bound code wants.
+ *
+ * 		A Vector can share storage with an `n x 1` or `1 x n` Matrix, so
+ * 		converting between the two doesn't copy any elements. Whichever
+ * 		side is written to first makes a private copy (as in Matrix's
+ * 		copy-on-write mode), so they never see each other's changes.
+ * 		Copying one Vector into another is always a deep copy.
+ *
+ * 		Like Matrix, `operator()` indexes from one, and every method throws
+ * 		an `std::runtime_error` if invoked on a blank (default-constructed)
+ * 		Vector or if the sizes don't match.
+ */
+class Vector
+{
+public:
+
+	/**
+	 * @brief Create a "blank" Vector.
+	 */
+	Vector() = default;
+
+	/**
+	 * @brief Create a zero-initialized Vector with `n` elements.
+	 */
+	explicit Vector(size_t n);
+
+	/**
+	 * @brief Create a Vector that shares the elements of `mat`.
+	 * @detail `mat` must have exactly one row or exactly one column. No
+	 * 		elements are copied.
+	 */
+	explicit Vector(const Matrix& mat);
+
+	Vector(const Vector& to_copy);
+	Vector& operator=(const Vector& assign_from);
+	Vector(Vector&& to_move) noexcept = default;
+	Vector& operator=(Vector&& assign_from) noexcept = default;
+	~Vector();
+
+	/**
+	 * @brief Return the number of elements.
+	 */
+	size_t size() const;
+
+	double& operator()(size_t index);
+	double operator()(size_t index) const;
+
+	/**
+	 * @brief Return a pointer to the elements, aligned to
+	 * 		`Array2D::alignment` bytes.
+	 * @detail Like the non-const `operator()`, this first makes a private
+	 * 		copy of storage that's shared with a Matrix.
+	 */
+	double* data();
+	const double* data() const;
+
+	/**
+	 * @brief Return an `n x 1` Matrix that shares this Vector's elements.
+	 * @detail Not const, because it may reshape this Vector's storage (or
+	 * 		give it a private copy to reshape). To convert a const Vector,
+	 * 		convert a copy of it.
+	 */
+	Matrix toColumn();
+
+	/**
+	 * @brief Return a `1 x n` Matrix that shares this Vector's elements.
+	 * @detail Not const, for the same reason as `toColumn()`.
+	 */
+	Matrix toRow();
+
+	Vector operator+(const Vector& rhs) const;
+	Vector operator-(const Vector& rhs) const;
+	Vector operator*(double alpha) const;
+
+	/**
+	 * @brief Multiply every element by `alpha`, in place.
+	 */
+	Vector& operator*=(double alpha);
+
+	/**
+	 * @brief `(*this) += alpha * x`, in place.
+	 */
+	Vector& axpy(double alpha, const Vector& x);
+
+	/**
+	 * @brief Return the dot product of this Vector with `rhs`.
+	 */
+	double dot(const Vector& rhs) const;
+
+	/**
+	 * @brief Return the Euclidean norm of this Vector.
+	 */
+	double norm() const;
+
+	bool operator==(const Vector& rhs) const;
+	bool operator!=(const Vector& rhs) const;
+
+private:
+
+	/**
+	 * @brief Return `contents`, first making a private copy of it if it's
+	 * 		shared with a Matrix. Throws if this Vector is blank.
+	 */
+	Array2D& mutableContents();
+
+	/**
+	 * @brief Return an `rows x cols` Matrix that shares `contents`.
+	 * @detail Reshapes `contents` in place if nobody else can see it, and
+	 * 		copies it otherwise. A Vector doesn't care about the shape of its
+	 * 		storage, only about the number of elements.
+	 */
+	Matrix toMatrix(size_t rows, size_t cols);
+
+	/**
+	 * @brief This Vector's elements, as a single row or a single column.
+	 */
+	std::shared_ptr<Array2D> contents;
+};
+
+Vector operator*(double alpha, const Vector& x);
+
+/**
+ * @brief Return `a * x`.
+ * @detail Large products are split by rows among threads.
+ */
+Vector operator*(const Matrix& a, const Vector& x);
+
+/**
+ * @brief Return `a' * x`, without forming `a'`.
+ */
+Vector transposeMultiply(const Matrix& a, const Vector& x);
+
+/**
+ * @brief `y += alpha * a * x`, or `y += alpha * a' * x` if `transposed` is
+ * 		true.
+ * @detail Allocates nothing, so it's the one to use in inner loops. `y`
+ * 		mustn't be the same Vector as `x`.
+ */
+void gemv(double alpha, const Matrix& a, const Vector& x, Vector& y,
+		  bool transposed = false);
+
+/**
+ * @brief Insert the vector into the stream as a single row, e.g. `[1	2	3]`.
+ */
+std::ostream& operator<<(std::ostream& os, const Vector& vec);
+
+#endif
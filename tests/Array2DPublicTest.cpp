@@ -0,0 +1,202 @@
+#define BOOST_TEST_MODULE Array2DPublicTest
+#include <boost/test/unit_test.hpp>
+
+#include "src/Array2D.hpp"
+#include "src/Parallel.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+BOOST_AUTO_TEST_CASE(testConstructorZeroInitializes)
+{
+	BOOST_TEST_MESSAGE("testConstructorZeroInitializes");
+
+	Array2D array{3, 4};
+	bool all_zero{true};
+	for (size_t row = 0; row != 3; ++row)
+	{
+		for (size_t col = 0; col != 4; ++col)
+		{
+			all_zero = all_zero and array(row, col) == 0.0;
+		}
+	}
+
+	BOOST_CHECK_MESSAGE((array.size() == std::make_pair<size_t, size_t>(3, 4)),
+		"testConstructorZeroInitializes failed!");
+	BOOST_CHECK_MESSAGE(all_zero, "testConstructorZeroInitializes failed!");
+}
+
+BOOST_AUTO_TEST_CASE(testIndexingIsRowMajor)
+{
+	BOOST_TEST_MESSAGE("testIndexingIsRowMajor");
+
+	Array2D array{2, 3};
+	array(1, 2) = 5.0;
+	array(0, 1) = 7.0;
+
+	BOOST_CHECK_MESSAGE(array[5] == 5.0 and array.data()[1] == 7.0,
+		"testIndexingIsRowMajor failed!");
+}
+
+BOOST_AUTO_TEST_CASE(testOutOfRangeThrows)
+{
+	BOOST_TEST_MESSAGE("testOutOfRangeThrows");
+
+	Array2D array{2, 2};
+	const Array2D& const_array = array;
+
+	BOOST_CHECK_THROW(array(2, 0), std::runtime_error);
+	BOOST_CHECK_THROW(const_array(0, 2), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(testCopyIsDeep)
+{
+	BOOST_TEST_MESSAGE("testCopyIsDeep");
+
+	Array2D original{2, 2};
+	original(0, 0) = 1.0;
+
+	Array2D copy{original};
+	copy(0, 0) = 2.0;
+
+	Array2D assigned{5, 5};
+	assigned = original;
+	assigned(0, 0) = 3.0;
+
+	BOOST_CHECK_MESSAGE(original(0, 0) == 1.0, "testCopyIsDeep failed!");
+	BOOST_CHECK_MESSAGE(assigned.size() == original.size(),
+		"testCopyIsDeep failed!");
+}
+
+BOOST_AUTO_TEST_CASE(testEmptyArray)
+{
+	BOOST_TEST_MESSAGE("testEmptyArray");
+
+	Array2D empty;
+	Array2D copy{empty};
+
+	BOOST_CHECK_MESSAGE(copy.data() == nullptr and copy.size().first == 0,
+		"testEmptyArray failed!");
+}
+
+BOOST_AUTO_TEST_CASE(testColumnMajorLayout)
+{
+	BOOST_TEST_MESSAGE("testColumnMajorLayout");
+
+	Array2D array{2, 3, Layout::ColumnMajor};
+	array(1, 2) = 5.0;
+	array(0, 1) = 7.0;
+
+	BOOST_CHECK_MESSAGE(array.layout() == Layout::ColumnMajor
+		and array.leadingDimension() == 2, "testColumnMajorLayout failed!");
+	BOOST_CHECK_MESSAGE(array[5] == 5.0 and array[2] == 7.0,
+		"testColumnMajorLayout failed!");
+	BOOST_CHECK_THROW(array(2, 0), std::runtime_error);
+
+	Array2D copy{array};
+	BOOST_CHECK_MESSAGE(copy.layout() == Layout::ColumnMajor
+		and copy(1, 2) == 5.0, "testColumnMajorLayout failed!");
+}
+
+BOOST_AUTO_TEST_CASE(testLayoutConversion)
+{
+	BOOST_TEST_MESSAGE("testLayoutConversion");
+
+	// Big and ragged enough to cross several tiles of the blocked transpose.
+	const size_t rows = 37;
+	const size_t cols = 53;
+	Array2D original{rows, cols};
+	for (size_t i = 0; i != rows * cols; ++i) original[i] = i;
+
+	const Array2D converted = original.toLayout(Layout::ColumnMajor);
+	const Array2D back = converted.toLayout(Layout::RowMajor);
+
+	bool all_match{true};
+	for (size_t row = 0; row != rows; ++row)
+	{
+		for (size_t col = 0; col != cols; ++col)
+		{
+			all_match = all_match
+				and converted(row, col) == original(row, col)
+				and converted[col * rows + row] == original(row, col)
+				and back[row * cols + col] == original(row, col);
+		}
+	}
+	BOOST_CHECK_MESSAGE(all_match and converted.layout() == Layout::ColumnMajor
+		and back.layout() == Layout::RowMajor, "testLayoutConversion failed!");
+
+	const Array2D empty = Array2D(0, 4).toLayout(Layout::ColumnMajor);
+	BOOST_CHECK_MESSAGE(empty.data() == nullptr and empty.size().second == 4,
+		"testLayoutConversion failed!");
+}
+
+BOOST_AUTO_TEST_CASE(testMoveAndReshape)
+{
+	BOOST_TEST_MESSAGE("testMoveAndReshape");
+
+	Array2D original{2, 3, Layout::ColumnMajor};
+	original(1, 1) = 4.0;
+	const double* storage = original.data();
+
+	Array2D moved{std::move(original)};
+	BOOST_CHECK_MESSAGE(moved.data() == storage and original.data() == nullptr
+		and moved.layout() == Layout::ColumnMajor, "testMoveAndReshape failed!");
+
+	moved.reshape(3, 2);
+	BOOST_CHECK_MESSAGE(moved[3] == 4.0 and moved.size().first == 3,
+		"testMoveAndReshape failed!");
+	BOOST_CHECK_THROW(moved.reshape(4, 2), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(testLargeAllocation)
+{
+	BOOST_TEST_MESSAGE("testLargeAllocation");
+
+	// Just past the threshold, with a row length that doesn't divide a page.
+	const size_t cols = 1000;
+	const size_t rows = Array2D::large_allocation / sizeof(double) / cols + 1;
+	for (size_t num_threads : {1, 3})
+	{
+		parallel::setNumThreads(num_threads);
+		for (Layout layout : {Layout::RowMajor, Layout::ColumnMajor})
+		{
+			Array2D large{rows, cols, layout};
+			bool all_zero = true;
+			for (size_t i = 0; i != rows * cols; ++i)
+			{
+				all_zero = all_zero and large[i] == 0.0;
+			}
+			BOOST_CHECK_MESSAGE(all_zero and reinterpret_cast<std::uintptr_t>(
+				large.data()) % Array2D::alignment == 0,
+				"testLargeAllocation failed!");
+
+			large(rows - 1, cols - 1) = 3.0;
+			large(0, 0) = 2.0;
+			const Array2D copy{large};
+			const Array2D converted = large.toLayout(Layout::ColumnMajor);
+			Array2D moved{std::move(large)};
+			moved(0, 0) = 1.0;
+			BOOST_CHECK_MESSAGE(copy(0, 0) == 2.0
+				and copy(rows - 1, cols - 1) == 3.0 and copy(rows / 2, 7) == 0.0
+				and converted(0, 0) == 2.0
+				and converted(rows - 1, cols - 1) == 3.0
+				and moved(rows - 1, cols - 1) == 3.0,
+				"testLargeAllocation failed!");
+		}
+	}
+	parallel::setNumThreads(0);
+
+	// Uninitialized storage has the right shape, and is fully writable.
+	for (size_t cols : {size_t{3}, cols})
+	{
+		Array2D array = Array2D::uninitialized(rows, cols, Layout::ColumnMajor);
+		for (size_t i = 0; i != rows * cols; ++i) array[i] = 1.0;
+		BOOST_CHECK_MESSAGE(array.size() == std::make_pair(rows, cols)
+			and array.layout() == Layout::ColumnMajor
+			and array(rows - 1, cols - 1) == 1.0,
+			"testLargeAllocation failed!");
+	}
+	BOOST_CHECK_MESSAGE(Array2D::uninitialized(0, 5).data() == nullptr,
+		"testLargeAllocation failed!");
+}
@@ -0,0 +1,196 @@
+#define BOOST_TEST_MODULE BackendPublicTest
+#include <boost/test/unit_test.hpp>
+
+#include "bin/Helpers.hpp"
+#include "src/Backend.hpp"
+#include "src/Matrix.hpp"
+#include "tests/TestHelpers.hpp"
+
+#ifdef MLE_HAVE_EIGEN
+#include "src/EigenInterop.hpp"
+#endif
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+
+/**
+ * @brief Return a well-conditioned, diagonally-dominant test matrix.
+ */
+Matrix wellConditioned(size_t rows, size_t cols, double seed)
+{
+	Matrix mat = testMatrix(rows, cols, seed);
+	for (size_t i = 1; i <= std::min(rows, cols); ++i) mat(i, i) += rows;
+	return mat;
+}
+
+/**
+ * @brief Evaluate `op` once on the native kernels and once on the backend.
+ */
+template <typename Op>
+void compareWithBackend(Op op, Matrix& native, Matrix& routed)
+{
+	const size_t old_threshold = backend::dispatchThreshold();
+
+	backend::setDispatchThreshold(static_cast<size_t>(-1));
+	native = op();
+	backend::setDispatchThreshold(0);
+	routed = op();
+
+	backend::setDispatchThreshold(old_threshold);
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(testBackendMatchesNativeKernels)
+{
+	BOOST_TEST_MESSAGE("testBackendMatchesNativeKernels");
+	BOOST_TEST_MESSAGE("backend: " << backend::name());
+
+	const Matrix a = wellConditioned(13, 13, 1.0);
+	const Matrix b = wellConditioned(13, 5, 2.0);
+	Matrix native;
+	Matrix routed;
+
+	compareWithBackend([&]{ return a * b; }, native, routed);
+	BOOST_CHECK_MESSAGE(isApproxEqual(native, routed, 1e-10),
+		"testBackendMatchesNativeKernels failed!");
+
+	compareWithBackend([&]{ return a.inverse(); }, native, routed);
+	BOOST_CHECK_MESSAGE(isApproxEqual(native, routed, 1e-10),
+		"testBackendMatchesNativeKernels failed!");
+
+	compareWithBackend([&]{ return a.solve(b); }, native, routed);
+	BOOST_CHECK_MESSAGE(isApproxEqual(native, routed, 1e-10),
+		"testBackendMatchesNativeKernels failed!");
+}
+
+BOOST_AUTO_TEST_CASE(testBackendDetectsSingularity)
+{
+	BOOST_TEST_MESSAGE("testBackendDetectsSingularity");
+
+	Matrix singular{3, 3};
+	singular(1, 1) = 1;
+	singular(2, 2) = 1;
+
+	const size_t old_threshold = backend::dispatchThreshold();
+	backend::setDispatchThreshold(0);
+	BOOST_CHECK_THROW(singular.inverse(), std::runtime_error);
+	BOOST_CHECK_THROW(singular.solve(Matrix{3, 1}), std::runtime_error);
+	backend::setDispatchThreshold(old_threshold);
+}
+
+BOOST_AUTO_TEST_CASE(testBackendEmptyInnerDimension)
+{
+	BOOST_TEST_MESSAGE("testBackendEmptyInnerDimension");
+
+	if (not backend::available()) return;
+
+	// An empty sum is zero, whatever `out` held before.
+	const Array2D lhs{100, 0};
+	const Array2D rhs{0, 100};
+	Array2D out{100, 100};
+	std::fill(out.data(), out.data() + 100 * 100, 1.0);
+	backend::multiply(lhs, rhs, out);
+	BOOST_CHECK_MESSAGE(std::all_of(out.data(), out.data() + 100 * 100,
+		[](double value) { return value == 0.0; }),
+		"testBackendEmptyInnerDimension failed!");
+
+	const size_t old_threshold = backend::dispatchThreshold();
+	backend::setDispatchThreshold(0);
+	BOOST_CHECK_MESSAGE(Matrix(100, 0) * Matrix(0, 100) == Matrix(100, 100),
+		"testBackendEmptyInnerDimension failed!");
+	backend::setDispatchThreshold(old_threshold);
+}
+
+BOOST_AUTO_TEST_CASE(testDispatchThreshold)
+{
+	BOOST_TEST_MESSAGE("testDispatchThreshold");
+
+	const size_t old_threshold = backend::dispatchThreshold();
+	backend::setDispatchThreshold(10);
+
+	BOOST_CHECK_MESSAGE(not backend::shouldDispatch(9),
+		"testDispatchThreshold failed!");
+	BOOST_CHECK_MESSAGE(backend::shouldDispatch(10) == backend::available(),
+		"testDispatchThreshold failed!");
+
+	backend::setDispatchThreshold(old_threshold);
+}
+
+BOOST_AUTO_TEST_CASE(testSingleThreadedBackend)
+{
+	BOOST_TEST_MESSAGE("testSingleThreadedBackend");
+
+	const bool limited = backend::setNumThreads(1);
+	BOOST_TEST_MESSAGE("thread control: " << (limited ? "yes" : "no"));
+	BOOST_CHECK_MESSAGE(limited or std::string{backend::name()} != "eigen",
+		"testSingleThreadedBackend failed!");
+
+	// Big enough that a threaded BLAS would split it up.
+	const Matrix a = wellConditioned(300, 300, 3.0);
+	const Matrix b = wellConditioned(300, 40, 4.0);
+	Matrix native;
+	Matrix routed;
+	compareWithBackend([&]{ return a.solve(b); }, native, routed);
+	BOOST_CHECK_MESSAGE(isApproxEqual(native, routed, 1e-10),
+		"testSingleThreadedBackend failed!");
+}
+
+#ifdef MLE_HAVE_EIGEN
+BOOST_AUTO_TEST_CASE(testEigenMapsAliasStorage)
+{
+	BOOST_TEST_MESSAGE("testEigenMapsAliasStorage");
+
+	Matrix mat = testMatrix(3, 4, 5.0);
+	EigenMap view = asEigen(mat);
+	view(2, 3) = 42.0;
+
+	const Matrix& const_mat = mat;
+	BOOST_CHECK_MESSAGE(view.data() == mat.data(),
+		"testEigenMapsAliasStorage failed!");
+	BOOST_CHECK_MESSAGE(mat(3, 4) == 42.0 and asEigen(const_mat)(2, 3) == 42.0,
+		"testEigenMapsAliasStorage failed!");
+
+	Array2D array{2, 2};
+	asEigen(array).setIdentity();
+	BOOST_CHECK_MESSAGE(array(0, 0) == 1.0 and array(0, 1) == 0.0,
+		"testEigenMapsAliasStorage failed!");
+}
+
+BOOST_AUTO_TEST_CASE(testToMatrix)
+{
+	BOOST_TEST_MESSAGE("testToMatrix");
+
+	const Matrix a = testMatrix(4, 3, 6.0);
+	const Matrix b = testMatrix(3, 2, 7.0);
+
+	BOOST_CHECK_MESSAGE(
+		isApproxEqual(toMatrix(asEigen(a) * asEigen(b)), a * b, 1e-12),
+		"testToMatrix failed!");
+
+	const Matrix col_major = toMatrix(asEigen(a) * asEigen(b),
+									  Layout::ColumnMajor);
+	BOOST_CHECK_MESSAGE(col_major.layout() == Layout::ColumnMajor
+		and isApproxEqual(col_major, a * b, 1e-12), "testToMatrix failed!");
+}
+
+BOOST_AUTO_TEST_CASE(testColumnMajorEigenMaps)
+{
+	BOOST_TEST_MESSAGE("testColumnMajorEigenMaps");
+
+	Matrix mat = testMatrix(3, 4, 8.0).toLayout(Layout::ColumnMajor);
+	ColumnMajorEigenMap view = asEigenColumnMajor(mat);
+	view(2, 3) = 42.0;
+
+	const Matrix& const_mat = mat;
+	BOOST_CHECK_MESSAGE(view.data() == mat.data() and mat(3, 4) == 42.0
+		and asEigenColumnMajor(const_mat)(2, 3) == 42.0,
+		"testColumnMajorEigenMaps failed!");
+	BOOST_CHECK_THROW(asEigen(mat), std::runtime_error);
+	BOOST_CHECK_THROW(asEigenColumnMajor(testMatrix(2, 2, 9.0)), std::runtime_error);
+}
+#endif
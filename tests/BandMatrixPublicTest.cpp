@@ -0,0 +1,218 @@
+#define BOOST_TEST_MODULE BandMatrixPublicTest
+#include <boost/test/unit_test.hpp>
+
+#include "src/Array2D.hpp"
+#include "src/BandMatrix.hpp"
+#include "src/Matrix.hpp"
+#include "src/Parallel.hpp"
+#include "src/Reductions.hpp"
+#include "tests/TestHelpers.hpp"
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+
+/**
+ * @brief Return a dense `n x n` Matrix with the given bandwidths.
+ * @detail When there are bands on both sides, the diagonal is deliberately
+ * 		small, so that solving it needs pivoting.
+ */
+Matrix banded(size_t n, size_t lower, size_t upper, double seed)
+{
+	Matrix mat = testMatrix(n, n, seed);
+	for (size_t row = 1; row <= n; ++row)
+	{
+		for (size_t col = 1; col <= n; ++col)
+		{
+			if (row > col + lower or col > row + upper) mat(row, col) = 0.0;
+		}
+		const bool needs_pivoting = lower > 0 and upper > 0;
+		mat(row, row) = needs_pivoting ? 0.01 * mat(row, row)
+									   : 2.0 + mat(row, row);
+	}
+	return mat;
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(testConversionDetectsBandwidth)
+{
+	BOOST_TEST_MESSAGE("testConversionDetectsBandwidth");
+
+	const Matrix dense = banded(12, 2, 3, 1.0);
+	const BandMatrix band = BandMatrix::fromDense(dense);
+
+	BOOST_CHECK_MESSAGE(band.lowerBandwidth() == 2
+		and band.upperBandwidth() == 3, "testConversionDetectsBandwidth failed!");
+	BOOST_CHECK_MESSAGE(band.toDense() == dense,
+		"testConversionDetectsBandwidth failed!");
+	BOOST_CHECK_MESSAGE(band(1, 4) == dense(1, 4) and band(1, 5) == 0.0,
+		"testConversionDetectsBandwidth failed!");
+
+	// Tiny elements are dropped when a tolerance is given.
+	Matrix noisy{dense};
+	noisy(12, 1) = 1e-15;
+	BOOST_CHECK_MESSAGE(BandMatrix::fromDense(noisy).lowerBandwidth() == 11,
+		"testConversionDetectsBandwidth failed!");
+	BOOST_CHECK_MESSAGE(BandMatrix::fromDense(noisy, 1e-12).lowerBandwidth() == 2,
+		"testConversionDetectsBandwidth failed!");
+}
+
+BOOST_AUTO_TEST_CASE(testAccess)
+{
+	BOOST_TEST_MESSAGE("testAccess");
+
+	BandMatrix band{4, 1, 0};
+	band(2, 1) = 3.0;
+	band(2, 2) = 4.0;
+	const BandMatrix& view = band;
+
+	BOOST_CHECK_MESSAGE(view(2, 1) == 3.0 and view(2, 2) == 4.0
+		and view(1, 2) == 0.0, "testAccess failed!");
+	BOOST_CHECK_THROW(band(1, 2) = 1.0, std::runtime_error);
+	BOOST_CHECK_THROW(band(0, 1), std::runtime_error);
+	BOOST_CHECK_THROW(band(5, 5), std::runtime_error);
+	BOOST_CHECK_THROW(BandMatrix::fromDense(Matrix(2, 3)), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(testMultiply)
+{
+	BOOST_TEST_MESSAGE("testMultiply");
+
+	for (size_t threads : {1, 3})
+	{
+		parallel::setNumThreads(threads);
+		for (size_t n : {1, 7, 600})
+		{
+			const Matrix dense = banded(n, 2, 1, 2.0);
+			const BandMatrix band = BandMatrix::fromDense(dense);
+			for (size_t cols : {1, 5})
+			{
+				const Matrix rhs = testMatrix(n, cols, 3.0);
+				BOOST_CHECK_MESSAGE(reductions::isApprox(band * rhs,
+					dense * rhs, 1e-12), "testMultiply failed!");
+			}
+		}
+	}
+	parallel::setNumThreads(0);
+
+	BOOST_CHECK_THROW(BandMatrix(3, 1, 1) * Matrix(2, 2), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(testBandSolve)
+{
+	BOOST_TEST_MESSAGE("testBandSolve");
+
+	for (size_t lower : {0, 1, 3})
+	{
+		for (size_t upper : {0, 2})
+		{
+			for (size_t n : {1, 9, 200})
+			{
+				const Matrix dense = banded(n, lower, upper, 4.0);
+				const BandMatrix band = BandMatrix::fromDense(dense);
+				const Matrix rhs = testMatrix(n, 3, 5.0);
+
+				// Some of these are badly conditioned, so check the backward
+				// error, which pivoting keeps small regardless.
+				const Matrix x = band.solve(rhs);
+				const double residual = reductions::infNorm(dense * x - rhs);
+				BOOST_CHECK_MESSAGE(residual <= 1e-13 * reductions::infNorm(dense)
+					* reductions::infNorm(x), "testBandSolve failed!");
+			}
+		}
+	}
+
+	BandMatrix singular{3, 1, 1};
+	singular(1, 1) = singular(2, 2) = 1.0;
+	BOOST_CHECK_THROW(singular.solve(Matrix(3, 1)), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(testTridiagonalSolve)
+{
+	BOOST_TEST_MESSAGE("testTridiagonalSolve");
+
+	// The second-difference operator from a discretized ODE.
+	const size_t n = 50;
+	const std::vector<double> lower(n, -1.0);
+	const std::vector<double> diag(n, 2.5);
+	const std::vector<double> upper(n, -1.0);
+
+	BandMatrix band{n, 1, 1};
+	for (size_t i = 1; i <= n; ++i)
+	{
+		band(i, i) = 2.5;
+		if (i > 1) band(i, i - 1) = -1.0;
+		if (i < n) band(i, i + 1) = -1.0;
+	}
+
+	const Matrix rhs = testMatrix(n, 4, 6.0);
+	const Matrix x = tridiagonal::solve(lower, diag, upper, rhs);
+	BOOST_CHECK_MESSAGE(reductions::isApprox(band * x, rhs, 1e-12),
+		"testTridiagonalSolve failed!");
+
+	const std::vector<double> zero_pivot(n, 0.0);
+	BOOST_CHECK_THROW(tridiagonal::solve(lower, zero_pivot, upper, rhs),
+		std::runtime_error);
+	BOOST_CHECK_THROW(tridiagonal::solve(lower, diag, upper, Matrix(3, 1)),
+		std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(testTridiagonalBatch)
+{
+	BOOST_TEST_MESSAGE("testTridiagonalBatch");
+
+	const size_t n = 20;
+	const size_t count = 70;
+	Array2D lower{n, count};
+	Array2D diag{n, count};
+	Array2D upper{n, count};
+	Array2D rhs{n, count};
+	for (size_t i = 0; i != n; ++i)
+	{
+		for (size_t s = 0; s != count; ++s)
+		{
+			lower(i, s) = std::sin(0.1 * i + s);
+			upper(i, s) = std::cos(0.2 * i + s);
+			diag(i, s) = 3.0 + std::sin(0.3 * i * s);
+			rhs(i, s) = std::sin(0.7 * i - s);
+		}
+	}
+
+	for (size_t threads : {1, 3})
+	{
+		parallel::setNumThreads(threads);
+		Array2D x{rhs};
+		tridiagonal::solveBatch(lower, diag, upper, x);
+
+		// Check every system against the single-system solver.
+		bool all_match = true;
+		for (size_t s = 0; s != count; ++s)
+		{
+			std::vector<double> a(n), b(n), c(n);
+			Matrix d{n, 1};
+			for (size_t i = 0; i != n; ++i)
+			{
+				a[i] = lower(i, s);
+				b[i] = diag(i, s);
+				c[i] = upper(i, s);
+				d(i + 1, 1) = rhs(i, s);
+			}
+			const Matrix expected = tridiagonal::solve(a, b, c, d);
+			for (size_t i = 0; i != n; ++i)
+			{
+				all_match = all_match
+					and std::abs(x(i, s) - expected(i + 1, 1)) < 1e-12;
+			}
+		}
+		BOOST_CHECK_MESSAGE(all_match, "testTridiagonalBatch failed!");
+	}
+	parallel::setNumThreads(0);
+
+	Array2D wrong{n, count + 1};
+	BOOST_CHECK_THROW(tridiagonal::solveBatch(lower, diag, upper, wrong),
+		std::runtime_error);
+}
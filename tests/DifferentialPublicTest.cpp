@@ -0,0 +1,701 @@
+#define BOOST_TEST_MODULE DifferentialPublicTest
+#include <boost/test/unit_test.hpp>
+
+#include "src/Backend.hpp"
+#include "src/Kernels.hpp"
+#include "src/Matrix.hpp"
+#include "src/Parallel.hpp"
+#include "src/QR.hpp"
+#include "src/Reductions.hpp"
+
+#ifdef MLE_HAVE_EIGEN
+#include "src/EigenInterop.hpp"
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using kernels::Isa;
+using reductions::isApprox;
+using reductions::Tolerance;
+using std::vector;
+
+namespace
+{
+
+const Isa all_isas[] = {Isa::Sse2, Isa::Avx2, Isa::Avx512};
+
+constexpr double epsilon = std::numeric_limits<double>::epsilon();
+
+/**
+ * @brief Written around every strided view, so that a kernel that writes
+ * 		(or reads) past the edge of its view gets caught.
+ */
+constexpr double sentinel = -7.0e300;
+
+/**
+ * @brief Sizes just around the kernels' register and cache block sizes,
+ * 		where the remainder loops are.
+ */
+const size_t tail_sizes[] = {1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 32, 33,
+							 63, 64, 65, 127, 128, 129, 255, 256, 257};
+
+/**
+ * @brief The random cases that one test case checks.
+ * @detail By default, every run checks the same `num_cases` cases. Set
+ * 		`MLE_SEED` to check a different set, or `MLE_SOAK_SECONDS` to keep
+ * 		drawing new cases for that many seconds (per test case) instead.
+ *
+ * 		Each case gets its own generator, seeded from the seed and the case
+ * 		number, and `where()` names both so that a failure found by a long
+ * 		soak can be replayed on its own.
+ */
+class Cases
+{
+public:
+
+	explicit Cases(size_t num_cases)
+		: num_cases{num_cases}, seed{environment("MLE_SEED", 20240601)},
+		  deadline{std::chrono::steady_clock::now()
+			+ std::chrono::seconds{environment("MLE_SOAK_SECONDS", 0)}},
+		  soak{environment("MLE_SOAK_SECONDS", 0) != 0}
+	{
+	}
+
+	/**
+	 * @brief Move on to the next case; return false once there are none.
+	 */
+	bool next()
+	{
+		const bool more = soak ? std::chrono::steady_clock::now() < deadline
+							   : case_number < num_cases;
+		if (not more) return false;
+
+		std::seed_seq sequence{static_cast<uint32_t>(seed),
+							   static_cast<uint32_t>(seed >> 32),
+							   static_cast<uint32_t>(case_number)};
+		generator.seed(sequence);
+		++case_number;
+		return true;
+	}
+
+	std::mt19937_64& rng()
+	{
+		return generator;
+	}
+
+	/**
+	 * @brief Describe the current case, for failure messages.
+	 */
+	std::string where() const
+	{
+		std::ostringstream description;
+		description << "MLE_SEED=" << seed << ", case " << case_number - 1;
+		return description.str();
+	}
+
+private:
+
+	static uint64_t environment(const char* name, uint64_t fallback)
+	{
+		const char* value = std::getenv(name);
+		return value ? std::strtoull(value, nullptr, 10) : fallback;
+	}
+
+	const size_t num_cases;
+	const uint64_t seed;
+	const std::chrono::steady_clock::time_point deadline;
+	const bool soak;
+	size_t case_number{0};
+	std::mt19937_64 generator;
+};
+
+size_t uniform(std::mt19937_64& rng, size_t lowest, size_t highest)
+{
+	return std::uniform_int_distribution<size_t>{lowest, highest}(rng);
+}
+
+/**
+ * @brief Return a dimension from one to `largest`, half the time one of the
+ * 		`tail_sizes`.
+ */
+size_t randomDim(std::mt19937_64& rng, size_t largest)
+{
+	if (uniform(rng, 0, 1) == 0)
+	{
+		const size_t* end = std::upper_bound(std::begin(tail_sizes),
+											 std::end(tail_sizes), largest);
+		const size_t count = end - std::begin(tail_sizes);
+		if (count != 0) return tail_sizes[uniform(rng, 0, count - 1)];
+	}
+	return uniform(rng, 1, largest);
+}
+
+/**
+ * @brief Return a random value in `(-1, 1)`, or, if `wide`, one scaled by
+ * 		up to `2^30` either way, so that sums of them cancel badly.
+ */
+double randomValue(std::mt19937_64& rng, bool wide)
+{
+	const double value = std::uniform_real_distribution<double>{-1.0, 1.0}(rng);
+	if (not wide) return value;
+	return std::ldexp(value,
+		static_cast<int>(uniform(rng, 0, 60)) - 30);
+}
+
+/**
+ * @brief A `rows x cols` row-major view with a random leading dimension,
+ * 		starting at a random (often misaligned) offset into storage that is
+ * 		otherwise filled with the `sentinel`.
+ */
+struct View
+{
+	View(size_t rows, size_t cols, std::mt19937_64& rng, bool wide)
+		: rows{rows}, cols{cols}, ld{cols + uniform(rng, 0, 9)},
+		  offset{uniform(rng, 0, 7)},
+		  storage(offset + rows * ld + uniform(rng, 0, 9), sentinel)
+	{
+		for (size_t row = 0; row != rows; ++row)
+		{
+			for (size_t col = 0; col != cols; ++col)
+			{
+				at(row, col) = randomValue(rng, wide);
+			}
+		}
+	}
+
+	double* data()
+	{
+		return storage.data() + offset;
+	}
+
+	double& at(size_t row, size_t col)
+	{
+		return storage[offset + row * ld + col];
+	}
+
+	double at(size_t row, size_t col) const
+	{
+		return storage[offset + row * ld + col];
+	}
+
+	/**
+	 * @brief Return true if nothing outside of the view has changed.
+	 */
+	bool paddingIntact() const
+	{
+		for (size_t i = 0; i != storage.size(); ++i)
+		{
+			const bool inside = i >= offset and i < offset + rows * ld
+				and (i - offset) % ld < cols;
+			if (not inside and storage[i] != sentinel) return false;
+		}
+		return true;
+	}
+
+	const size_t rows;
+	const size_t cols;
+	const size_t ld;
+	const size_t offset;
+	vector<double> storage;
+};
+
+/**
+ * @brief Return true if `actual` is within `ulps` units of roundoff of
+ * 		`expected`, relative to `scale`.
+ * @detail For a sum of `k` terms, floating-point error is bounded by about
+ * 		`k * epsilon` times the sum of the terms' magnitudes (not the
+ * 		magnitude of the result, which cancellation can make arbitrarily
+ * 		small), so that sum is the right `scale`.
+ */
+bool withinRoundoff(double actual, long double expected, long double scale,
+					double ulps)
+{
+	return std::abs(actual - expected)
+		<= ulps * epsilon * scale + std::numeric_limits<double>::min();
+}
+
+/**
+ * @brief Run `check` once for every instruction set that this machine
+ * 		supports, with that instruction set's kernels active.
+ */
+template <typename Check>
+void forEachSupportedIsa(Check check)
+{
+	for (Isa isa : all_isas)
+	{
+		if (not kernels::isSupported(isa)) continue;
+		kernels::forceIsa(isa);
+		check(kernels::isaName(isa));
+	}
+	kernels::resetIsa();
+}
+
+Matrix randomMatrix(size_t rows, size_t cols, std::mt19937_64& rng, bool wide)
+{
+	Matrix mat{rows, cols,
+			   uniform(rng, 0, 1) == 0 ? Layout::RowMajor : Layout::ColumnMajor};
+	for (size_t row = 1; row <= rows; ++row)
+	{
+		for (size_t col = 1; col <= cols; ++col)
+		{
+			mat(row, col) = randomValue(rng, wide);
+		}
+	}
+	return mat;
+}
+
+/**
+ * @brief Return `a * b` computed one element at a time in extended
+ * 		precision, and, in `scale`, the sums of the magnitudes of the terms
+ * 		behind each element.
+ */
+vector<long double> naiveProduct(const Matrix& a, const Matrix& b,
+								 vector<long double>& scale)
+{
+	const size_t m = a.size().first;
+	const size_t k = a.size().second;
+	const size_t n = b.size().second;
+	vector<long double> product(m * n);
+	scale.assign(m * n, 0.0L);
+	for (size_t row = 1; row <= m; ++row)
+	{
+		for (size_t col = 1; col <= n; ++col)
+		{
+			long double sum = 0.0L;
+			long double magnitude = 0.0L;
+			for (size_t i = 1; i <= k; ++i)
+			{
+				const long double term =
+					static_cast<long double>(a(row, i)) * b(i, col);
+				sum += term;
+				magnitude += std::abs(term);
+			}
+			product[(row - 1) * n + col - 1] = sum;
+			scale[(row - 1) * n + col - 1] = magnitude;
+		}
+	}
+	return product;
+}
+
+/**
+ * @brief Return true if `product` matches `naiveProduct(a, b)` to within
+ * 		roundoff for a length-`k` dot product in every element.
+ */
+bool matchesNaiveProduct(const Matrix& product, const Matrix& a,
+						 const Matrix& b)
+{
+	const size_t n = b.size().second;
+	if (product.size() != std::make_pair(a.size().first, n)) return false;
+
+	vector<long double> scale;
+	const vector<long double> expected = naiveProduct(a, b, scale);
+	const double ulps = 2.0 * a.size().second + 2.0;
+	for (size_t row = 1; row <= product.size().first; ++row)
+	{
+		for (size_t col = 1; col <= n; ++col)
+		{
+			const size_t i = (row - 1) * n + col - 1;
+			if (not withinRoundoff(product(row, col), expected[i], scale[i],
+								   ulps))
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Return the largest row sum of magnitudes of `mat` (its infinity
+ * 		norm).
+ */
+double normInf(const Matrix& mat)
+{
+	double largest = 0.0;
+	for (size_t row = 1; row <= mat.size().first; ++row)
+	{
+		double sum = 0.0;
+		for (size_t col = 1; col <= mat.size().second; ++col)
+		{
+			sum += std::abs(mat(row, col));
+		}
+		largest = std::max(largest, sum);
+	}
+	return largest;
+}
+
+/**
+ * @brief Return `b - a * x`, computed in extended precision.
+ */
+Matrix residual(const Matrix& a, const Matrix& x, const Matrix& b)
+{
+	Matrix r{b.size().first, b.size().second};
+	for (size_t row = 1; row <= b.size().first; ++row)
+	{
+		for (size_t col = 1; col <= b.size().second; ++col)
+		{
+			long double sum = b(row, col);
+			for (size_t i = 1; i <= a.size().second; ++i)
+			{
+				sum -= static_cast<long double>(a(row, i)) * x(i, col);
+			}
+			r(row, col) = static_cast<double>(sum);
+		}
+	}
+	return r;
+}
+
+/**
+ * @brief Return an `n x n` matrix with singular values spread evenly (in
+ * 		the exponent) from one down to `10^-digits`, with its rows then
+ * 		scaled by up to `2^10` either way.
+ */
+Matrix illConditioned(size_t n, double digits, std::mt19937_64& rng)
+{
+	const Matrix u = QR{randomMatrix(n, n, rng, false)}.q();
+	const Matrix v = QR{randomMatrix(n, n, rng, false)}.q();
+
+	Matrix sigma_vt = v.transpose();
+	for (size_t row = 1; row <= n; ++row)
+	{
+		const double sigma = n == 1 ? 1.0
+			: std::pow(10.0, -digits * (row - 1) / (n - 1));
+		for (size_t col = 1; col <= n; ++col) sigma_vt(row, col) *= sigma;
+	}
+
+	Matrix a = u * sigma_vt;
+	for (size_t row = 1; row <= n; ++row)
+	{
+		const double row_scale = std::ldexp(1.0,
+			static_cast<int>(uniform(rng, 0, 20)) - 10);
+		for (size_t col = 1; col <= n; ++col) a(row, col) *= row_scale;
+	}
+	return a;
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(testKernelsAgainstReference)
+{
+	BOOST_TEST_MESSAGE("testKernelsAgainstReference");
+
+	forEachSupportedIsa([](const char* isa) {
+		const kernels::KernelTable& kernel = kernels::active();
+		Cases cases{20};
+		while (cases.next())
+		{
+			std::mt19937_64& rng = cases.rng();
+			const bool wide = uniform(rng, 0, 1) == 0;
+			const std::string where = std::string{isa} + ", " + cases.where();
+
+			// Element-wise kernels round once per element, just like the
+			// scalar code, so they have to match it exactly. Views start at
+			// random offsets, so the vector loops start misaligned.
+			const size_t n = randomDim(rng, 1000);
+			View a{1, n, rng, wide};
+			View b{1, n, rng, wide};
+			View out{1, n, rng, wide};
+			const double alpha = randomValue(rng, wide);
+			bool exact = true;
+
+			kernel.add(n, a.data(), b.data(), out.data());
+			for (size_t i = 0; i != n; ++i)
+			{
+				exact = exact and out.at(0, i) == a.at(0, i) + b.at(0, i);
+			}
+			kernel.subtract(n, a.data(), b.data(), out.data());
+			for (size_t i = 0; i != n; ++i)
+			{
+				exact = exact and out.at(0, i) == a.at(0, i) - b.at(0, i);
+			}
+			kernel.multiply(n, a.data(), b.data(), out.data());
+			for (size_t i = 0; i != n; ++i)
+			{
+				exact = exact and out.at(0, i) == a.at(0, i) * b.at(0, i);
+			}
+			kernel.divide(n, a.data(), b.data(), out.data());
+			for (size_t i = 0; i != n; ++i)
+			{
+				exact = exact and out.at(0, i) == a.at(0, i) / b.at(0, i);
+			}
+			kernel.scale(n, alpha, a.data(), out.data());
+			for (size_t i = 0; i != n; ++i)
+			{
+				exact = exact and out.at(0, i) == alpha * a.at(0, i);
+			}
+
+			double min = 0.0;
+			double max = 0.0;
+			kernel.minMax(n, a.data(), &min, &max);
+			const double* a_first = a.data();
+			exact = exact and min == *std::min_element(a_first, a_first + n)
+				and max == *std::max_element(a_first, a_first + n);
+			BOOST_CHECK_MESSAGE(exact and out.paddingIntact(),
+				"element-wise kernels failed! (" << where << ")");
+
+			// `axpy` may fuse its multiply and add, which rounds once instead
+			// of twice.
+			const vector<double> y(out.storage);
+			kernel.axpy(n, alpha, a.data(), out.data());
+			bool close = true;
+			for (size_t i = 0; i != n; ++i)
+			{
+				const double before = y[out.offset + i];
+				close = close and withinRoundoff(out.at(0, i),
+					before + static_cast<long double>(alpha) * a.at(0, i),
+					std::abs(before) + std::abs(alpha * a.at(0, i)), 1.0);
+			}
+			BOOST_CHECK_MESSAGE(close and out.paddingIntact(),
+				"axpy failed! (" << where << ")");
+
+			// Reductions can add their terms in any order.
+			long double dot = 0.0L;
+			long double dot_scale = 0.0L;
+			long double sum = 0.0L;
+			long double sum_abs = 0.0L;
+			for (size_t i = 0; i != n; ++i)
+			{
+				const long double term =
+					static_cast<long double>(a.at(0, i)) * b.at(0, i);
+				dot += term;
+				dot_scale += std::abs(term);
+				sum += a.at(0, i);
+				sum_abs += std::abs(a.at(0, i));
+			}
+			BOOST_CHECK_MESSAGE(
+				withinRoundoff(kernel.dot(n, a.data(), b.data()), dot, dot_scale,
+							   n + 2.0)
+				and withinRoundoff(kernel.sum(n, a.data()), sum, sum_abs,
+								   n + 2.0)
+				and withinRoundoff(kernel.sumAbs(n, a.data()), sum_abs, sum_abs,
+								   n + 2.0),
+				"reduction kernels failed! (" << where << ")");
+
+			// Products, on random sub-blocks of larger arrays.
+			const size_t m = randomDim(rng, 150);
+			const size_t k = randomDim(rng, 300);
+			const size_t p = randomDim(rng, 300);
+			const View lhs{m, k, rng, wide};
+			const View rhs{k, p, rng, wide};
+			View product{m, p, rng, wide};
+			const View initial{product};
+			kernel.gemm(m, p, k, alpha, lhs.storage.data() + lhs.offset, lhs.ld,
+						rhs.storage.data() + rhs.offset, rhs.ld, product.data(),
+						product.ld);
+			close = true;
+			for (size_t row = 0; row != m; ++row)
+			{
+				for (size_t col = 0; col != p; ++col)
+				{
+					long double expected = 0.0L;
+					long double magnitude = 0.0L;
+					for (size_t i = 0; i != k; ++i)
+					{
+						const long double term =
+							static_cast<long double>(lhs.at(row, i)) * rhs.at(i, col);
+						expected += term;
+						magnitude += std::abs(term);
+					}
+					const double c = initial.at(row, col);
+					close = close and withinRoundoff(product.at(row, col),
+						c + alpha * expected,
+						std::abs(c) + std::abs(alpha) * magnitude, 2.0 * k + 2.0);
+				}
+			}
+			BOOST_CHECK_MESSAGE(close and product.paddingIntact(),
+				"gemm failed! (" << where << ", " << m << "x" << k << " * "
+				<< k << "x" << p << ")");
+
+			View y_rows{1, m, rng, wide};
+			View y_cols{1, k, rng, wide};
+			const View y_rows_initial{y_rows};
+			const View y_cols_initial{y_cols};
+			const View x_cols{1, k, rng, wide};
+			const View x_rows{1, m, rng, wide};
+			kernel.gemv(m, k, alpha, lhs.storage.data() + lhs.offset, lhs.ld,
+						x_cols.storage.data() + x_cols.offset, y_rows.data());
+			kernel.gemvTransposed(m, k, alpha, lhs.storage.data() + lhs.offset,
+								  lhs.ld, x_rows.storage.data() + x_rows.offset,
+								  y_cols.data());
+			close = true;
+			for (size_t row = 0; row != m; ++row)
+			{
+				long double expected = 0.0L;
+				long double magnitude = 0.0L;
+				for (size_t col = 0; col != k; ++col)
+				{
+					const long double term =
+						static_cast<long double>(lhs.at(row, col)) * x_cols.at(0, col);
+					expected += term;
+					magnitude += std::abs(term);
+				}
+				const double before = y_rows_initial.at(0, row);
+				close = close and withinRoundoff(y_rows.at(0, row),
+					before + alpha * expected,
+					std::abs(before) + std::abs(alpha) * magnitude, 2.0 * k + 2.0);
+			}
+			for (size_t col = 0; col != k; ++col)
+			{
+				long double expected = 0.0L;
+				long double magnitude = 0.0L;
+				for (size_t row = 0; row != m; ++row)
+				{
+					const long double term =
+						static_cast<long double>(lhs.at(row, col)) * x_rows.at(0, row);
+					expected += term;
+					magnitude += std::abs(term);
+				}
+				const double before = y_cols_initial.at(0, col);
+				close = close and withinRoundoff(y_cols.at(0, col),
+					before + alpha * expected,
+					std::abs(before) + std::abs(alpha) * magnitude, 2.0 * m + 2.0);
+			}
+			BOOST_CHECK_MESSAGE(close and y_rows.paddingIntact()
+				and y_cols.paddingIntact(),
+				"gemv failed! (" << where << ", " << m << "x" << k << ")");
+
+			View transposed{p, m, rng, wide};
+			kernel.transpose(m, p, product.data(), product.ld, transposed.data(),
+							 transposed.ld);
+			exact = true;
+			for (size_t row = 0; row != m; ++row)
+			{
+				for (size_t col = 0; col != p; ++col)
+				{
+					exact = exact and transposed.at(col, row)
+						== product.at(row, col);
+				}
+			}
+			BOOST_CHECK_MESSAGE(exact and transposed.paddingIntact(),
+				"transpose failed! (" << where << ")");
+		}
+	});
+}
+
+BOOST_AUTO_TEST_CASE(testMatrixAgainstReference)
+{
+	BOOST_TEST_MESSAGE("testMatrixAgainstReference");
+
+	const size_t old_threshold = backend::dispatchThreshold();
+	Cases cases{30};
+	while (cases.next())
+	{
+		std::mt19937_64& rng = cases.rng();
+		const bool wide = uniform(rng, 0, 1) == 0;
+
+		// Every combination of layouts, thread counts, and (if there is
+		// one) the external backend should give the same answers.
+		parallel::setNumThreads(uniform(rng, 1, 4));
+		backend::setDispatchThreshold(uniform(rng, 0, 1) == 0 ? 0 : old_threshold);
+
+		const size_t m = randomDim(rng, 130);
+		const size_t k = randomDim(rng, 130);
+		const size_t n = randomDim(rng, 130);
+		const Matrix a = randomMatrix(m, k, rng, wide);
+		const Matrix b = randomMatrix(k, n, rng, wide);
+		const Matrix c = randomMatrix(m, k, rng, wide);
+
+		Matrix sum{m, k};
+		Matrix difference{m, k};
+		for (size_t row = 1; row <= m; ++row)
+		{
+			for (size_t col = 1; col <= k; ++col)
+			{
+				sum(row, col) = a(row, col) + c(row, col);
+				difference(row, col) = a(row, col) - c(row, col);
+			}
+		}
+		BOOST_CHECK_MESSAGE(isApprox(a + c, sum, 0.0, Tolerance::Ulp)
+			and isApprox(a - c, difference, 0.0, Tolerance::Ulp)
+			and isApprox(a.transpose().transpose(), a, 0.0, Tolerance::Ulp)
+			and isApprox(a.toLayout(Layout::ColumnMajor), a, 0.0, Tolerance::Ulp),
+			"element-wise operations failed! (" << cases.where() << ")");
+
+		// Division may multiply by the reciprocal instead, which rounds
+		// twice.
+		const double divisor = randomValue(rng, wide);
+		Matrix quotient{m, k};
+		for (size_t row = 1; row <= m; ++row)
+		{
+			for (size_t col = 1; col <= k; ++col)
+			{
+				quotient(row, col) = a(row, col) / divisor;
+			}
+		}
+		BOOST_CHECK_MESSAGE(isApprox(a / divisor, quotient, 2.0, Tolerance::Ulp),
+			"division failed! (" << cases.where() << ")");
+
+		const Matrix product = a * b;
+		BOOST_CHECK_MESSAGE(matchesNaiveProduct(product, a, b)
+			and product.layout() == a.layout(),
+			"multiplication failed! (" << cases.where() << ", " << m << "x" << k
+			<< " * " << k << "x" << n << ")");
+
+#ifdef MLE_HAVE_EIGEN
+		const Matrix eigen_product = toMatrix(
+			asEigen(a.toLayout(Layout::RowMajor))
+			* asEigen(b.toLayout(Layout::RowMajor)));
+		BOOST_CHECK_MESSAGE(matchesNaiveProduct(eigen_product, a, b)
+			and isApprox(product, eigen_product, 4.0 * k * epsilon
+				* normInf(a) * normInf(b.transpose()) + 1e-300),
+			"multiplication disagrees with Eigen! (" << cases.where() << ")");
+#endif
+	}
+	backend::setDispatchThreshold(old_threshold);
+	parallel::setNumThreads(0);
+}
+
+BOOST_AUTO_TEST_CASE(testIllConditionedSolves)
+{
+	BOOST_TEST_MESSAGE("testIllConditionedSolves");
+
+	// With condition numbers up to 1e12, the solutions themselves can be off
+	// by that much times roundoff, so check backward error: each `x` has to
+	// exactly solve a system within a few ulps of the one that was posed.
+	const size_t old_threshold = backend::dispatchThreshold();
+	Cases cases{10};
+	while (cases.next())
+	{
+		std::mt19937_64& rng = cases.rng();
+		backend::setDispatchThreshold(uniform(rng, 0, 1) == 0 ? 0 : old_threshold);
+
+		const size_t n = randomDim(rng, 80);
+		const double digits = std::uniform_real_distribution<double>{6, 12}(rng);
+		const Matrix a = illConditioned(n, digits, rng).toLayout(
+			uniform(rng, 0, 1) == 0 ? Layout::RowMajor : Layout::ColumnMajor);
+		const Matrix b = randomMatrix(n, uniform(rng, 1, 5), rng, false);
+		const double tolerance = 16.0 * n * epsilon;
+
+		const Matrix x = a.solve(b);
+		BOOST_CHECK_MESSAGE(normInf(residual(a, x, b))
+				<= tolerance * (normInf(a) * normInf(x) + normInf(b)),
+			"solve failed! (" << cases.where() << ", n = " << n << ")");
+
+		// Row scaling can push the condition number past what QR treats as
+		// full rank, and then it (rightly) solves a truncated problem.
+		const QR qr{a};
+		const Matrix qr_x = qr.leastSquares(b);
+		BOOST_CHECK_MESSAGE(qr.rank() < n or normInf(residual(a, qr_x, b))
+				<= tolerance * (normInf(a) * normInf(qr_x) + normInf(b)),
+			"QR::leastSquares failed! (" << cases.where() << ", n = " << n << ")");
+
+#ifdef MLE_HAVE_EIGEN
+		const Matrix a_rows = a.toLayout(Layout::RowMajor);
+		const Matrix eigen_x = toMatrix(asEigen(a_rows).partialPivLu().solve(
+			asEigen(b.toLayout(Layout::RowMajor))));
+		BOOST_CHECK_MESSAGE(normInf(residual(a, eigen_x, b))
+				<= tolerance * (normInf(a) * normInf(eigen_x) + normInf(b)),
+			"Eigen's solve failed! (" << cases.where() << ")");
+#endif
+	}
+	backend::setDispatchThreshold(old_threshold);
+}
@@ -0,0 +1,356 @@
+#define BOOST_TEST_MODULE FilteringPublicTest
+#include <boost/test/unit_test.hpp>
+
+#include "src/Array2D.hpp"
+#include "src/Filtering.hpp"
+#include "src/Parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+using filtering::Boundary;
+using filtering::Method;
+
+namespace
+{
+
+const Boundary all_boundaries[] = {
+	Boundary::Zero, Boundary::Replicate, Boundary::Reflect, Boundary::Wrap
+};
+
+Array2D testImage(size_t rows, size_t cols, double seed,
+				  Layout layout = Layout::RowMajor)
+{
+	Array2D image{rows, cols, layout};
+	for (size_t row = 0; row != rows; ++row)
+	{
+		for (size_t col = 0; col != cols; ++col)
+		{
+			image(row, col) = std::sin(seed + 0.37 * row + 0.91 * col);
+		}
+	}
+	return image;
+}
+
+/**
+ * @brief Return the index that stands in for `i` along an axis of length
+ * 		`n`, or -1 for zero.
+ */
+ptrdiff_t mapIndex(ptrdiff_t i, ptrdiff_t n, Boundary boundary)
+{
+	switch (boundary)
+	{
+	case Boundary::Zero:
+		return i < 0 or i >= n ? -1 : i;
+	case Boundary::Replicate:
+		return std::min(std::max<ptrdiff_t>(i, 0), n - 1);
+	case Boundary::Reflect:
+		if (n == 1) return 0;
+		while (i < 0 or i >= n) i = i < 0 ? -i : 2 * (n - 1) - i;
+		return i;
+	case Boundary::Wrap:
+		return (i % n + n) % n;
+	}
+	return -1;
+}
+
+/**
+ * @brief Convolve the slow, obvious way.
+ */
+Array2D referenceConvolve(const Array2D& image, const Array2D& kernel,
+						  Boundary boundary)
+{
+	const ptrdiff_t rows = image.size().first;
+	const ptrdiff_t cols = image.size().second;
+	const ptrdiff_t k_rows = kernel.size().first;
+	const ptrdiff_t k_cols = kernel.size().second;
+
+	Array2D result{image.size().first, image.size().second};
+	for (ptrdiff_t row = 0; row != rows; ++row)
+	{
+		for (ptrdiff_t col = 0; col != cols; ++col)
+		{
+			double sum = 0.0;
+			for (ptrdiff_t i = 0; i != k_rows; ++i)
+			{
+				for (ptrdiff_t j = 0; j != k_cols; ++j)
+				{
+					const ptrdiff_t src_row = mapIndex(row + k_rows / 2 - i,
+													   rows, boundary);
+					const ptrdiff_t src_col = mapIndex(col + k_cols / 2 - j,
+													   cols, boundary);
+					if (src_row < 0 or src_col < 0) continue;
+					sum += kernel(i, j) * image(src_row, src_col);
+				}
+			}
+			result(row, col) = sum;
+		}
+	}
+	return result;
+}
+
+bool isClose(const Array2D& lhs, const Array2D& rhs, double tolerance = 1e-12)
+{
+	if (lhs.size() != rhs.size()) return false;
+	for (size_t row = 0; row != lhs.size().first; ++row)
+	{
+		for (size_t col = 0; col != lhs.size().second; ++col)
+		{
+			if (not (std::abs(lhs(row, col) - rhs(row, col)) <= tolerance))
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+Array2D outerProduct(const std::vector<double>& col_kernel,
+					 const std::vector<double>& row_kernel)
+{
+	Array2D kernel{col_kernel.size(), row_kernel.size()};
+	for (size_t i = 0; i != col_kernel.size(); ++i)
+	{
+		for (size_t j = 0; j != row_kernel.size(); ++j)
+		{
+			kernel(i, j) = col_kernel[i] * row_kernel[j];
+		}
+	}
+	return kernel;
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(testConvolveMatchesReference)
+{
+	BOOST_TEST_MESSAGE("testConvolveMatchesReference");
+
+	for (size_t threads : {1, 3})
+	{
+		parallel::setNumThreads(threads);
+
+		// Tall enough for several blocks and threads, and with kernels bigger
+		// than the image in both directions.
+		const size_t shapes[][2] = {{1, 1}, {4, 2}, {9, 13}, {150, 37}};
+		const size_t kernel_shapes[][2] = {{1, 1}, {3, 5}, {7, 3}, {9, 9}};
+		for (const auto& shape : shapes)
+		{
+			const Array2D image = testImage(shape[0], shape[1], 1.0);
+			for (const auto& kernel_shape : kernel_shapes)
+			{
+				const Array2D kernel = testImage(kernel_shape[0],
+												 kernel_shape[1], 2.0);
+				for (Boundary boundary : all_boundaries)
+				{
+					const Array2D expected = referenceConvolve(image, kernel,
+															   boundary);
+					for (Method method : {Method::Direct, Method::Im2col})
+					{
+						BOOST_CHECK_MESSAGE(isClose(filtering::convolve(image,
+							kernel, boundary, method), expected),
+							"testConvolveMatchesReference failed!");
+					}
+				}
+			}
+		}
+	}
+	parallel::setNumThreads(0);
+}
+
+BOOST_AUTO_TEST_CASE(testColumnMajorImages)
+{
+	BOOST_TEST_MESSAGE("testColumnMajorImages");
+
+	const Array2D image = testImage(23, 17, 3.0);
+	const Array2D col_major = image.toLayout(Layout::ColumnMajor);
+	const Array2D kernel = testImage(3, 5, 4.0);
+	const std::vector<double> row_kernel = {0.25, -0.5, 1.0};
+	const std::vector<double> col_kernel = {0.1, 0.2, 0.3, 0.4, 0.5};
+
+	for (Method method : {Method::Direct, Method::Im2col})
+	{
+		const Array2D result = filtering::convolve(col_major, kernel,
+			Boundary::Reflect, method);
+		BOOST_CHECK_MESSAGE(result.layout() == Layout::ColumnMajor
+			and isClose(result, filtering::convolve(image, kernel)),
+			"testColumnMajorImages failed!");
+	}
+
+	const Array2D separable = filtering::separableConvolve(col_major,
+		row_kernel, col_kernel, Boundary::Wrap);
+	BOOST_CHECK_MESSAGE(separable.layout() == Layout::ColumnMajor
+		and isClose(separable, filtering::separableConvolve(image, row_kernel,
+		col_kernel, Boundary::Wrap)), "testColumnMajorImages failed!");
+
+	BOOST_CHECK_MESSAGE(isClose(filtering::boxFilter(col_major, 2),
+		filtering::boxFilter(image, 2)), "testColumnMajorImages failed!");
+}
+
+BOOST_AUTO_TEST_CASE(testKernelBanks)
+{
+	BOOST_TEST_MESSAGE("testKernelBanks");
+
+	const Array2D image = testImage(70, 45, 5.0);
+	std::vector<Array2D> kernels;
+	for (size_t f = 0; f != 6; ++f) kernels.push_back(testImage(7, 7, 6.0 + f));
+
+	for (Method method : {Method::Automatic, Method::Direct, Method::Im2col})
+	{
+		const std::vector<Array2D> results = filtering::convolve(image,
+			kernels, Boundary::Replicate, method);
+		BOOST_REQUIRE(results.size() == kernels.size());
+		for (size_t f = 0; f != kernels.size(); ++f)
+		{
+			BOOST_CHECK_MESSAGE(isClose(results[f], referenceConvolve(image,
+				kernels[f], Boundary::Replicate)), "testKernelBanks failed!");
+		}
+	}
+
+	BOOST_CHECK_MESSAGE(filtering::convolve(image, std::vector<Array2D>{})
+		.empty(), "testKernelBanks failed!");
+	kernels.push_back(testImage(5, 7, 1.0));
+	BOOST_CHECK_THROW(filtering::convolve(image, kernels), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(testSeparableConvolve)
+{
+	BOOST_TEST_MESSAGE("testSeparableConvolve");
+
+	const std::vector<double> row_kernel = {1.0, -2.0, 0.5, 3.0, 0.25};
+	const std::vector<double> col_kernel = {0.5, 1.5, -1.0};
+	const Array2D kernel = outerProduct(col_kernel, row_kernel);
+
+	for (size_t threads : {1, 3})
+	{
+		parallel::setNumThreads(threads);
+		for (const Array2D& image : {testImage(1, 1, 7.0), testImage(3, 2, 7.0),
+									 testImage(131, 29, 7.0)})
+		{
+			for (Boundary boundary : all_boundaries)
+			{
+				BOOST_CHECK_MESSAGE(isClose(filtering::separableConvolve(image,
+					row_kernel, col_kernel, boundary),
+					referenceConvolve(image, kernel, boundary)),
+					"testSeparableConvolve failed!");
+			}
+		}
+	}
+	parallel::setNumThreads(0);
+
+	BOOST_CHECK_THROW(filtering::separableConvolve(testImage(4, 4, 1.0),
+		{1.0, 1.0}, {1.0}), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(testBoxFilter)
+{
+	BOOST_TEST_MESSAGE("testBoxFilter");
+
+	for (size_t threads : {1, 3})
+	{
+		parallel::setNumThreads(threads);
+		for (size_t radius : {0, 1, 4, 12})
+		{
+			const size_t width = 2 * radius + 1;
+			Array2D uniform{width, width};
+			for (size_t i = 0; i != width * width; ++i)
+			{
+				uniform[i] = 1.0 / (width * width);
+			}
+
+			// Including an image smaller than the box.
+			for (const Array2D& image : {testImage(5, 3, 8.0),
+										 testImage(97, 41, 8.0)})
+			{
+				for (Boundary boundary : all_boundaries)
+				{
+					BOOST_CHECK_MESSAGE(isClose(filtering::boxFilter(image,
+						radius, boundary),
+						referenceConvolve(image, uniform, boundary)),
+						"testBoxFilter failed!");
+				}
+			}
+		}
+	}
+	parallel::setNumThreads(0);
+}
+
+BOOST_AUTO_TEST_CASE(testGaussian)
+{
+	BOOST_TEST_MESSAGE("testGaussian");
+
+	const std::vector<double> weights = filtering::gaussianKernel(1.5);
+	double total = 0.0;
+	for (double weight : weights) total += weight;
+	BOOST_CHECK_MESSAGE(weights.size() == 11 and std::abs(total - 1.0) < 1e-15
+		and weights.front() == weights.back()
+		and weights[5] == *std::max_element(weights.begin(), weights.end()),
+		"testGaussian failed!");
+	BOOST_CHECK_MESSAGE(filtering::gaussianKernel(0.0).size() == 1,
+		"testGaussian failed!");
+
+	// The blur of an impulse is the (approximate) Gaussian itself, so its
+	// variance along each axis should be exactly `sigma^2`.
+	for (double sigma : {0.4, 1.0, 2.5, 6.0})
+	{
+		Array2D impulse{81, 81};
+		impulse(40, 40) = 1.0;
+		const Array2D blurred = filtering::gaussianBlur(impulse, sigma,
+														Boundary::Zero);
+		double mass = 0.0;
+		double variance = 0.0;
+		for (size_t row = 0; row != 81; ++row)
+		{
+			for (size_t col = 0; col != 81; ++col)
+			{
+				const double offset = static_cast<double>(row) - 40.0;
+				mass += blurred(row, col);
+				variance += blurred(row, col) * offset * offset;
+			}
+		}
+		BOOST_CHECK_MESSAGE(std::abs(mass - 1.0) < 1e-12
+			and std::abs(variance - sigma * sigma) < 1e-10 * sigma * sigma,
+			"testGaussian failed!");
+	}
+
+	const Array2D image = testImage(20, 30, 9.0);
+	BOOST_CHECK_MESSAGE(isClose(filtering::gaussianBlur(image, 0.0), image),
+		"testGaussian failed!");
+	BOOST_CHECK_THROW(filtering::gaussianBlur(image, -1.0), std::runtime_error);
+	BOOST_CHECK_THROW(filtering::gaussianKernel(std::nan("")),
+		std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(testOutputIsReused)
+{
+	BOOST_TEST_MESSAGE("testOutputIsReused");
+
+	const Array2D image = testImage(30, 40, 10.0);
+	const Array2D kernel = testImage(3, 3, 11.0);
+
+	Array2D out{30, 40};
+	const double* storage = out.data();
+	filtering::convolve(image, kernel, out);
+	BOOST_CHECK_MESSAGE(out.data() == storage
+		and isClose(out, filtering::convolve(image, kernel)),
+		"testOutputIsReused failed!");
+
+	filtering::boxFilter(image, 3, out);
+	BOOST_CHECK_MESSAGE(out.data() == storage
+		and isClose(out, filtering::boxFilter(image, 3)),
+		"testOutputIsReused failed!");
+
+	// A differently-shaped output is replaced.
+	Array2D wrong_size{2, 2};
+	filtering::separableConvolve(image, {1.0}, {1.0}, wrong_size);
+	BOOST_CHECK_MESSAGE(isClose(wrong_size, image),
+		"testOutputIsReused failed!");
+
+	Array2D in_place = testImage(5, 5, 1.0);
+	BOOST_CHECK_THROW(filtering::boxFilter(in_place, 1, in_place),
+		std::runtime_error);
+	BOOST_CHECK_THROW(filtering::convolve(image, testImage(2, 3, 1.0)),
+		std::runtime_error);
+}
@@ -0,0 +1,315 @@
+#define BOOST_TEST_MODULE KernelsPublicTest
+#include <boost/test/unit_test.hpp>
+
+#include "src/Kernels.hpp"
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+using kernels::Isa;
+using std::vector;
+
+namespace
+{
+
+const Isa all_isas[] = {Isa::Sse2, Isa::Avx2, Isa::Avx512};
+
+vector<double> testValues(size_t n, double seed)
+{
+	vector<double> values(n);
+	for (size_t i = 0; i != n; ++i) values[i] = std::sin(seed + 0.37 * i);
+	return values;
+}
+
+bool closeTo(double lhs, double rhs, double tolerance = 1e-12)
+{
+	return std::abs(lhs - rhs) <= tolerance * (1.0 + std::abs(rhs));
+}
+
+/**
+ * @brief Run `check` once for every instruction set that this machine
+ * 		supports, with that instruction set's kernels active.
+ */
+template <typename Check>
+void forEachSupportedIsa(Check check)
+{
+	for (Isa isa : all_isas)
+	{
+		if (not kernels::isSupported(isa)) continue;
+		BOOST_TEST_MESSAGE("checking " << kernels::isaName(isa));
+		kernels::forceIsa(isa);
+		check(isa);
+	}
+	kernels::resetIsa();
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(testSelection)
+{
+	BOOST_TEST_MESSAGE("testSelection");
+
+	BOOST_CHECK_MESSAGE(kernels::isSupported(Isa::Sse2),
+		"testSelection failed!");
+	BOOST_CHECK_MESSAGE(kernels::isSupported(kernels::bestSupportedIsa()),
+		"testSelection failed!");
+
+	for (Isa isa : all_isas)
+	{
+		if (kernels::isSupported(isa))
+		{
+			kernels::forceIsa(isa);
+			BOOST_CHECK_MESSAGE(kernels::activeIsa() == isa,
+				"testSelection failed!");
+		}
+		else
+		{
+			BOOST_CHECK_THROW(kernels::forceIsa(isa), std::runtime_error);
+		}
+	}
+	kernels::resetIsa();
+
+	BOOST_CHECK_MESSAGE(std::string{kernels::isaName(Isa::Avx2)} == "avx2",
+		"testSelection failed!");
+}
+
+BOOST_AUTO_TEST_CASE(testElementwiseKernels)
+{
+	BOOST_TEST_MESSAGE("testElementwiseKernels");
+
+	forEachSupportedIsa([](Isa) {
+		// Every length up to a few registers, to exercise the scalar tails.
+		for (size_t n = 0; n != 40; ++n)
+		{
+			const vector<double> a = testValues(n, 1.0);
+			vector<double> b = testValues(n, 2.0);
+			for (double& val : b) val += 2.0;	// keep away from zero
+
+			vector<double> out(n);
+			bool all_match{true};
+
+			kernels::active().add(n, a.data(), b.data(), out.data());
+			for (size_t i = 0; i != n; ++i) all_match &= out[i] == a[i] + b[i];
+			kernels::active().subtract(n, a.data(), b.data(), out.data());
+			for (size_t i = 0; i != n; ++i) all_match &= out[i] == a[i] - b[i];
+			kernels::active().multiply(n, a.data(), b.data(), out.data());
+			for (size_t i = 0; i != n; ++i) all_match &= out[i] == a[i] * b[i];
+			kernels::active().divide(n, a.data(), b.data(), out.data());
+			for (size_t i = 0; i != n; ++i) all_match &= out[i] == a[i] / b[i];
+			kernels::active().scale(n, 3.0, a.data(), out.data());
+			for (size_t i = 0; i != n; ++i) all_match &= out[i] == 3.0 * a[i];
+
+			BOOST_CHECK_MESSAGE(all_match, "testElementwiseKernels failed!");
+		}
+	});
+}
+
+BOOST_AUTO_TEST_CASE(testReductionKernels)
+{
+	BOOST_TEST_MESSAGE("testReductionKernels");
+
+	forEachSupportedIsa([](Isa) {
+		for (size_t n : {0, 1, 3, 7, 8, 15, 31, 33, 64, 1001})
+		{
+			const vector<double> a = testValues(n, 1.0);
+			const vector<double> b = testValues(n, 2.0);
+
+			double sum = 0.0;
+			double dot = 0.0;
+			for (size_t i = 0; i != n; ++i)
+			{
+				sum += a[i];
+				dot += a[i] * b[i];
+			}
+
+			BOOST_CHECK_MESSAGE(closeTo(kernels::active().sum(n, a.data()), sum),
+				"testReductionKernels failed!");
+			BOOST_CHECK_MESSAGE(
+				closeTo(kernels::active().dot(n, a.data(), b.data()), dot),
+				"testReductionKernels failed!");
+		}
+	});
+}
+
+BOOST_AUTO_TEST_CASE(testGemmKernel)
+{
+	BOOST_TEST_MESSAGE("testGemmKernel");
+
+	forEachSupportedIsa([](Isa) {
+		// Odd sizes hit every edge case of the register and cache blocking.
+		const size_t shapes[][3] = {
+			{1, 1, 1}, {4, 16, 8}, {5, 17, 3}, {13, 9, 130}, {33, 270, 7},
+		};
+		for (const auto& shape : shapes)
+		{
+			const size_t m = shape[0];
+			const size_t n = shape[1];
+			const size_t k = shape[2];
+
+			// Pad every row, so that the leading dimensions are exercised.
+			const size_t lda = k + 3;
+			const size_t ldb = n + 1;
+			const size_t ldc = n + 2;
+			const vector<double> a = testValues(m * lda, 1.0);
+			const vector<double> b = testValues(k * ldb, 2.0);
+			vector<double> c = testValues(m * ldc, 3.0);
+			vector<double> expected = c;
+
+			for (size_t i = 0; i != m; ++i)
+			{
+				for (size_t j = 0; j != n; ++j)
+				{
+					double total = 0.0;
+					for (size_t p = 0; p != k; ++p)
+					{
+						total += a[i * lda + p] * b[p * ldb + j];
+					}
+					expected[i * ldc + j] += 0.5 * total;
+				}
+			}
+
+			kernels::active().gemm(m, n, k, 0.5, a.data(), lda, b.data(), ldb,
+								   c.data(), ldc);
+
+			bool all_match{true};
+			for (size_t i = 0; i != c.size(); ++i)
+			{
+				all_match &= closeTo(c[i], expected[i]);
+			}
+			BOOST_CHECK_MESSAGE(all_match, "testGemmKernel failed!");
+		}
+	});
+}
+
+BOOST_AUTO_TEST_CASE(testGemvKernels)
+{
+	BOOST_TEST_MESSAGE("testGemvKernels");
+
+	forEachSupportedIsa([](Isa) {
+		// Row counts around the four-row blocking, column counts around the
+		// register width.
+		const size_t shapes[][2] = {
+			{1, 1}, {3, 7}, {4, 8}, {5, 17}, {9, 33}, {70, 3},
+		};
+		for (const auto& shape : shapes)
+		{
+			const size_t m = shape[0];
+			const size_t n = shape[1];
+			const size_t lda = n + 3;
+			const vector<double> a = testValues(m * lda, 1.0);
+			const vector<double> x = testValues(m + n, 2.0);
+			vector<double> y = testValues(m + n, 3.0);
+			vector<double> y_t = y;
+
+			vector<double> expected = y;
+			vector<double> expected_t = y;
+			for (size_t i = 0; i != m; ++i)
+			{
+				for (size_t j = 0; j != n; ++j)
+				{
+					expected[i] += 0.5 * a[i * lda + j] * x[j];
+					expected_t[j] += 0.5 * a[i * lda + j] * x[i];
+				}
+			}
+
+			kernels::active().gemv(m, n, 0.5, a.data(), lda, x.data(),
+								   y.data());
+			kernels::active().gemvTransposed(m, n, 0.5, a.data(), lda,
+											 x.data(), y_t.data());
+
+			bool all_match{true};
+			for (size_t i = 0; i != y.size(); ++i)
+			{
+				all_match &= closeTo(y[i], expected[i]);
+				all_match &= closeTo(y_t[i], expected_t[i]);
+			}
+			BOOST_CHECK_MESSAGE(all_match, "testGemvKernels failed!");
+		}
+
+		for (size_t n = 0; n != 40; ++n)
+		{
+			const vector<double> x = testValues(n, 4.0);
+			vector<double> y = testValues(n, 5.0);
+			const vector<double> original = y;
+
+			kernels::active().axpy(n, -2.0, x.data(), y.data());
+			bool all_match{true};
+			for (size_t i = 0; i != n; ++i)
+			{
+				all_match &= closeTo(y[i], original[i] - 2.0 * x[i]);
+			}
+			BOOST_CHECK_MESSAGE(all_match, "testGemvKernels failed!");
+		}
+	});
+}
+
+BOOST_AUTO_TEST_CASE(testCorrelateKernel)
+{
+	BOOST_TEST_MESSAGE("testCorrelateKernel");
+
+	forEachSupportedIsa([](Isa) {
+		// Past 7 columns, the kernel takes its generic path.
+		for (size_t taps = 1; taps <= 9; ++taps)
+		{
+			for (size_t num_out : {1, 2, 5})
+			{
+				const size_t n = 37;
+				const size_t rows = taps % 2 == 0 ? 1 : taps;
+				const size_t ld_in = n + taps + 2;
+				const vector<double> weights = testValues(rows * taps, 2.0);
+				const vector<double> in = testValues((num_out + rows - 1) * ld_in,
+													 3.0);
+				vector<double> out(num_out * n, 1e300);
+
+				kernels::active().correlateRows(num_out, n, rows, taps,
+					weights.data(), in.data(), ld_in, out.data(), n);
+
+				bool all_match{true};
+				for (size_t row = 0; row != num_out; ++row)
+				{
+					for (size_t col = 0; col != n; ++col)
+					{
+						double expected{0.0};
+						for (size_t i = 0; i != rows; ++i)
+						{
+							for (size_t j = 0; j != taps; ++j)
+							{
+								expected += weights[i * taps + j]
+									* in[(row + i) * ld_in + col + j];
+							}
+						}
+						all_match &= closeTo(out[row * n + col], expected);
+					}
+				}
+				BOOST_CHECK_MESSAGE(all_match, "testCorrelateKernel failed! ("
+					<< rows << "x" << taps << ", " << num_out << " rows)");
+			}
+		}
+	});
+}
+
+BOOST_AUTO_TEST_CASE(testTransposeKernel)
+{
+	BOOST_TEST_MESSAGE("testTransposeKernel");
+
+	forEachSupportedIsa([](Isa) {
+		const size_t rows = 37;
+		const size_t cols = 19;
+		const vector<double> in = testValues(rows * cols, 1.0);
+		vector<double> out(rows * cols);
+
+		kernels::active().transpose(rows, cols, in.data(), cols, out.data(),
+									rows);
+
+		bool all_match{true};
+		for (size_t row = 0; row != rows; ++row)
+		{
+			for (size_t col = 0; col != cols; ++col)
+			{
+				all_match &= out[col * rows + row] == in[row * cols + col];
+			}
+		}
+		BOOST_CHECK_MESSAGE(all_match, "testTransposeKernel failed!");
+	});
+}
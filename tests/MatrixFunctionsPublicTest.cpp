@@ -0,0 +1,221 @@
+#define BOOST_TEST_MODULE MatrixFunctionsPublicTest
+#include <boost/test/unit_test.hpp>
+
+#include "src/Backend.hpp"
+#include "src/Matrix.hpp"
+#include "src/Reductions.hpp"
+#include "tests/TestHelpers.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using reductions::isApprox;
+using reductions::Tolerance;
+
+namespace
+{
+
+/**
+ * @brief Sizes on both sides of the largest one with a fixed-size path.
+ */
+const size_t test_sizes[] = {1, 2, 3, 4, 5, 6, 7, 12, 40};
+
+Matrix scaled(const Matrix& mat, double factor)
+{
+	Matrix result{mat};
+	for (size_t row = 1; row <= mat.size().first; ++row)
+	{
+		for (size_t col = 1; col <= mat.size().second; ++col)
+		{
+			result(row, col) *= factor;
+		}
+	}
+	return result;
+}
+
+/**
+ * @brief Sum the Taylor series of `e^A` until the terms stop mattering.
+ * @detail Only accurate for small `A`, where nothing cancels.
+ */
+Matrix taylorExponential(const Matrix& a)
+{
+	const size_t n = a.size().first;
+	Matrix sum = identity(n);
+	Matrix term = identity(n);
+	for (int k = 1; k <= 30; ++k)
+	{
+		term = term * a / k;
+		sum = sum + term;
+	}
+	return sum;
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(testPow)
+{
+	BOOST_TEST_MESSAGE("testPow");
+
+	for (size_t n : test_sizes)
+	{
+		for (Layout layout : {Layout::RowMajor, Layout::ColumnMajor})
+		{
+			const Matrix a = scaled(testMatrix(n, n, 0.5 * n, layout), 1.0 / n);
+			BOOST_CHECK_MESSAGE(a.pow(0) == identity(n) and a.pow(1) == a,
+				"testPow failed!");
+
+			Matrix repeated = a;
+			bool ok = true;
+			for (int exponent = 2; exponent <= 13; ++exponent)
+			{
+				repeated = repeated * a;
+				const Matrix power = a.pow(exponent);
+				const double largest = std::max(
+					std::abs(reductions::maxCoeff(repeated)),
+					std::abs(reductions::minCoeff(repeated)));
+				ok = ok and power.layout() == layout
+					and isApprox(power, repeated, 1e-13 * largest);
+			}
+			BOOST_CHECK_MESSAGE(ok, "testPow failed! (n = " << n << ")");
+		}
+	}
+
+	// Negative powers invert.
+	Matrix a = testMatrix(5, 5, 1.0);
+	for (size_t i = 1; i <= 5; ++i) a(i, i) += 5.0;
+	BOOST_CHECK_MESSAGE(isApprox(a.pow(-3) * a.pow(3), identity(5), 1e-12),
+		"testPow failed!");
+
+	// A rotation by 1 degree, 360 times, is the identity.
+	const double radians = std::acos(-1.0) / 180.0;
+	Matrix rotation{2, 2};
+	rotation(1, 1) = std::cos(radians);
+	rotation(1, 2) = -std::sin(radians);
+	rotation(2, 1) = std::sin(radians);
+	rotation(2, 2) = std::cos(radians);
+	BOOST_CHECK_MESSAGE(isApprox(rotation.pow(360), identity(2), 1e-12),
+		"testPow failed!");
+
+	BOOST_CHECK_THROW(Matrix(2, 3).pow(2), std::runtime_error);
+	BOOST_CHECK_THROW(Matrix(3, 3).pow(-1), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(testExpmClosedForms)
+{
+	BOOST_TEST_MESSAGE("testExpmClosedForms");
+
+	// e^diag(d) = diag(e^d), from tiny norms (the lowest Padé degree) up to
+	// ones that need scaling and squaring.
+	for (double magnitude : {1e-3, 0.1, 0.5, 1.5, 4.0, 30.0})
+	{
+		for (size_t n : test_sizes)
+		{
+			Matrix diagonal{n, n};
+			Matrix expected{n, n};
+			for (size_t i = 1; i <= n; ++i)
+			{
+				diagonal(i, i) = magnitude * std::sin(1.0 + i);
+				expected(i, i) = std::exp(diagonal(i, i));
+			}
+			BOOST_CHECK_MESSAGE(
+				isApprox(diagonal.expm(), expected, 1e-13, Tolerance::Relative),
+				"testExpmClosedForms failed! (" << magnitude << ", " << n << ")");
+		}
+	}
+
+	// The exponential of a skew-symmetric 2x2 matrix is a rotation.
+	for (double angle : {0.01, 1.0, 10.0, 100.0})
+	{
+		Matrix generator{2, 2};
+		generator(1, 2) = -angle;
+		generator(2, 1) = angle;
+		Matrix rotation{2, 2};
+		rotation(1, 1) = std::cos(angle);
+		rotation(1, 2) = -std::sin(angle);
+		rotation(2, 1) = std::sin(angle);
+		rotation(2, 2) = std::cos(angle);
+		BOOST_CHECK_MESSAGE(isApprox(generator.expm(), rotation, 1e-12 * angle),
+			"testExpmClosedForms failed! (" << angle << ")");
+	}
+
+	// A nilpotent matrix's series ends: e^N = I + N + N^2 / 2.
+	Matrix nilpotent{3, 3};
+	nilpotent(1, 2) = 2.0;
+	nilpotent(1, 3) = -3.0;
+	nilpotent(2, 3) = 5.0;
+	BOOST_CHECK_MESSAGE(isApprox(nilpotent.expm(),
+		identity(3) + nilpotent + nilpotent * nilpotent / 2.0, 1e-13),
+		"testExpmClosedForms failed!");
+
+	BOOST_CHECK_MESSAGE(Matrix(4, 4).expm() == identity(4),
+		"testExpmClosedForms failed!");
+}
+
+BOOST_AUTO_TEST_CASE(testExpmHugeNorms)
+{
+	BOOST_TEST_MESSAGE("testExpmHugeNorms");
+
+	// Far past the point where the sixth power of A overflows, e^A is still
+	// representable, as long as A is scaled before its powers are formed.
+	for (size_t n : test_sizes)
+	{
+		Matrix decaying{n, n};
+		for (size_t i = 1; i <= n; ++i)
+		{
+			decaying(i, i) = -1e60;
+			if (i < n) decaying(i, i + 1) = 1e59;
+		}
+		BOOST_CHECK_MESSAGE(decaying.expm() == Matrix(n, n),
+			"testExpmHugeNorms failed! (n = " << n << ")");
+	}
+
+	// e^N = I + N for a nilpotent N with N^2 = 0, however large N is.
+	for (double magnitude : {1e60, 1e200})
+	{
+		Matrix nilpotent{2, 2};
+		nilpotent(1, 2) = magnitude;
+		BOOST_CHECK_MESSAGE(isApprox(nilpotent.expm(), identity(2) + nilpotent,
+			1e-13, Tolerance::Relative),
+			"testExpmHugeNorms failed! (" << magnitude << ")");
+	}
+}
+
+BOOST_AUTO_TEST_CASE(testExpmIdentities)
+{
+	BOOST_TEST_MESSAGE("testExpmIdentities");
+
+	const size_t old_threshold = backend::dispatchThreshold();
+	for (size_t threshold : {old_threshold, size_t{0}})
+	{
+		backend::setDispatchThreshold(threshold);
+		for (size_t n : test_sizes)
+		{
+			for (Layout layout : {Layout::RowMajor, Layout::ColumnMajor})
+			{
+				// Small enough to check against the Taylor series.
+				const Matrix small = scaled(testMatrix(n, n, 2.0, layout), 0.2 / n);
+				const Matrix e_small = small.expm();
+				BOOST_CHECK_MESSAGE(e_small.layout() == layout
+					and isApprox(e_small, taylorExponential(small), 1e-14),
+					"testExpmIdentities failed! (n = " << n << ")");
+
+				// e^A * e^-A = I, and e^(2A) = (e^A)^2, in the scaled range.
+				const Matrix a = scaled(testMatrix(n, n, 3.0, layout),
+					8.0 / std::sqrt(n));
+				const Matrix e_a = a.expm();
+				BOOST_CHECK_MESSAGE(
+					isApprox(e_a * scaled(a, -1.0).expm(), identity(n), 1e-10)
+					and isApprox(scaled(a, 2.0).expm(), e_a.pow(2), 1e-11,
+								 Tolerance::Relative),
+					"testExpmIdentities failed! (n = " << n << ")");
+			}
+		}
+	}
+	backend::setDispatchThreshold(old_threshold);
+
+	BOOST_CHECK_THROW(Matrix(2, 3).expm(), std::runtime_error);
+	Matrix infinite{2, 2};
+	infinite(1, 2) = HUGE_VAL;
+	BOOST_CHECK_THROW(infinite.expm(), std::runtime_error);
+}
@@ -0,0 +1,341 @@
+#define BOOST_TEST_MODULE MatrixPublicTest
+#include <boost/test/unit_test.hpp>
+
+#include "bin/Helpers.hpp"
+#include "src/Matrix.hpp"
+
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+Matrix twoByTwo(double a, double b, double c, double d)
+{
+	Matrix mat{2, 2};
+	mat(1, 1) = a;
+	mat(1, 2) = b;
+	mat(2, 1) = c;
+	mat(2, 2) = d;
+	return mat;
+}
+
+/**
+ * @brief Build a `rows x cols` Matrix with distinct, non-integer elements.
+ */
+Matrix filled(size_t rows, size_t cols, Layout layout = Layout::RowMajor)
+{
+	Matrix mat{rows, cols, layout};
+	for (size_t row = 1; row <= rows; ++row)
+	{
+		for (size_t col = 1; col <= cols; ++col)
+		{
+			mat(row, col) = std::sin(row * 7.0 + col * 3.0);
+			if (row == col) mat(row, col) += rows;
+		}
+	}
+	return mat;
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(testIndexingStartsFromOne)
+{
+	BOOST_TEST_MESSAGE("testIndexingStartsFromOne");
+
+	Matrix mat{2, 3};
+	mat(2, 3) = 4.0;
+
+	BOOST_CHECK_MESSAGE(mat.data()[5] == 4.0,
+		"testIndexingStartsFromOne failed!");
+	BOOST_CHECK_THROW(mat(0, 1), std::runtime_error);
+	BOOST_CHECK_THROW(mat(3, 1), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(testBlankMatrixThrows)
+{
+	BOOST_TEST_MESSAGE("testBlankMatrixThrows");
+
+	Matrix blank;
+	Matrix copy{blank};
+
+	BOOST_CHECK_THROW(blank.size(), std::runtime_error);
+	BOOST_CHECK_THROW(copy.transpose(), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(testArithmetic)
+{
+	BOOST_TEST_MESSAGE("testArithmetic");
+
+	const Matrix lhs = twoByTwo(1, 2, 3, 4);
+	const Matrix rhs = twoByTwo(5, 6, 7, 8);
+
+	BOOST_CHECK_MESSAGE(lhs + rhs == twoByTwo(6, 8, 10, 12),
+		"testArithmetic failed!");
+	BOOST_CHECK_MESSAGE(lhs - rhs == twoByTwo(-4, -4, -4, -4),
+		"testArithmetic failed!");
+	BOOST_CHECK_MESSAGE(lhs / 2.0 == twoByTwo(0.5, 1.0, 1.5, 2.0),
+		"testArithmetic failed!");
+	BOOST_CHECK_MESSAGE(isApproxEqual(lhs.divide(rhs),
+		twoByTwo(0.2, 1.0 / 3, 3.0 / 7, 0.5)), "testArithmetic failed!");
+	BOOST_CHECK_THROW(lhs + Matrix(2, 3), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(testMultiplication)
+{
+	BOOST_TEST_MESSAGE("testMultiplication");
+
+	Matrix lhs{3, 2};
+	lhs(1, 1) = 1; lhs(1, 2) = 2;
+	lhs(2, 1) = 3; lhs(2, 2) = 4;
+	lhs(3, 1) = 5; lhs(3, 2) = 6;
+
+	Matrix expected{3, 2};
+	expected(1, 1) = 25; expected(1, 2) = 28;
+	expected(2, 1) = 57; expected(2, 2) = 64;
+	expected(3, 1) = 89; expected(3, 2) = 100;
+
+	BOOST_CHECK_MESSAGE(lhs * twoByTwo(7, 8, 9, 10) == expected,
+		"testMultiplication failed!");
+	BOOST_CHECK_THROW(twoByTwo(7, 8, 9, 10) * lhs, std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(testInverseAndSolve)
+{
+	BOOST_TEST_MESSAGE("testInverseAndSolve");
+
+	const Matrix a = twoByTwo(4, 9, 5, 2);
+	Matrix b{2, 1};
+	b(1, 1) = 7;
+	b(2, 1) = 3;
+
+	Matrix x_ans{2, 1};
+	x_ans(1, 1) = 13.0 / 37;
+	x_ans(2, 1) = 23.0 / 37;
+
+	BOOST_CHECK_MESSAGE(isApproxEqual(a.inverse() * b, x_ans),
+		"testInverseAndSolve failed!");
+	BOOST_CHECK_MESSAGE(isApproxEqual(a.solve(b), x_ans),
+		"testInverseAndSolve failed!");
+	BOOST_CHECK_THROW(twoByTwo(1, 2, 2, 4).inverse(), std::runtime_error);
+	BOOST_CHECK_THROW(Matrix(2, 3).inverse(), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(testTransposeAndResize)
+{
+	BOOST_TEST_MESSAGE("testTransposeAndResize");
+
+	Matrix row{1, 2};
+	row(1, 1) = 7;
+	row(1, 2) = 3;
+
+	Matrix col = row.transpose();
+	col.resize(3, 2);
+
+	Matrix expected{3, 2};
+	expected(1, 1) = 7;
+	expected(2, 1) = 3;
+
+	BOOST_CHECK_MESSAGE(col == expected, "testTransposeAndResize failed!");
+	BOOST_CHECK_MESSAGE(col.transpose().transpose() == col,
+		"testTransposeAndResize failed!");
+}
+
+BOOST_AUTO_TEST_CASE(testStreamInsertion)
+{
+	BOOST_TEST_MESSAGE("testStreamInsertion");
+
+	std::ostringstream out;
+	out << twoByTwo(1, 2, 3, 4) << "foobar";
+
+	BOOST_CHECK_MESSAGE(out.str() == "[1\t2]\n[3\t4]\nfoobar",
+		"testStreamInsertion failed!");
+}
+
+BOOST_AUTO_TEST_CASE(testCopiesAreDeepByDefault)
+{
+	BOOST_TEST_MESSAGE("testCopiesAreDeepByDefault");
+
+	const Matrix original = twoByTwo(1, 2, 3, 4);
+	Matrix copy{original};
+	Matrix assigned{1, 1};
+	assigned = original;
+
+	BOOST_CHECK_MESSAGE(not copy.copyOnWrite() and not copy.isShared()
+		and copy.data() != original.data(), "testCopiesAreDeepByDefault failed!");
+	BOOST_CHECK_MESSAGE(not assigned.isShared()
+		and assigned == original, "testCopiesAreDeepByDefault failed!");
+}
+
+BOOST_AUTO_TEST_CASE(testMovesTransferStorage)
+{
+	BOOST_TEST_MESSAGE("testMovesTransferStorage");
+
+	for (bool copy_on_write : {false, true})
+	{
+		Matrix original = twoByTwo(1, 2, 3, 4);
+		original.setCopyOnWrite(copy_on_write);
+		const double* original_vals =
+			static_cast<const Matrix&>(original).data();
+
+		Matrix moved{std::move(original)};
+		Matrix assigned{3, 3};
+		assigned = std::move(moved);
+		const Matrix& view = assigned;
+
+		BOOST_CHECK_MESSAGE(view.data() == original_vals
+			and not assigned.isShared()
+			and assigned.copyOnWrite() == copy_on_write
+			and assigned == twoByTwo(1, 2, 3, 4),
+			"testMovesTransferStorage failed!");
+		BOOST_CHECK_THROW(moved.size(), std::runtime_error);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(testCopyOnWriteSharesUntilWrite)
+{
+	BOOST_TEST_MESSAGE("testCopyOnWriteSharesUntilWrite");
+
+	Matrix original = twoByTwo(1, 2, 3, 4);
+	original.setCopyOnWrite(true);
+	const double* original_vals = static_cast<const Matrix&>(original).data();
+
+	Matrix copy{original};
+	Matrix assigned{3, 3};
+	assigned = copy;
+	const Matrix& view = copy;
+
+	BOOST_CHECK_MESSAGE(copy.copyOnWrite() and assigned.copyOnWrite(),
+		"testCopyOnWriteSharesUntilWrite failed!");
+	BOOST_CHECK_MESSAGE(view.data() == original_vals and copy.isShared()
+		and view(2, 1) == 3, "testCopyOnWriteSharesUntilWrite failed!");
+
+	// The first write gives `copy` its own buffer and leaves the others be.
+	copy(2, 1) = 30;
+	BOOST_CHECK_MESSAGE(view.data() != original_vals and view(2, 1) == 30,
+		"testCopyOnWriteSharesUntilWrite failed!");
+	BOOST_CHECK_MESSAGE(original == twoByTwo(1, 2, 3, 4)
+		and assigned == original, "testCopyOnWriteSharesUntilWrite failed!");
+
+	// Arithmetic on a shared Matrix mustn't write into its operand.
+	const Matrix sum = assigned + assigned;
+	BOOST_CHECK_MESSAGE(sum == twoByTwo(2, 4, 6, 8)
+		and original == twoByTwo(1, 2, 3, 4),
+		"testCopyOnWriteSharesUntilWrite failed!");
+
+	// Turning the mode off detaches, so later copies are deep again.
+	assigned.setCopyOnWrite(false);
+	const Matrix later{assigned};
+	BOOST_CHECK_MESSAGE(not assigned.isShared() and not later.isShared()
+		and later == original, "testCopyOnWriteSharesUntilWrite failed!");
+}
+
+BOOST_AUTO_TEST_CASE(testCopyOnWriteAcrossThreads)
+{
+	BOOST_TEST_MESSAGE("testCopyOnWriteAcrossThreads");
+
+	Matrix shared{64, 64};
+	for (size_t i = 0; i != 64 * 64; ++i) shared.data()[i] = i;
+	shared.setCopyOnWrite(true);
+	const Matrix expected{shared};
+
+	std::vector<Matrix> results(4);
+	std::vector<std::thread> threads;
+	for (size_t t = 0; t != results.size(); ++t)
+	{
+		threads.emplace_back([&, t] {
+			for (int rep = 0; rep != 200; ++rep)
+			{
+				Matrix copy{shared};
+				copy(1, 1) = t;
+				results[t] = copy;
+			}
+		});
+	}
+	for (auto& thread : threads) thread.join();
+
+	BOOST_CHECK_MESSAGE(shared == expected,
+		"testCopyOnWriteAcrossThreads failed!");
+	for (size_t t = 0; t != results.size(); ++t)
+	{
+		BOOST_CHECK_MESSAGE(results[t](1, 1) == t and results[t](2, 2) == 65,
+			"testCopyOnWriteAcrossThreads failed!");
+	}
+}
+
+BOOST_AUTO_TEST_CASE(testColumnMajorMatchesRowMajor)
+{
+	BOOST_TEST_MESSAGE("testColumnMajorMatchesRowMajor");
+
+	const Matrix a = filled(19, 19);
+	const Matrix b = filled(19, 7);
+	const Matrix a_col = filled(19, 19, Layout::ColumnMajor);
+	const Matrix b_col = filled(19, 7, Layout::ColumnMajor);
+
+	BOOST_CHECK_MESSAGE(a_col.layout() == Layout::ColumnMajor and a_col == a,
+		"testColumnMajorMatchesRowMajor failed!");
+	BOOST_CHECK_MESSAGE(a_col.data()[1] == a(2, 1),
+		"testColumnMajorMatchesRowMajor failed!");
+
+	// Results take the layout of the left-hand operand, whatever the layout
+	// of the right-hand one.
+	for (const Matrix& rhs : {b, b_col})
+	{
+		const Matrix product = a_col * rhs;
+		BOOST_CHECK_MESSAGE(product.layout() == Layout::ColumnMajor
+			and isApproxEqual(product, a * b, 1e-12),
+			"testColumnMajorMatchesRowMajor failed!");
+		BOOST_CHECK_MESSAGE(isApproxEqual(a * rhs, a * b, 1e-12),
+			"testColumnMajorMatchesRowMajor failed!");
+		BOOST_CHECK_MESSAGE((b_col + rhs).layout() == Layout::ColumnMajor
+			and b_col + rhs == b + b and b_col - rhs == b - b,
+			"testColumnMajorMatchesRowMajor failed!");
+		BOOST_CHECK_MESSAGE(isApproxEqual(b_col.divide(rhs), b.divide(b)),
+			"testColumnMajorMatchesRowMajor failed!");
+
+		const Matrix solution = a_col.solve(rhs);
+		BOOST_CHECK_MESSAGE(solution.layout() == Layout::ColumnMajor
+			and isApproxEqual(solution, a.solve(b), 1e-12),
+			"testColumnMajorMatchesRowMajor failed!");
+	}
+
+	const Matrix inverse = a_col.inverse();
+	BOOST_CHECK_MESSAGE(inverse.layout() == Layout::ColumnMajor
+		and isApproxEqual(inverse, a.inverse(), 1e-12),
+		"testColumnMajorMatchesRowMajor failed!");
+	BOOST_CHECK_MESSAGE(b_col.transpose() == b.transpose()
+		and b_col.transpose().layout() == Layout::ColumnMajor,
+		"testColumnMajorMatchesRowMajor failed!");
+
+	Matrix resized{b_col};
+	Matrix expected{b};
+	resized.resize(23, 5);
+	expected.resize(23, 5);
+	BOOST_CHECK_MESSAGE(resized == expected
+		and resized.layout() == Layout::ColumnMajor,
+		"testColumnMajorMatchesRowMajor failed!");
+}
+
+BOOST_AUTO_TEST_CASE(testToLayout)
+{
+	BOOST_TEST_MESSAGE("testToLayout");
+
+	const Matrix row_major = filled(5, 3);
+	const Matrix same = row_major.toLayout(Layout::RowMajor);
+	const Matrix converted = row_major.toLayout(Layout::ColumnMajor);
+
+	BOOST_CHECK_MESSAGE(same.data() == row_major.data(),
+		"testToLayout failed!");
+	BOOST_CHECK_MESSAGE(converted.layout() == Layout::ColumnMajor
+		and converted == row_major and converted.data()[1] == row_major(2, 1),
+		"testToLayout failed!");
+
+	// Storage shared by `toLayout()` is copied before either side writes.
+	Matrix writable = row_major.toLayout(Layout::RowMajor);
+	writable(1, 1) = 100.0;
+	BOOST_CHECK_MESSAGE(row_major(1, 1) != 100.0, "testToLayout failed!");
+}
@@ -0,0 +1,181 @@
+#define BOOST_TEST_MODULE PackedMatrixPublicTest
+#include <boost/test/unit_test.hpp>
+
+#include "src/Matrix.hpp"
+#include "src/PackedMatrix.hpp"
+#include "src/Parallel.hpp"
+#include "src/Reductions.hpp"
+#include "tests/TestHelpers.hpp"
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+
+/**
+ * @brief Return a well-conditioned triangular Matrix, zeroes included.
+ */
+Matrix triangular(size_t n, Triangle triangle, double seed)
+{
+	Matrix mat = testMatrix(n, n, seed);
+	for (size_t row = 1; row <= n; ++row)
+	{
+		for (size_t col = 1; col <= n; ++col)
+		{
+			const bool keep = triangle == Triangle::Lower ? row >= col
+														  : row <= col;
+			if (not keep) mat(row, col) = 0.0;
+		}
+		mat(row, row) = 2.0 + std::abs(mat(row, row));
+	}
+	return mat;
+}
+
+const std::vector<size_t> sizes{1, 5, 31, 32, 33, 70, 97};
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(testLayoutIsCompact)
+{
+	BOOST_TEST_MESSAGE("testLayoutIsCompact");
+
+	for (size_t n : sizes)
+	{
+		const PackedTriangle storage{n};
+		BOOST_CHECK_MESSAGE(storage.numStored() == n * (n + 1) / 2,
+			"testLayoutIsCompact failed!");
+
+		// Every lower-triangle element gets its own slot.
+		std::vector<int> hits(storage.numStored(), 0);
+		for (size_t row = 0; row != n; ++row)
+		{
+			for (size_t col = 0; col <= row; ++col)
+			{
+				const size_t offset = storage.offset(row, col);
+				BOOST_REQUIRE(offset < hits.size());
+				++hits[offset];
+			}
+		}
+		bool all_once = true;
+		for (int hit : hits) all_once = all_once and hit == 1;
+		BOOST_CHECK_MESSAGE(all_once, "testLayoutIsCompact failed!");
+	}
+}
+
+BOOST_AUTO_TEST_CASE(testSymmetricAccessAndConversion)
+{
+	BOOST_TEST_MESSAGE("testSymmetricAccessAndConversion");
+
+	for (size_t n : sizes)
+	{
+		const Matrix root = testMatrix(n, n, 1.0);
+		const Matrix dense = root + root.transpose();
+
+		const SymmetricMatrix packed = SymmetricMatrix::fromDense(dense);
+		BOOST_CHECK_MESSAGE(packed.toDense() == dense,
+			"testSymmetricAccessAndConversion failed!");
+		BOOST_CHECK_MESSAGE(packed(1, n) == dense(n, 1),
+			"testSymmetricAccessAndConversion failed!");
+	}
+
+	SymmetricMatrix sym{3};
+	sym(1, 3) = 4.0;
+	BOOST_CHECK_MESSAGE(sym(3, 1) == 4.0,
+		"testSymmetricAccessAndConversion failed!");
+	BOOST_CHECK_THROW(sym(0, 1), std::runtime_error);
+	BOOST_CHECK_THROW(sym(4, 1), std::runtime_error);
+	BOOST_CHECK_THROW(SymmetricMatrix::fromDense(Matrix(2, 3)),
+		std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(testSymmetricMultiply)
+{
+	BOOST_TEST_MESSAGE("testSymmetricMultiply");
+
+	for (size_t threads : {1, 3})
+	{
+		parallel::setNumThreads(threads);
+		for (size_t n : sizes)
+		{
+			const Matrix root = testMatrix(n, n, 2.0);
+			const Matrix dense = root + root.transpose();
+			const SymmetricMatrix packed = SymmetricMatrix::fromDense(dense);
+
+			for (size_t cols : {1, 7, 80})
+			{
+				const Matrix rhs = testMatrix(n, cols, 3.0);
+				BOOST_CHECK_MESSAGE(reductions::isApprox(packed * rhs,
+					dense * rhs, 1e-12 * n), "testSymmetricMultiply failed!");
+			}
+		}
+	}
+	parallel::setNumThreads(0);
+
+	BOOST_CHECK_THROW(SymmetricMatrix{3} * Matrix(2, 2), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(testTriangularAccessAndConversion)
+{
+	BOOST_TEST_MESSAGE("testTriangularAccessAndConversion");
+
+	for (Triangle triangle : {Triangle::Lower, Triangle::Upper})
+	{
+		for (size_t n : sizes)
+		{
+			const Matrix dense = triangular(n, triangle, 1.0);
+			const TriangularMatrix packed =
+				TriangularMatrix::fromDense(dense, triangle);
+
+			BOOST_CHECK_MESSAGE(packed.toDense() == dense,
+				"testTriangularAccessAndConversion failed!");
+			BOOST_CHECK_MESSAGE(packed.transpose().toDense()
+				== dense.transpose(),
+				"testTriangularAccessAndConversion failed!");
+		}
+	}
+
+	TriangularMatrix lower{3, Triangle::Lower};
+	lower(3, 1) = 2.0;
+	const TriangularMatrix& view = lower;
+	BOOST_CHECK_MESSAGE(view(3, 1) == 2.0 and view(1, 3) == 0.0,
+		"testTriangularAccessAndConversion failed!");
+	BOOST_CHECK_THROW(lower(1, 3) = 1.0, std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(testTriangularMultiplyAndSolve)
+{
+	BOOST_TEST_MESSAGE("testTriangularMultiplyAndSolve");
+
+	for (size_t threads : {1, 3})
+	{
+		parallel::setNumThreads(threads);
+		for (Triangle triangle : {Triangle::Lower, Triangle::Upper})
+		{
+			for (size_t n : sizes)
+			{
+				const Matrix dense = triangular(n, triangle, 4.0);
+				const TriangularMatrix packed =
+					TriangularMatrix::fromDense(dense, triangle);
+
+				for (size_t cols : {1, 7, 80})
+				{
+					const Matrix rhs = testMatrix(n, cols, 5.0);
+					BOOST_CHECK_MESSAGE(reductions::isApprox(packed * rhs,
+						dense * rhs, 1e-12 * n),
+						"testTriangularMultiplyAndSolve failed!");
+
+					const Matrix x = packed.solve(rhs);
+					BOOST_CHECK_MESSAGE(reductions::isApprox(dense * x, rhs,
+						1e-10), "testTriangularMultiplyAndSolve failed!");
+				}
+			}
+		}
+	}
+	parallel::setNumThreads(0);
+
+	TriangularMatrix singular{2, Triangle::Upper};
+	singular(1, 1) = 1.0;
+	BOOST_CHECK_THROW(singular.solve(Matrix(2, 1)), std::runtime_error);
+}
@@ -0,0 +1,197 @@
+#define BOOST_TEST_MODULE QRPublicTest
+#include <boost/test/unit_test.hpp>
+
+#include "src/Matrix.hpp"
+#include "src/Parallel.hpp"
+#include "src/QR.hpp"
+#include "src/Reductions.hpp"
+#include "tests/TestHelpers.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using reductions::isApprox;
+
+namespace
+{
+
+/**
+ * @brief Return `mat` with its columns in the order given by `permutation`.
+ */
+Matrix permuteColumns(const Matrix& mat, const std::vector<size_t>& permutation)
+{
+	Matrix permuted{mat.size().first, mat.size().second};
+	for (size_t row = 1; row <= mat.size().first; ++row)
+	{
+		for (size_t col = 1; col <= mat.size().second; ++col)
+		{
+			permuted(row, col) = mat(row, permutation[col - 1]);
+		}
+	}
+	return permuted;
+}
+
+/**
+ * @brief Return the largest magnitude of any element of `mat`.
+ */
+double maxAbs(const Matrix& mat)
+{
+	double largest = 0.0;
+	for (size_t row = 1; row <= mat.size().first; ++row)
+	{
+		for (size_t col = 1; col <= mat.size().second; ++col)
+		{
+			largest = std::max(largest, std::abs(mat(row, col)));
+		}
+	}
+	return largest;
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(testFactorization)
+{
+	BOOST_TEST_MESSAGE("testFactorization");
+
+	const std::vector<std::pair<size_t, size_t>> shapes{
+		{1, 1}, {5, 1}, {1, 5}, {7, 7}, {40, 90}, {150, 70}, {300, 33},
+		{400, 150}};
+	for (size_t num_threads : {1, 3})
+	{
+		parallel::setNumThreads(num_threads);
+		for (const auto& shape : shapes)
+		{
+			for (Layout layout : {Layout::RowMajor, Layout::ColumnMajor})
+			{
+				const size_t m = shape.first;
+				const size_t n = shape.second;
+				const Matrix a = testMatrix(m, n, 0.5 * m + n, layout);
+				const QR qr{a};
+				const Matrix q = qr.q();
+				const Matrix r = qr.r();
+				const size_t steps = std::min(m, n);
+
+				// Q has orthonormal columns, and Q * R = A * P.
+				BOOST_CHECK_MESSAGE(
+					isApprox(q.transpose() * q, identity(steps), 1e-12)
+					and isApprox(q * r, permuteColumns(a, qr.permutation()),
+								 1e-12),
+					"testFactorization failed!");
+
+				// R is upper trapezoidal with a non-increasing diagonal.
+				bool ok = r.size() == std::make_pair(steps, n);
+				for (size_t i = 1; i <= steps; ++i)
+				{
+					for (size_t j = 1; j < i; ++j) ok = ok and r(i, j) == 0.0;
+					if (i > 1)
+					{
+						ok = ok and std::abs(r(i, i))
+							<= std::abs(r(i - 1, i - 1)) * (1.0 + 1e-12);
+					}
+				}
+				BOOST_CHECK_MESSAGE(ok, "testFactorization failed!");
+			}
+		}
+	}
+	parallel::setNumThreads(0);
+}
+
+BOOST_AUTO_TEST_CASE(testLeastSquares)
+{
+	BOOST_TEST_MESSAGE("testLeastSquares");
+
+	// A square, nonsingular system has an exact solution.
+	Matrix square = testMatrix(45, 45, 2.0);
+	for (size_t i = 1; i <= 45; ++i) square(i, i) += 45.0;
+	const Matrix rhs = testMatrix(45, 3, 9.0);
+	BOOST_CHECK_MESSAGE(isApprox(QR{square}.leastSquares(rhs),
+								 square.solve(rhs), 1e-12),
+		"testLeastSquares failed!");
+
+	// Otherwise, the residual is orthogonal to the columns of A, for every
+	// right-hand side at once.
+	for (Layout layout : {Layout::RowMajor, Layout::ColumnMajor})
+	{
+		const Matrix a = testMatrix(200, 40, 1.0, layout);
+		const Matrix b = testMatrix(200, 70, 4.0, layout);
+		const Matrix x = QR{a}.leastSquares(b);
+		BOOST_CHECK_MESSAGE(x.size() == std::make_pair(size_t{40}, size_t{70})
+			and x.layout() == layout
+			and maxAbs(a.transpose() * (a * x - b)) < 1e-11,
+			"testLeastSquares failed!");
+
+		// One column at a time gives the same answer.
+		Matrix column{200, 1};
+		for (size_t row = 1; row <= 200; ++row) column(row, 1) = b(row, 5);
+		const Matrix x_5 = QR{a}.leastSquares(column);
+		bool same = true;
+		for (size_t row = 1; row <= 40; ++row)
+		{
+			same = same and std::abs(x_5(row, 1) - x(row, 5)) < 1e-12;
+		}
+		BOOST_CHECK_MESSAGE(same, "testLeastSquares failed!");
+	}
+
+	BOOST_CHECK_THROW(QR{square}.leastSquares(testMatrix(44, 1, 0.0)),
+					  std::runtime_error);
+	BOOST_CHECK_THROW(QR{Matrix{}}, std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(testIllConditioned)
+{
+	BOOST_TEST_MESSAGE("testIllConditioned");
+
+	// A polynomial fit in the monomial basis, whose condition number is
+	// around 1e9: the normal equations would square that and lose the
+	// answer entirely.
+	const size_t m = 100;
+	const size_t n = 10;
+	Matrix vandermonde{m, n};
+	for (size_t row = 1; row <= m; ++row)
+	{
+		const double t = static_cast<double>(row) / m;
+		for (size_t col = 1; col <= n; ++col)
+		{
+			vandermonde(row, col) = std::pow(t, static_cast<double>(col - 1));
+		}
+	}
+	Matrix coefficients{n, 1};
+	for (size_t i = 1; i <= n; ++i) coefficients(i, 1) = 1.0 / i;
+
+	const QR qr{vandermonde};
+	const Matrix x = qr.leastSquares(vandermonde * coefficients);
+	BOOST_CHECK_MESSAGE(qr.rank() == n
+		and isApprox(x, coefficients, 1e-5),
+		"testIllConditioned failed!");
+}
+
+BOOST_AUTO_TEST_CASE(testRankDeficient)
+{
+	BOOST_TEST_MESSAGE("testRankDeficient");
+
+	// A rank-5 matrix with more columns than a block of reflectors.
+	const Matrix a = testMatrix(60, 5, 3.0) * testMatrix(5, 48, 7.0);
+	const QR qr{a};
+	BOOST_CHECK_MESSAGE(qr.rank() == 5 and qr.rank(0.0) > 5,
+		"testRankDeficient failed!");
+
+	// A consistent system is still solved exactly, by a solution that only
+	// uses the pivot columns.
+	const Matrix b = a * testMatrix(48, 2, 5.0);
+	const Matrix x = qr.leastSquares(b);
+	size_t nonzero_rows = 0;
+	for (size_t row = 1; row <= 48; ++row)
+	{
+		if (x(row, 1) != 0.0 or x(row, 2) != 0.0) ++nonzero_rows;
+	}
+	BOOST_CHECK_MESSAGE(maxAbs(a * x - b) < 1e-10 and nonzero_rows == 5,
+		"testRankDeficient failed!");
+
+	const QR zero{Matrix{8, 3}};
+	BOOST_CHECK_MESSAGE(zero.rank() == 0
+		and maxAbs(zero.leastSquares(testMatrix(8, 2, 0.0))) == 0.0,
+		"testRankDeficient failed!");
+}
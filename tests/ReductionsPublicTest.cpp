@@ -0,0 +1,300 @@
+#define BOOST_TEST_MODULE ReductionsPublicTest
+#include <boost/test/unit_test.hpp>
+
+#include "src/Matrix.hpp"
+#include "src/Parallel.hpp"
+#include "src/Reductions.hpp"
+#include "tests/TestHelpers.hpp"
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+using reductions::Tolerance;
+
+namespace
+{
+
+bool closeTo(double lhs, double rhs, double tolerance = 1e-12)
+{
+	return std::abs(lhs - rhs) <= tolerance * (1.0 + std::abs(rhs));
+}
+
+/**
+ * @brief Run `check` with one thread, then with several.
+ */
+template <typename Check>
+void withThreadCounts(Check check)
+{
+	for (size_t threads : {1, 4})
+	{
+		parallel::setNumThreads(threads);
+		check();
+	}
+	parallel::setNumThreads(0);
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(testSmallReductions)
+{
+	BOOST_TEST_MESSAGE("testSmallReductions");
+
+	Matrix mat{2, 3};
+	mat(1, 1) = 1; mat(1, 2) = -2; mat(1, 3) = 3;
+	mat(2, 1) = -4; mat(2, 2) = 5; mat(2, 3) = -6;
+
+	BOOST_CHECK_MESSAGE(reductions::sum(mat) == -3.0,
+		"testSmallReductions failed!");
+	BOOST_CHECK_MESSAGE(reductions::dot(mat, mat) == 91.0,
+		"testSmallReductions failed!");
+	BOOST_CHECK_MESSAGE(closeTo(reductions::frobeniusNorm(mat), std::sqrt(91.0)),
+		"testSmallReductions failed!");
+	BOOST_CHECK_MESSAGE(reductions::oneNorm(mat) == 9.0,
+		"testSmallReductions failed!");
+	BOOST_CHECK_MESSAGE(reductions::infNorm(mat) == 15.0,
+		"testSmallReductions failed!");
+	BOOST_CHECK_MESSAGE(reductions::minCoeff(mat) == -6.0,
+		"testSmallReductions failed!");
+	BOOST_CHECK_MESSAGE(reductions::maxCoeff(mat) == 5.0,
+		"testSmallReductions failed!");
+	BOOST_CHECK_MESSAGE((reductions::argMax(mat) == std::make_pair<size_t, size_t>(2, 2)),
+		"testSmallReductions failed!");
+
+	// The same values in column-major storage.
+	const Matrix col_major = mat.toLayout(Layout::ColumnMajor);
+	BOOST_CHECK_MESSAGE(reductions::oneNorm(col_major) == 9.0
+		and reductions::infNorm(col_major) == 15.0
+		and reductions::dot(col_major, mat) == 91.0,
+		"testSmallReductions failed!");
+	BOOST_CHECK_MESSAGE((reductions::argMax(col_major) == std::make_pair<size_t, size_t>(2, 2)),
+		"testSmallReductions failed!");
+	BOOST_CHECK_MESSAGE(reductions::isApprox(col_major, mat, 0.0),
+		"testSmallReductions failed!");
+
+	BOOST_CHECK_THROW(reductions::trace(mat), std::runtime_error);
+	BOOST_CHECK_THROW(reductions::maxCoeff(Matrix(0, 3)), std::runtime_error);
+	BOOST_CHECK_THROW(reductions::dot(mat, Matrix(3, 2)), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(testTrace)
+{
+	BOOST_TEST_MESSAGE("testTrace");
+
+	Matrix mat = testMatrix(5, 5, 0.0);
+	double expected = 0.0;
+	for (size_t i = 1; i <= 5; ++i) expected += mat(i, i);
+
+	BOOST_CHECK_MESSAGE(closeTo(reductions::trace(mat), expected),
+		"testTrace failed!");
+}
+
+BOOST_AUTO_TEST_CASE(testFrobeniusNormExtremeMagnitudes)
+{
+	BOOST_TEST_MESSAGE("testFrobeniusNormExtremeMagnitudes");
+
+	// The squares of these overflow or underflow, but the norm doesn't.
+	withThreadCounts([] {
+		for (size_t n : {3, 300})
+		{
+			const Matrix base = testMatrix(n, n, 0.0);
+			const double base_norm = reductions::frobeniusNorm(base);
+			for (double magnitude : {1e-320, 1e-300, 1e-160, 1e160, 1e300})
+			{
+				Matrix mat{base};
+				double* vals = mat.data();
+				for (size_t i = 0; i != n * n; ++i) vals[i] *= magnitude;
+
+				// Subnormal elements only keep a few digits themselves.
+				const double tolerance = magnitude < 1e-300 ? 1e-3 : 1e-13;
+				const double expected = base_norm * magnitude;
+				BOOST_CHECK_MESSAGE(std::abs(reductions::frobeniusNorm(mat)
+					- expected) <= tolerance * expected,
+					"testFrobeniusNormExtremeMagnitudes failed! (" << n << ", "
+					<< magnitude << ")");
+			}
+		}
+	});
+
+	Matrix mat{2, 2};
+	BOOST_CHECK_MESSAGE(reductions::frobeniusNorm(mat) == 0.0,
+		"testFrobeniusNormExtremeMagnitudes failed!");
+	mat(1, 2) = 3e300;
+	mat(2, 1) = -4e300;
+	BOOST_CHECK_MESSAGE(closeTo(reductions::frobeniusNorm(mat) / 1e300, 5.0),
+		"testFrobeniusNormExtremeMagnitudes failed!");
+	mat(2, 2) = HUGE_VAL;
+	BOOST_CHECK_MESSAGE(std::isinf(reductions::frobeniusNorm(mat)),
+		"testFrobeniusNormExtremeMagnitudes failed!");
+	mat(1, 1) = std::numeric_limits<double>::quiet_NaN();
+	BOOST_CHECK_MESSAGE(std::isnan(reductions::frobeniusNorm(mat)),
+		"testFrobeniusNormExtremeMagnitudes failed!");
+}
+
+BOOST_AUTO_TEST_CASE(testLargeReductionsMatchReference)
+{
+	BOOST_TEST_MESSAGE("testLargeReductionsMatchReference");
+
+	// Big enough to be split into blocks and across threads, with a tail.
+	const size_t rows = 301;
+	const size_t cols = 517;
+	const Matrix mat = testMatrix(rows, cols, 0.0);
+
+	long double sum = 0.0;
+	long double squares = 0.0;
+	double max = -1.0;
+	double one_norm = 0.0;
+	double inf_norm = 0.0;
+	for (size_t row = 1; row <= rows; ++row)
+	{
+		double row_sum = 0.0;
+		for (size_t col = 1; col <= cols; ++col)
+		{
+			sum += mat(row, col);
+			squares += mat(row, col) * mat(row, col);
+			max = std::max(max, mat(row, col));
+			row_sum += std::abs(mat(row, col));
+		}
+		inf_norm = std::max(inf_norm, row_sum);
+	}
+	for (size_t col = 1; col <= cols; ++col)
+	{
+		double col_sum = 0.0;
+		for (size_t row = 1; row <= rows; ++row) col_sum += std::abs(mat(row, col));
+		one_norm = std::max(one_norm, col_sum);
+	}
+
+	withThreadCounts([&]{
+		BOOST_CHECK_MESSAGE(closeTo(reductions::sum(mat), sum),
+			"testLargeReductionsMatchReference failed!");
+		BOOST_CHECK_MESSAGE(closeTo(reductions::dot(mat, mat), squares),
+			"testLargeReductionsMatchReference failed!");
+		BOOST_CHECK_MESSAGE(closeTo(reductions::oneNorm(mat), one_norm),
+			"testLargeReductionsMatchReference failed!");
+		BOOST_CHECK_MESSAGE(closeTo(reductions::infNorm(mat), inf_norm),
+			"testLargeReductionsMatchReference failed!");
+		BOOST_CHECK_MESSAGE(reductions::maxCoeff(mat) == max,
+			"testLargeReductionsMatchReference failed!");
+
+		const auto where = reductions::argMax(mat);
+		BOOST_CHECK_MESSAGE(mat(where.first, where.second) == max,
+			"testLargeReductionsMatchReference failed!");
+	});
+}
+
+BOOST_AUTO_TEST_CASE(testNanCoefficients)
+{
+	BOOST_TEST_MESSAGE("testNanCoefficients");
+
+	const double nan = std::numeric_limits<double>::quiet_NaN();
+
+	// Wherever the NaN is, it's both the minimum and the maximum, and
+	// `argMax` finds it.
+	for (size_t row = 1; row <= 2; ++row)
+	{
+		for (size_t col = 1; col <= 2; ++col)
+		{
+			Matrix mat{2, 2};
+			mat(1, 1) = 1.0; mat(1, 2) = 5.0;
+			mat(2, 1) = -3.0; mat(2, 2) = 2.0;
+			mat(row, col) = nan;
+			for (Layout layout : {Layout::RowMajor, Layout::ColumnMajor})
+			{
+				const Matrix stored = mat.toLayout(layout);
+				BOOST_CHECK_MESSAGE(std::isnan(reductions::minCoeff(stored))
+					and std::isnan(reductions::maxCoeff(stored))
+					and reductions::argMax(stored) == std::make_pair(row, col),
+					"testNanCoefficients failed! (" << row << ", " << col << ")");
+			}
+		}
+	}
+
+	// Across blocks and threads, with larger values before and after it.
+	withThreadCounts([nan] {
+		Matrix mat = testMatrix(301, 517, 0.0);
+		mat(1, 1) = 10.0;
+		mat(300, 2) = nan;
+		mat(300, 400) = nan;
+		mat(301, 517) = 20.0;
+		BOOST_CHECK_MESSAGE(std::isnan(reductions::minCoeff(mat))
+			and std::isnan(reductions::maxCoeff(mat))
+			and (reductions::argMax(mat) == std::make_pair<size_t, size_t>(300, 2)),
+			"testNanCoefficients failed!");
+	});
+}
+
+BOOST_AUTO_TEST_CASE(testCompensatedSummation)
+{
+	BOOST_TEST_MESSAGE("testCompensatedSummation");
+
+	// One huge element followed by many tiny ones: naive left-to-right
+	// summation loses every one of the tiny ones.
+	const size_t n = 100000;
+	Matrix mat{n, 1};
+	mat(1, 1) = 1e16;
+	for (size_t i = 2; i <= n; ++i) mat(i, 1) = 1.0;
+
+	BOOST_CHECK_MESSAGE(reductions::sum(mat) == 1e16 + (n - 1),
+		"testCompensatedSummation failed!");
+}
+
+BOOST_AUTO_TEST_CASE(testIsApprox)
+{
+	BOOST_TEST_MESSAGE("testIsApprox");
+
+	const Matrix a = testMatrix(40, 40, 0.0);
+	Matrix b{a};
+	b(40, 40) += 1e-9;
+
+	BOOST_CHECK_MESSAGE(reductions::isApprox(a, b, 1e-8),
+		"testIsApprox failed!");
+	BOOST_CHECK_MESSAGE(not reductions::isApprox(a, b, 1e-10),
+		"testIsApprox failed!");
+	BOOST_CHECK_MESSAGE(not reductions::isApprox(a, Matrix(40, 39), 1.0),
+		"testIsApprox failed!");
+
+	// Relative mode scales with the magnitude of the elements.
+	Matrix big{1, 1};
+	big(1, 1) = 1e6;
+	Matrix bigger{1, 1};
+	bigger(1, 1) = 1e6 + 1e-3;
+	BOOST_CHECK_MESSAGE(reductions::isApprox(big, bigger, 1e-8, Tolerance::Relative),
+		"testIsApprox failed!");
+	BOOST_CHECK_MESSAGE(not reductions::isApprox(big, bigger, 1e-8),
+		"testIsApprox failed!");
+
+	// ULP mode counts representable doubles.
+	Matrix next{1, 1};
+	next(1, 1) = std::nextafter(std::nextafter(1e6, 2e6), 2e6);
+	BOOST_CHECK_MESSAGE(reductions::isApprox(big, next, 2, Tolerance::Ulp),
+		"testIsApprox failed!");
+	BOOST_CHECK_MESSAGE(not reductions::isApprox(big, next, 1, Tolerance::Ulp),
+		"testIsApprox failed!");
+
+	Matrix zero{1, 1};
+	Matrix negative_zero{1, 1};
+	negative_zero(1, 1) = -0.0;
+	BOOST_CHECK_MESSAGE(reductions::isApprox(zero, negative_zero, 0, Tolerance::Ulp),
+		"testIsApprox failed!");
+
+	Matrix nan{1, 1};
+	nan(1, 1) = std::numeric_limits<double>::quiet_NaN();
+	BOOST_CHECK_MESSAGE(not reductions::isApprox(nan, nan, 1.0),
+		"testIsApprox failed!");
+}
+
+BOOST_AUTO_TEST_CASE(testIsApproxInParallel)
+{
+	BOOST_TEST_MESSAGE("testIsApproxInParallel");
+
+	const Matrix a = testMatrix(600, 300, 0.0);
+	Matrix b{a};
+	b(599, 123) += 1.0;
+
+	withThreadCounts([&]{
+		BOOST_CHECK_MESSAGE(reductions::isApprox(a, a, 0.0),
+			"testIsApproxInParallel failed!");
+		BOOST_CHECK_MESSAGE(not reductions::isApprox(a, b, 1e-3),
+			"testIsApproxInParallel failed!");
+	});
+}
@@ -0,0 +1,300 @@
+#define BOOST_TEST_MODULE SharedMemoryPublicTest
+#include <boost/test/unit_test.hpp>
+
+#include "src/Array2D.hpp"
+#include "src/Matrix.hpp"
+#include "src/SharedMemory.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+using shm::Publisher;
+using shm::Subscriber;
+
+namespace
+{
+
+/**
+ * @brief Return a channel name that no other test run is using.
+ */
+std::string channelName(const char* test)
+{
+	return "/mle-" + std::string{test} + "-" + std::to_string(getpid());
+}
+
+/**
+ * @brief Fill `array` with values that depend on `seed`.
+ */
+void fill(Array2D& array, double seed)
+{
+	double* vals = array.data();
+	const size_t n = array.size().first * array.size().second;
+	for (size_t i = 0; i != n; ++i) vals[i] = seed + std::sin(0.1 * i);
+}
+
+bool holds(const Array2D& array, double seed)
+{
+	const double* vals = array.data();
+	const size_t n = array.size().first * array.size().second;
+	for (size_t i = 0; i != n; ++i)
+	{
+		if (vals[i] != seed + std::sin(0.1 * i)) return false;
+	}
+	return true;
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(testWrappedStorage)
+{
+	BOOST_TEST_MESSAGE("testWrappedStorage");
+
+	// The owner's deleter runs once the last Array2D using it is gone.
+	bool released = false;
+	Array2D storage{4, 4};
+	std::shared_ptr<void> owner{storage.data(), [&](void*) {
+		released = true;
+	}};
+
+	{
+		Array2D wrapped = Array2D::wrap(storage.data(), 2, 8, Layout::ColumnMajor,
+										owner);
+		owner.reset();
+		wrapped(1, 3) = 5.0;
+		BOOST_CHECK_MESSAGE(storage[7] == 5.0 and not released,
+			"testWrappedStorage failed!");
+
+		// Copies don't share the storage; moves do.
+		Array2D copy{wrapped};
+		copy(1, 3) = 6.0;
+		Array2D moved{std::move(wrapped)};
+		BOOST_CHECK_MESSAGE(storage[7] == 5.0 and moved.data() == storage.data()
+			and moved.layout() == Layout::ColumnMajor and not released,
+			"testWrappedStorage failed!");
+	}
+	BOOST_CHECK_MESSAGE(released, "testWrappedStorage failed!");
+
+	BOOST_CHECK_THROW(Array2D::wrap(storage.data() + 1, 1, 1, Layout::RowMajor,
+									std::make_shared<int>()),
+					  std::runtime_error);
+	BOOST_CHECK_THROW(Array2D::wrap(storage.data(), 1, 1, Layout::RowMajor,
+									nullptr),
+					  std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(testPublishAndReceive)
+{
+	BOOST_TEST_MESSAGE("testPublishAndReceive");
+
+	const std::string name = channelName("basic");
+	Publisher publisher{name, 4, 6 * 7};
+	Subscriber first{name};
+	BOOST_CHECK_MESSAGE(not first.tryReceive(), "testPublishAndReceive failed!");
+
+	// Fill a slot in place...
+	Array2D* slot = publisher.tryAcquire(6, 7, Layout::ColumnMajor);
+	BOOST_REQUIRE(slot);
+	fill(*slot, 1.0);
+	publisher.publish();
+
+	// ...or copy into one.
+	Matrix mat{3, 2};
+	mat(3, 2) = 8.0;
+	BOOST_CHECK_MESSAGE(publisher.tryPublish(mat),
+		"testPublishAndReceive failed!");
+	BOOST_CHECK_MESSAGE(publisher.published() == 2,
+		"testPublishAndReceive failed!");
+
+	// A subscriber that opens the channel late still gets what's in the ring.
+	Subscriber second{name};
+	for (Subscriber* subscriber : {&first, &second})
+	{
+		std::shared_ptr<const Array2D> message = subscriber->tryReceive();
+		BOOST_REQUIRE(message);
+		BOOST_CHECK_MESSAGE(message->size() == std::make_pair(size_t{6}, size_t{7})
+			and message->layout() == Layout::ColumnMajor and holds(*message, 1.0),
+			"testPublishAndReceive failed!");
+
+		message = subscriber->tryReceive();
+		BOOST_REQUIRE(message);
+		BOOST_CHECK_MESSAGE(message->size() == std::make_pair(size_t{3}, size_t{2})
+			and (*message)(2, 1) == 8.0 and (*message)(0, 0) == 0.0,
+			"testPublishAndReceive failed!");
+
+		BOOST_CHECK_MESSAGE(not subscriber->tryReceive()
+			and subscriber->dropped() == 0,
+			"testPublishAndReceive failed!");
+	}
+
+	// Copies of a message are ordinary, writable arrays.
+	slot = publisher.tryAcquire(1, 1);
+	BOOST_REQUIRE(slot);
+	(*slot)(0, 0) = 3.0;
+	publisher.publish();
+	Array2D copy{*first.receive(std::chrono::microseconds{1000})};
+	copy(0, 0) = 4.0;
+	BOOST_CHECK_MESSAGE(not first.receive(std::chrono::microseconds{100}),
+		"testPublishAndReceive failed!");
+
+	BOOST_CHECK_THROW(publisher.tryAcquire(7, 7), std::runtime_error);
+	BOOST_CHECK_THROW(publisher.publish(), std::runtime_error);
+	BOOST_CHECK_THROW(Subscriber{channelName("missing")}, std::runtime_error);
+	BOOST_CHECK_THROW(Publisher(channelName("empty"), 0, 1), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(testSlowSubscriber)
+{
+	BOOST_TEST_MESSAGE("testSlowSubscriber");
+
+	const std::string name = channelName("slow");
+	Publisher publisher{name, 3, 4};
+	Subscriber subscriber{name};
+
+	// Lap the subscriber: it should skip to the oldest message left.
+	Array2D message{2, 2};
+	for (int i = 1; i <= 10; ++i)
+	{
+		fill(message, i);
+		BOOST_REQUIRE(publisher.tryPublish(message));
+	}
+	for (int i = 8; i <= 10; ++i)
+	{
+		std::shared_ptr<const Array2D> received = subscriber.tryReceive();
+		BOOST_REQUIRE(received);
+		BOOST_CHECK_MESSAGE(holds(*received, i), "testSlowSubscriber failed!");
+	}
+	BOOST_CHECK_MESSAGE(subscriber.dropped() == 7, "testSlowSubscriber failed!");
+}
+
+BOOST_AUTO_TEST_CASE(testHeldMessagesArentOverwritten)
+{
+	BOOST_TEST_MESSAGE("testHeldMessagesArentOverwritten");
+
+	const std::string name = channelName("held");
+	Publisher publisher{name, 2, 4};
+	Subscriber subscriber{name};
+
+	Array2D message{2, 2};
+	fill(message, 1.0);
+	BOOST_REQUIRE(publisher.tryPublish(message));
+	const std::shared_ptr<const Array2D> held = subscriber.tryReceive();
+	BOOST_REQUIRE(held);
+
+	// The publisher goes around the held slot...
+	for (int i = 2; i <= 6; ++i)
+	{
+		fill(message, i);
+		BOOST_REQUIRE(publisher.tryPublish(message));
+		BOOST_CHECK_MESSAGE(holds(*held, 1.0),
+			"testHeldMessagesArentOverwritten failed!");
+	}
+
+	// ...and subscribers only miss what was overwritten in the other one.
+	std::shared_ptr<const Array2D> received = subscriber.tryReceive();
+	BOOST_REQUIRE(received);
+	BOOST_CHECK_MESSAGE(holds(*received, 6.0) and not subscriber.tryReceive(),
+		"testHeldMessagesArentOverwritten failed!");
+
+	// With every slot held, there's nowhere to publish.
+	BOOST_CHECK_MESSAGE(not publisher.tryPublish(message),
+		"testHeldMessagesArentOverwritten failed!");
+	received.reset();
+	BOOST_CHECK_MESSAGE(publisher.tryPublish(message),
+		"testHeldMessagesArentOverwritten failed!");
+}
+
+BOOST_AUTO_TEST_CASE(testFailedPublishesArentDrops)
+{
+	BOOST_TEST_MESSAGE("testFailedPublishesArentDrops");
+
+	const std::string name = channelName("failed");
+	Publisher publisher{name, 2, 4};
+	Subscriber subscriber{name};
+
+	Array2D message{2, 2};
+	std::vector<std::shared_ptr<const Array2D>> held;
+	for (int i = 1; i <= 2; ++i)
+	{
+		fill(message, i);
+		BOOST_REQUIRE(publisher.tryPublish(message));
+		held.push_back(subscriber.tryReceive());
+		BOOST_REQUIRE(held.back());
+	}
+
+	// Every slot is held, so these fail without using up anything...
+	for (int attempt = 0; attempt != 3; ++attempt)
+	{
+		BOOST_CHECK_MESSAGE(not publisher.tryPublish(message),
+			"testFailedPublishesArentDrops failed!");
+	}
+
+	// ...and the next message follows straight on from the last one.
+	held.clear();
+	fill(message, 3.0);
+	BOOST_REQUIRE(publisher.tryPublish(message));
+	std::shared_ptr<const Array2D> received = subscriber.tryReceive();
+	BOOST_REQUIRE(received);
+	BOOST_CHECK_MESSAGE(holds(*received, 3.0) and subscriber.dropped() == 0,
+		"testFailedPublishesArentDrops failed! (" << subscriber.dropped()
+		<< " dropped)");
+}
+
+BOOST_AUTO_TEST_CASE(testAcrossProcesses)
+{
+	BOOST_TEST_MESSAGE("testAcrossProcesses");
+
+	const std::string name = channelName("fork");
+	const int num_messages = 200;
+	Publisher publisher{name, 8, 64 * 64};
+
+	const pid_t child = fork();
+	BOOST_REQUIRE(child >= 0);
+	if (child == 0)
+	{
+		// Receive until the last message, checking that every message is
+		// intact and that they arrive in order.
+		int status = 1;
+		try
+		{
+			Subscriber subscriber{name};
+			double last = 0.0;
+			while (last != num_messages)
+			{
+				std::shared_ptr<const Array2D> message =
+					subscriber.receive(std::chrono::seconds{10});
+				if (not message) break;
+
+				const double seed = (*message)(0, 0);
+				if (seed <= last or not holds(*message, seed)) break;
+				last = seed;
+			}
+			if (last == num_messages) status = 0;
+		}
+		catch (...)
+		{
+		}
+		_exit(status);
+	}
+
+	for (int i = 1; i <= num_messages; ++i)
+	{
+		Array2D* slot = nullptr;
+		while (not (slot = publisher.tryAcquire(64, 64)))
+		{
+		}
+		fill(*slot, i);
+		publisher.publish();
+	}
+
+	int status = 0;
+	BOOST_REQUIRE(waitpid(child, &status, 0) == child);
+	BOOST_CHECK_MESSAGE(WIFEXITED(status) and WEXITSTATUS(status) == 0,
+		"testAcrossProcesses failed!");
+}
@@ -0,0 +1,178 @@
+#define BOOST_TEST_MODULE SymmetricPublicTest
+#include <boost/test/unit_test.hpp>
+
+#include "src/Matrix.hpp"
+#include "src/Parallel.hpp"
+#include "src/Reductions.hpp"
+#include "src/Symmetric.hpp"
+#include "tests/TestHelpers.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+
+using reductions::Tolerance;
+
+namespace
+{
+
+/**
+ * @brief The number of times the global `operator new` has been called.
+ */
+std::atomic<size_t> num_allocations{0};
+
+/**
+ * @brief Return a symmetric positive-definite `n x n` Matrix.
+ */
+Matrix covariance(size_t n, double seed)
+{
+	const Matrix root = testMatrix(n, n, seed);
+	Matrix cov = root * root.transpose();
+	for (size_t i = 1; i <= n; ++i) cov(i, i) += 1.0;
+	return cov;
+}
+
+bool isSymmetric(const Matrix& mat)
+{
+	return mat == mat.transpose();
+}
+
+} // anonymous namespace
+
+void* operator new(size_t size)
+{
+	++num_allocations;
+	void* storage = std::malloc(size > 0 ? size : 1);
+	if (storage == nullptr) throw std::bad_alloc{};
+	return storage;
+}
+
+void operator delete(void* storage) noexcept
+{
+	std::free(storage);
+}
+
+void operator delete(void* storage, size_t) noexcept
+{
+	std::free(storage);
+}
+
+BOOST_AUTO_TEST_CASE(testRankK)
+{
+	BOOST_TEST_MESSAGE("testRankK");
+
+	symmetric::Workspace work;
+	for (size_t n : {1, 5, 64, 130})
+	{
+		const Matrix a = testMatrix(n, 7, 1.0);
+		const Matrix c = covariance(n, 2.0);
+		const Matrix expected = (a * a.transpose()) / 0.5 + c / 2.0;
+
+		Matrix out{c};
+		symmetric::rankK(a, out, work, 2.0, 0.5);
+
+		BOOST_CHECK_MESSAGE(reductions::isApprox(out, expected, 1e-12,
+			Tolerance::Relative) or reductions::isApprox(out, expected, 1e-11),
+			"testRankK failed!");
+		BOOST_CHECK_MESSAGE(isSymmetric(out), "testRankK failed!");
+	}
+}
+
+BOOST_AUTO_TEST_CASE(testSandwichPositiveDefinite)
+{
+	BOOST_TEST_MESSAGE("testSandwichPositiveDefinite");
+
+	symmetric::Workspace work;
+	for (size_t threads : {1, 3})
+	{
+		parallel::setNumThreads(threads);
+		for (size_t n : {1, 4, 65, 150})
+		{
+			const Matrix a = testMatrix(n, n, 3.0);
+			const Matrix p = covariance(n, 4.0);
+			const Matrix q = covariance(n, 5.0);
+			const Matrix expected = a * p * a.transpose() + q;
+
+			Matrix out{n, n};
+			symmetric::sandwich(a, p, q, out, work);
+
+			BOOST_CHECK_MESSAGE(reductions::isApprox(out, expected,
+				1e-9 * reductions::maxCoeff(expected)),
+				"testSandwichPositiveDefinite failed!");
+			BOOST_CHECK_MESSAGE(isSymmetric(out),
+				"testSandwichPositiveDefinite failed!");
+		}
+	}
+	parallel::setNumThreads(0);
+}
+
+BOOST_AUTO_TEST_CASE(testSandwichSemiDefiniteAndInPlace)
+{
+	BOOST_TEST_MESSAGE("testSandwichSemiDefiniteAndInPlace");
+
+	// A rank-deficient P can't be Cholesky-factored, so this exercises the
+	// fallback path. A is rectangular, too.
+	const Matrix a = testMatrix(9, 6, 1.0);
+	Matrix p{6, 6};
+	p(1, 1) = 2.0;
+	p(2, 2) = 1.0;
+	p(1, 2) = p(2, 1) = 0.5;
+
+	Matrix out = covariance(9, 2.0);
+	const Matrix expected = a * p * a.transpose() + out;
+
+	symmetric::Workspace work;
+	symmetric::sandwich(a, p, out, out, work);
+
+	BOOST_CHECK_MESSAGE(reductions::isApprox(out, expected, 1e-10),
+		"testSandwichSemiDefiniteAndInPlace failed!");
+	BOOST_CHECK_MESSAGE(isSymmetric(out),
+		"testSandwichSemiDefiniteAndInPlace failed!");
+}
+
+BOOST_AUTO_TEST_CASE(testSandwichChecksSizes)
+{
+	BOOST_TEST_MESSAGE("testSandwichChecksSizes");
+
+	const Matrix a = testMatrix(3, 2, 1.0);
+	const Matrix p = covariance(2, 2.0);
+	const Matrix q = covariance(3, 3.0);
+	Matrix wrong{2, 2};
+	symmetric::Workspace work;
+
+	BOOST_CHECK_THROW(symmetric::sandwich(a, p, q, wrong, work),
+		std::runtime_error);
+	BOOST_CHECK_THROW(symmetric::sandwich(a, q, q, wrong, work),
+		std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(testWarmWorkspaceDoesNotAllocate)
+{
+	BOOST_TEST_MESSAGE("testWarmWorkspaceDoesNotAllocate");
+
+	const Matrix a = testMatrix(150, 150, 3.0);
+	const Matrix p = covariance(150, 4.0);
+	const Matrix q = covariance(150, 5.0);
+	Matrix out{150, 150};
+
+	for (size_t threads : {1, 4})
+	{
+		parallel::setNumThreads(threads);
+		symmetric::Workspace work;
+
+		// The first calls size the workspace (and start the thread pool).
+		symmetric::sandwich(a, p, q, out, work);
+		symmetric::rankK(a, out, work);
+
+		const size_t before = num_allocations;
+		symmetric::sandwich(a, p, q, out, work);
+		symmetric::rankK(a, out, work, 0.5, 1.0);
+		const size_t allocated = num_allocations - before;
+
+		BOOST_CHECK_MESSAGE(allocated == 0,
+			"testWarmWorkspaceDoesNotAllocate failed! (" << allocated
+			<< " allocations with " << threads << " threads)");
+	}
+	parallel::setNumThreads(0);
+}
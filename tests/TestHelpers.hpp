@@ -0,0 +1,52 @@
+#ifndef MAAV_PROJECT_3_TEST_HELPERS_HPP
+#define MAAV_PROJECT_3_TEST_HELPERS_HPP
+
+#include "src/Array2D.hpp"
+#include "src/Matrix.hpp"
+
+#include <cmath>	// std::sin
+#include <cstdlib>	// size_t
+
+/**
+ * @addtogroup TEST_HELPERS Test Helper Functions
+ * @brief Fixtures shared by the unit tests.
+ * @{
+ */
+
+/**
+ * @brief Return a `rows x cols` Matrix of deterministic, irregular values
+ * 		in `[-1, 1]`.
+ * @detail Element `(row, col)` is `sin(seed + 0.37 * row * col + 1.13 * col)`,
+ * 		so different seeds give unrelated matrices of the same shape, and
+ * 		both layouts hold the same values. Square ones are nonsingular,
+ * 		though not necessarily well-conditioned.
+ */
+inline Matrix testMatrix(size_t rows, size_t cols, double seed,
+						 Layout layout = Layout::RowMajor)
+{
+	Matrix mat{rows, cols, layout};
+	for (size_t row = 1; row <= rows; ++row)
+	{
+		for (size_t col = 1; col <= cols; ++col)
+		{
+			mat(row, col) = std::sin(seed + 0.37 * row * col + 1.13 * col);
+		}
+	}
+	return mat;
+}
+
+/**
+ * @brief Return the `n x n` identity Matrix.
+ */
+inline Matrix identity(size_t n, Layout layout = Layout::RowMajor)
+{
+	Matrix eye{n, n, layout};
+	for (size_t i = 1; i <= n; ++i) eye(i, i) = 1.0;
+	return eye;
+}
+
+/**
+ * @}
+ */
+
+#endif
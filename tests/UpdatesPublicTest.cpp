@@ -0,0 +1,218 @@
+#define BOOST_TEST_MODULE UpdatesPublicTest
+#include <boost/test/unit_test.hpp>
+
+#include "src/Array2D.hpp"
+#include "src/Decompositions.hpp"
+#include "src/Matrix.hpp"
+#include "src/Reductions.hpp"
+#include "src/Updates.hpp"
+#include "tests/TestHelpers.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+
+/**
+ * @brief Return a well-conditioned `n x n` Matrix.
+ */
+Matrix wellConditioned(size_t n, double seed)
+{
+	Matrix mat = testMatrix(n, n, seed);
+	for (size_t i = 1; i <= n; ++i) mat(i, i) += n;
+	return mat;
+}
+
+/**
+ * @brief Return the Cholesky factor of the positive-definite `a`.
+ */
+Matrix cholesky(const Matrix& a)
+{
+	const size_t n = a.size().first;
+	Array2D factor{n, n};
+	std::copy(a.data(), a.data() + n * n, factor.data());
+	BOOST_REQUIRE(choleskyFactor(factor));
+
+	Matrix l{n, n};
+	std::copy(factor.data(), factor.data() + n * n, l.data());
+	return l;
+}
+
+bool isUpperTriangular(const Matrix& r)
+{
+	for (size_t row = 1; row <= r.size().first; ++row)
+	{
+		for (size_t col = 1; col < std::min(row, r.size().second + 1); ++col)
+		{
+			if (r(row, col) != 0.0) return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief True if `q * r` is a valid QR factorization of `a`.
+ */
+bool isQrOf(const Matrix& q, const Matrix& r, const Matrix& a)
+{
+	const size_t m = q.size().first;
+	return reductions::isApprox(q.transpose() * q, identity(m), 1e-12)
+		and isUpperTriangular(r)
+		and reductions::isApprox(q * r, a, 1e-12);
+}
+
+/**
+ * @brief Return `a` without row `row` (counting from one).
+ */
+Matrix withoutRow(const Matrix& a, size_t row)
+{
+	const size_t m = a.size().first;
+	const size_t n = a.size().second;
+	Matrix result{m - 1, n};
+	for (size_t i = 1, dest = 1; i <= m; ++i)
+	{
+		if (i == row) continue;
+		for (size_t j = 1; j <= n; ++j) result(dest, j) = a(i, j);
+		++dest;
+	}
+	return result;
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(testShermanMorrison)
+{
+	BOOST_TEST_MESSAGE("testShermanMorrison");
+
+	for (size_t n : {1, 6, 70})
+	{
+		const Matrix a = wellConditioned(n, 1.0);
+		const Matrix u = testMatrix(n, 1, 2.0);
+		const Matrix v = testMatrix(n, 1, 3.0);
+
+		Matrix inverse = a.inverse();
+		updates::shermanMorrison(inverse, u, v);
+		BOOST_CHECK_MESSAGE(reductions::isApprox(inverse,
+			(a + u * v.transpose()).inverse(), 1e-12),
+			"testShermanMorrison failed!");
+
+		// Column-major inverses are updated in their own layout.
+		Matrix col_major = a.inverse().toLayout(Layout::ColumnMajor);
+		updates::shermanMorrison(col_major, u, v);
+		BOOST_CHECK_MESSAGE(col_major.layout() == Layout::ColumnMajor
+			and reductions::isApprox(col_major, inverse, 1e-12),
+			"testShermanMorrison failed!");
+	}
+
+	// A + u * v' is singular here, so the inverse should be left alone.
+	Matrix inverse = identity(2);
+	Matrix u{2, 1};
+	Matrix v{2, 1};
+	u(1, 1) = -1.0;
+	v(1, 1) = 1.0;
+	BOOST_CHECK_THROW(updates::shermanMorrison(inverse, u, v),
+		std::runtime_error);
+	BOOST_CHECK_MESSAGE(inverse == identity(2), "testShermanMorrison failed!");
+	BOOST_CHECK_THROW(updates::shermanMorrison(inverse, Matrix(3, 1), v),
+		std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(testWoodbury)
+{
+	BOOST_TEST_MESSAGE("testWoodbury");
+
+	for (size_t n : {3, 40})
+	{
+		for (size_t k : {1, 3})
+		{
+			const Matrix a = wellConditioned(n, 4.0);
+			const Matrix u = testMatrix(n, k, 5.0);
+			const Matrix v = testMatrix(n, k, 6.0);
+			const Matrix c = wellConditioned(k, 7.0);
+
+			Matrix inverse = a.inverse();
+			updates::woodbury(inverse, u, c, v);
+			BOOST_CHECK_MESSAGE(reductions::isApprox(inverse,
+				(a + u * c * v.transpose()).inverse(), 1e-12),
+				"testWoodbury failed!");
+		}
+	}
+
+	Matrix inverse = identity(4);
+	BOOST_CHECK_THROW(updates::woodbury(inverse, Matrix(4, 2), identity(3),
+		Matrix(4, 2)), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(testCholeskyUpdateAndDowndate)
+{
+	BOOST_TEST_MESSAGE("testCholeskyUpdateAndDowndate");
+
+	for (size_t n : {1, 5, 60})
+	{
+		const Matrix root = testMatrix(n, n, 8.0);
+		const Matrix a = root * root.transpose() + identity(n);
+		const Matrix x = testMatrix(n, 1, 9.0);
+		const Matrix updated = a + x * x.transpose();
+
+		Matrix l = cholesky(a);
+		updates::choleskyUpdate(l, x);
+		BOOST_CHECK_MESSAGE(reductions::isApprox(l, cholesky(updated), 1e-11),
+			"testCholeskyUpdateAndDowndate failed!");
+
+		updates::choleskyDowndate(l, x);
+		BOOST_CHECK_MESSAGE(reductions::isApprox(l, cholesky(a), 1e-11),
+			"testCholeskyUpdateAndDowndate failed!");
+	}
+
+	// Downdating the identity by a vector of norm 2 leaves it indefinite.
+	Matrix l = identity(3);
+	Matrix x{3, 1};
+	x(2, 1) = 2.0;
+	BOOST_CHECK_THROW(updates::choleskyDowndate(l, x), std::runtime_error);
+	BOOST_CHECK_MESSAGE(l == identity(3),
+		"testCholeskyUpdateAndDowndate failed!");
+}
+
+BOOST_AUTO_TEST_CASE(testQrAppendAndDeleteRows)
+{
+	BOOST_TEST_MESSAGE("testQrAppendAndDeleteRows");
+
+	for (size_t n : {1, 4, 12})
+	{
+		// Build a factorization one row at a time, past square.
+		const Matrix a = testMatrix(n + 3, n, 10.0);
+		Matrix q{0, 0};
+		Matrix r{0, n};
+		Matrix so_far{0, n};
+		for (size_t row = 1; row <= n + 3; ++row)
+		{
+			Matrix new_row{1, n};
+			for (size_t col = 1; col <= n; ++col) new_row(1, col) = a(row, col);
+
+			updates::qrAppendRow(q, r, new_row);
+			so_far.resize(row, n);
+			for (size_t col = 1; col <= n; ++col) so_far(row, col) = a(row, col);
+			BOOST_CHECK_MESSAGE(isQrOf(q, r, so_far),
+				"testQrAppendAndDeleteRows failed!");
+		}
+
+		// Then take rows back out, from the middle, the top, and the bottom.
+		Matrix remaining{a};
+		for (size_t pick : {2, 1, 0})
+		{
+			const size_t row = pick == 0 ? remaining.size().first : pick;
+			updates::qrDeleteRow(q, r, row);
+			remaining = withoutRow(remaining, row);
+			BOOST_CHECK_MESSAGE(isQrOf(q, r, remaining),
+				"testQrAppendAndDeleteRows failed!");
+		}
+	}
+
+	Matrix q = identity(2);
+	Matrix r{2, 2};
+	BOOST_CHECK_THROW(updates::qrDeleteRow(q, r, 3), std::runtime_error);
+	BOOST_CHECK_THROW(updates::qrDeleteRow(q, r, 0), std::runtime_error);
+	BOOST_CHECK_THROW(updates::qrAppendRow(q, r, Matrix(1, 3)),
+		std::runtime_error);
+}
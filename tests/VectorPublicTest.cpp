@@ -0,0 +1,190 @@
+#define BOOST_TEST_MODULE VectorPublicTest
+#include <boost/test/unit_test.hpp>
+
+#include "src/Array2D.hpp"
+#include "src/Matrix.hpp"
+#include "src/Parallel.hpp"
+#include "src/Reductions.hpp"
+#include "src/Vector.hpp"
+#include "tests/TestHelpers.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+
+namespace
+{
+
+Vector testVector(size_t n, double seed)
+{
+	return Vector{testMatrix(n, 1, seed)};
+}
+
+bool isAligned(const double* ptr)
+{
+	return reinterpret_cast<uintptr_t>(ptr) % Array2D::alignment == 0;
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(testIndexingAndAlignment)
+{
+	BOOST_TEST_MESSAGE("testIndexingAndAlignment");
+
+	Vector vec{5};
+	vec(5) = 2.0;
+	const Vector& view = vec;
+
+	BOOST_CHECK_MESSAGE(vec.size() == 5 and view(5) == 2.0
+		and vec.data()[4] == 2.0, "testIndexingAndAlignment failed!");
+	BOOST_CHECK_MESSAGE(isAligned(vec.data()),
+		"testIndexingAndAlignment failed!");
+	BOOST_CHECK_MESSAGE(isAligned(Array2D(3, 7).data()),
+		"testIndexingAndAlignment failed!");
+	BOOST_CHECK_THROW(vec(0), std::runtime_error);
+	BOOST_CHECK_THROW(view(6), std::runtime_error);
+	BOOST_CHECK_THROW(Vector().size(), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(testMatrixInteropIsZeroCopy)
+{
+	BOOST_TEST_MESSAGE("testMatrixInteropIsZeroCopy");
+
+	for (const Matrix& mat : {testMatrix(6, 1, 1.0), testMatrix(1, 6, 1.0)})
+	{
+		Vector vec{mat};
+		BOOST_CHECK_MESSAGE(static_cast<const Vector&>(vec).data() == mat.data()
+			and vec.size() == 6,
+			"testMatrixInteropIsZeroCopy failed!");
+
+		const Matrix column = vec.toColumn();
+		const Matrix row = vec.toRow();
+		BOOST_CHECK_MESSAGE((column.size() == std::make_pair<size_t, size_t>(6, 1)),
+			"testMatrixInteropIsZeroCopy failed!");
+		BOOST_CHECK_MESSAGE((row.size() == std::make_pair<size_t, size_t>(1, 6)),
+			"testMatrixInteropIsZeroCopy failed!");
+		BOOST_CHECK_MESSAGE(column(4, 1) == mat.data()[3]
+			and row(1, 4) == mat.data()[3], "testMatrixInteropIsZeroCopy failed!");
+	}
+
+	// A Vector made from a fresh Matrix is the only owner, so converting it
+	// back can reuse the storage even though the shape changes.
+	Vector vec{testMatrix(4, 1, 2.0)};
+	const double* storage = static_cast<const Vector&>(vec).data();
+	const Matrix row = vec.toRow();
+	BOOST_CHECK_MESSAGE(row.data() == storage,
+		"testMatrixInteropIsZeroCopy failed!");
+
+	BOOST_CHECK_THROW(Vector{Matrix(2, 2)}, std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(testSharedStorageIsCopiedOnWrite)
+{
+	BOOST_TEST_MESSAGE("testSharedStorageIsCopiedOnWrite");
+
+	Matrix mat = testMatrix(3, 1, 3.0);
+	Vector vec{mat};
+	vec(2) = 10.0;
+	BOOST_CHECK_MESSAGE(mat(2, 1) != 10.0 and vec(2) == 10.0,
+		"testSharedStorageIsCopiedOnWrite failed!");
+
+	Matrix column = vec.toColumn();
+	column(1, 1) = -1.0;
+	BOOST_CHECK_MESSAGE(vec(1) != -1.0 and column(2, 1) == 10.0,
+		"testSharedStorageIsCopiedOnWrite failed!");
+
+	Vector copy{vec};
+	copy(3) = 7.0;
+	BOOST_CHECK_MESSAGE(vec(3) != 7.0, "testSharedStorageIsCopiedOnWrite failed!");
+}
+
+BOOST_AUTO_TEST_CASE(testLevelOneOperations)
+{
+	BOOST_TEST_MESSAGE("testLevelOneOperations");
+
+	for (size_t n : {1, 7, 1000})
+	{
+		Vector x = testVector(n, 4.0);
+		Vector y = testVector(n, 5.0);
+		const Matrix x_mat = x.toColumn();
+		const Matrix y_mat = y.toColumn();
+
+		BOOST_CHECK_MESSAGE(reductions::isApprox((x + y).toColumn(),
+			x_mat + y_mat, 1e-15), "testLevelOneOperations failed!");
+		BOOST_CHECK_MESSAGE(reductions::isApprox((x - y).toColumn(),
+			x_mat - y_mat, 1e-15), "testLevelOneOperations failed!");
+		BOOST_CHECK_MESSAGE(reductions::isApprox((2.0 * x).toColumn(),
+			x_mat + x_mat, 1e-15), "testLevelOneOperations failed!");
+
+		Vector z{y};
+		z.axpy(3.0, x);
+		BOOST_CHECK_MESSAGE(reductions::isApprox(z.toColumn(),
+			y_mat + x_mat + x_mat + x_mat, 1e-14),
+			"testLevelOneOperations failed!");
+		z *= 0.5;
+		BOOST_CHECK_MESSAGE(reductions::isApprox(z.toColumn(),
+			(y_mat + x_mat + x_mat + x_mat) / 2.0, 1e-14),
+			"testLevelOneOperations failed!");
+
+		const double dot = (x_mat.transpose() * y_mat)(1, 1);
+		BOOST_CHECK_MESSAGE(std::abs(x.dot(y) - dot) <= 1e-12 * n,
+			"testLevelOneOperations failed!");
+		BOOST_CHECK_MESSAGE(std::abs(x.norm() - std::sqrt(x.dot(x))) <= 1e-15 * n,
+			"testLevelOneOperations failed!");
+	}
+
+	BOOST_CHECK_THROW(Vector(3).dot(Vector(4)), std::runtime_error);
+	BOOST_CHECK_THROW(Vector(3).axpy(1.0, Vector(4)), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(testMatrixVectorProducts)
+{
+	BOOST_TEST_MESSAGE("testMatrixVectorProducts");
+
+	for (size_t threads : {1, 3})
+	{
+		parallel::setNumThreads(threads);
+
+		// Big enough for the threaded path, and with ragged edges.
+		const size_t shapes[][2] = {{1, 1}, {5, 9}, {301, 257}, {13, 7001}};
+		for (const auto& shape : shapes)
+		{
+			const size_t m = shape[0];
+			const size_t n = shape[1];
+			const Matrix a = testMatrix(m, n, 6.0);
+			Vector x = testVector(n, 7.0);
+			Vector x_t = testVector(m, 8.0);
+			const Matrix expected = a * x.toColumn();
+			const Matrix expected_t = a.transpose() * x_t.toColumn();
+
+			// The loop order of the kernels depends on the storage layout, and
+			// so does the order in which each element is summed.
+			for (Layout layout : {Layout::RowMajor, Layout::ColumnMajor})
+			{
+				const double tolerance = layout == Layout::RowMajor
+					? 1e-12 : 1e-13 * std::max(m, n);
+				const Matrix stored = a.toLayout(layout);
+				BOOST_CHECK_MESSAGE(reductions::isApprox((stored * x).toColumn(),
+					expected, tolerance), "testMatrixVectorProducts failed!");
+				BOOST_CHECK_MESSAGE(reductions::isApprox(
+					transposeMultiply(stored, x_t).toColumn(), expected_t,
+					tolerance), "testMatrixVectorProducts failed!");
+
+				Vector y = testVector(m, 9.0);
+				const Matrix expected_y = y.toColumn() - expected;
+				gemv(-1.0, stored, x, y);
+				BOOST_CHECK_MESSAGE(reductions::isApprox(y.toColumn(),
+					expected_y, tolerance), "testMatrixVectorProducts failed!");
+			}
+		}
+	}
+	parallel::setNumThreads(0);
+
+	BOOST_CHECK_THROW(Matrix(3, 4) * Vector(3), std::runtime_error);
+	BOOST_CHECK_THROW(transposeMultiply(Matrix(3, 4), Vector(4)),
+		std::runtime_error);
+	Vector y{4};
+	BOOST_CHECK_THROW(gemv(1.0, Matrix(3, 4), Vector(4), y),
+		std::runtime_error);
+}